@@ -14,6 +14,7 @@
  ******************************************************************************
  */
 #include "QuaternionEKF.h"
+#include "profiler.h"
 #include "math.h"
 QEKF_INS_t QEKF_INS={0};
 
@@ -220,7 +221,9 @@ void IMU_QuaternionEKF_Update(float gx, float gy, float gz, float ax, float ay,
     QEKF_INS.IMU_QuaternionEKF.R_data[8] = QEKF_INS.R;
 
     // 调用kalman_filter.c封装好的函数,注意几个User_Funcx_f的调用
+    uint32 prof_start = prof_begin();
     Kalman_Filter_Update(&QEKF_INS.IMU_QuaternionEKF);
+    prof_end(PROF_KALMAN, prof_start);
 
     // 获取融合后的数据,包括四元数和xy零飘值
     QEKF_INS.q[0] = QEKF_INS.IMU_QuaternionEKF.FilteredValue[0];
@@ -3,10 +3,210 @@
 
 
 
-uint8 binaryImage[IMAGE_HEIGHT][IMAGE_WIDTH];      // 最终输出结果的数组
+#if !IMAGE_PACKED_BINARY
+uint8 binaryImage[IMAGE_HEIGHT][IMAGE_WIDTH];      // 最终输出结果的数组（按位压缩模式下不分配）
+#endif
 uint8 boundary_image[IMAGE_HEIGHT][IMAGE_WIDTH];   // 边界图像
 uint8 centerline_image[IMAGE_HEIGHT][IMAGE_WIDTH]; // 中心线图像
 int center_points[IMAGE_HEIGHT];                   // 存储每行的中心点坐标
+uint32 binaryPacked[IMAGE_HEIGHT][BINARY_PACKED_WORDS]; // 按位压缩的二值图
+
+static uint16 adaptive_column_sum[IMAGE_WIDTH];      // 当前窗口行范围内各列的灰度和（最多15行，不超过16位）
+static uint32 adaptive_row_prefix[IMAGE_WIDTH + 1];  // 列和的前缀和，adaptive_row_prefix[j]为第0~j-1列之和
+
+/**
+ * @brief  图像复制并同步统计灰度直方图（融合流水线第一遍）
+ * @param  *src 源图像指针（摄像头DMA缓冲区，需4字节对齐）
+ * @param  *dst 目标图像指针（需4字节对齐），为NULL时只统计直方图不复制
+ * @param  *hist 输出灰度直方图（256项，隔行隔列采样，与otsu_get_threshold一致）
+ * @retval 采样像素的灰度总和
+ * @note   按32位字搬运，偶数行顺带统计第0、2字节（偶数列），省掉大津法单独遍历一次图像
+ */
+uint32 image_copy_histogram(const uint8 *src, uint8 *dst, uint16 *hist)
+{
+    const uint32 *s = (const uint32 *)src;
+    uint32 *d = (uint32 *)dst;
+    uint32 gray_sum = 0;
+    int i, j;
+
+    memset(hist, 0, GRAY_LEVELS * sizeof(uint16));
+
+    for (i = 0; i < IMAGE_HEIGHT; i++)
+    {
+        if ((i & 1) == 0)
+        {
+            for (j = 0; j < IMAGE_WIDTH / 4; j++)
+            {
+                uint32 word = s[j];
+                uint8 p0 = (uint8)word;         // 第4j列（小端）
+                uint8 p2 = (uint8)(word >> 16); // 第4j+2列
+                hist[p0]++;
+                hist[p2]++;
+                gray_sum += p0 + p2;
+                if (d != NULL)
+                {
+                    d[j] = word;
+                }
+            }
+        }
+        else if (d != NULL)
+        {
+            for (j = 0; j < IMAGE_WIDTH / 4; j++)
+            {
+                d[j] = s[j];
+            }
+        }
+        s += IMAGE_WIDTH / 4;
+        if (d != NULL)
+        {
+            d += IMAGE_WIDTH / 4;
+        }
+    }
+    return gray_sum;
+}
+
+/**
+ * @brief  计算某个分割点的类间方差（整数精确表示）
+ * @param  wB 背景像素数
+ * @param  sumB 背景灰度和
+ * @param  pixel_sum 像素总数
+ * @param  gray_sum 灰度总和
+ * @param  *frac 输出方差小数部分的分子（分母为wB*wF）
+ * @retval 方差整数部分
+ * @note   类间方差 ∝ num^2 / (wB*wF)，num = N*sumB - sum*wB，|num| = wB*wF*|mB-mF|
+ *         num^2可达66位，先做带余除法 num = q*den + r，
+ *         则 num^2/den = q*num + (r*num)/den，中间量均不超过64位
+ */
+static uint64 otsu_between_variance(uint32 wB, uint32 sumB, uint32 pixel_sum, uint32 gray_sum, uint64 *frac)
+{
+    uint32 wF = pixel_sum - wB;
+    int64 diff = (int64)pixel_sum * sumB - (int64)gray_sum * wB;
+    uint64 num = (uint64)(diff < 0 ? -diff : diff);
+    uint64 den = (uint64)wB * wF;
+    uint64 q = num / den;
+    uint64 r = num % den;
+    uint64 rn = r * num;
+
+    *frac = rn % den;
+    return q * num + rn / den;
+}
+
+/**
+ * @brief  比较两个类间方差的大小（精确比较，无浮点误差）
+ * @retval a > b 时返回1
+ */
+static uint8 otsu_variance_greater(uint64 int_a, uint64 frac_a, uint64 den_a,
+                                   uint64 int_b, uint64 frac_b, uint64 den_b)
+{
+    if (int_a != int_b)
+    {
+        return int_a > int_b;
+    }
+    // 整数部分相同，比较小数部分 frac_a/den_a 与 frac_b/den_b（交叉相乘不超过64位）
+    return frac_a * den_b > frac_b * den_a;
+}
+
+/**
+ * @brief  根据灰度直方图计算大津法阈值（纯整数，精确全局最大）
+ * @param  *hist 灰度直方图（256项）
+ * @param  pixel_sum 直方图像素总数
+ * @param  gray_sum 直方图像素灰度总和
+ * @retval 阈值（灰度<=阈值为背景），多个分割点方差相同时取最小的
+ * @note   用累积像素数和累积灰度和逐级更新，不做浮点运算，也不会在方差
+ *         第一次下降时提前退出。直方图为空的灰度级不改变分割结果，直接跳过。
+ *         OTSU_COARSE_STEP > 1 时先按步长粗搜再在最优点附近细搜，速度更快，
+ *         但类间方差曲线有多个峰时可能错过全局最大值；所有像素落在同一个步长内
+ *         （饱和帧、相邻灰度的窄双峰）时粗搜点都无法分割，改为逐级搜索全部灰度
+ */
+int otsu_threshold_from_histogram(const uint16 *hist, uint32 pixel_sum, uint32 gray_sum)
+{
+    uint32 wB = 0, sumB = 0;
+    uint64 best_int = 0, best_frac = 0, best_den = 1;
+    int threshold = 0;
+    int j;
+
+#if OTSU_COARSE_STEP > 1
+    uint32 cum_w[GRAY_LEVELS];  // 累积像素数
+    uint32 cum_s[GRAY_LEVELS];  // 累积灰度和
+    uint8 coarse_found = 0;     // 粗搜找到了可分割的点
+    int lo, hi;
+
+    for (j = 0; j < GRAY_LEVELS; j++)
+    {
+        wB += hist[j];
+        sumB += (uint32)j * hist[j];
+        cum_w[j] = wB;
+        cum_s[j] = sumB;
+    }
+
+    // 粗搜
+    for (j = OTSU_COARSE_STEP - 1; j < GRAY_LEVELS; j += OTSU_COARSE_STEP)
+    {
+        if (cum_w[j] == 0 || cum_w[j] == pixel_sum)
+            continue;
+        uint64 v_frac;
+        uint64 v_int = otsu_between_variance(cum_w[j], cum_s[j], pixel_sum, gray_sum, &v_frac);
+        uint64 v_den = (uint64)cum_w[j] * (pixel_sum - cum_w[j]);
+        if (otsu_variance_greater(v_int, v_frac, v_den, best_int, best_frac, best_den))
+        {
+            best_int = v_int;
+            best_frac = v_frac;
+            best_den = v_den;
+            threshold = j;
+            coarse_found = 1;
+        }
+    }
+
+    // 细搜（粗搜最优点两侧各一个步长；粗搜没有可分割的点时搜索全部灰度，与逐级精确搜索结果相同）
+    lo = coarse_found ? threshold - OTSU_COARSE_STEP + 1 : 0;
+    hi = coarse_found ? threshold + OTSU_COARSE_STEP - 1 : GRAY_LEVELS - 1;
+    if (lo < 0)
+        lo = 0;
+    if (hi > GRAY_LEVELS - 1)
+        hi = GRAY_LEVELS - 1;
+    best_int = 0;
+    best_frac = 0;
+    best_den = 1;
+    for (j = lo; j <= hi; j++)
+    {
+        if (cum_w[j] == 0 || cum_w[j] == pixel_sum)
+            continue;
+        if (j > lo && cum_w[j] == cum_w[j - 1])
+            continue;
+        uint64 v_frac;
+        uint64 v_int = otsu_between_variance(cum_w[j], cum_s[j], pixel_sum, gray_sum, &v_frac);
+        uint64 v_den = (uint64)cum_w[j] * (pixel_sum - cum_w[j]);
+        if (otsu_variance_greater(v_int, v_frac, v_den, best_int, best_frac, best_den))
+        {
+            best_int = v_int;
+            best_frac = v_frac;
+            best_den = v_den;
+            threshold = j;
+        }
+    }
+#else
+    for (j = 0; j < GRAY_LEVELS - 1; j++)
+    {
+        if (hist[j] == 0)
+            continue; // 分割结果与上一灰度级相同
+        wB += hist[j];
+        sumB += (uint32)j * hist[j];
+        if (wB == pixel_sum)
+            break; // 前景为空，后续灰度级都没有像素
+        uint64 v_frac;
+        uint64 v_int = otsu_between_variance(wB, sumB, pixel_sum, gray_sum, &v_frac);
+        uint64 v_den = (uint64)wB * (pixel_sum - wB);
+        if (otsu_variance_greater(v_int, v_frac, v_den, best_int, best_frac, best_den))
+        {
+            best_int = v_int;
+            best_frac = v_frac;
+            best_den = v_den;
+            threshold = j;
+        }
+    }
+#endif
+    return threshold;
+}
 
 /**
  * @brief  otsu算法获取阈值
@@ -17,19 +217,15 @@ int center_points[IMAGE_HEIGHT];                   // 存储每行的中心点
  */
 int otsu_get_threshold(uint8* image, uint16 col, uint16 row)
 {
-#define GrayScale 256
     uint16 width = col;
     uint16 height = row;
-    int pixelCount[GrayScale];
-    float pixelPro[GrayScale];
+    uint16 pixelCount[GRAY_LEVELS];
     int i, j;
-    int pixelSum = width * height / 4;
-    int threshold = 0;
+    uint32 pixelSum = width * height / 4;
     uint8 *data = image;
-    for (i = 0; i < GrayScale; i++)
+    for (i = 0; i < GRAY_LEVELS; i++)
     {
         pixelCount[i] = 0;
-        pixelPro[i] = 0;
     }
     uint32 gray_sum = 0;
     // 统计灰度级中每个像素在整幅图像中的个数
@@ -41,38 +237,38 @@ int otsu_get_threshold(uint8* image, uint16 col, uint16 row)
             gray_sum += (int)data[i * width + j];   // 灰度值总和
         }
     }
-    // 计算每个像素值的点在整幅图像中的比例
-    for (i = 0; i < GrayScale; i++)
-    {
-        pixelPro[i] = (float)pixelCount[i] / pixelSum;
-    }
-    // 遍历灰度级[0,255]
-    float w0, w1, u0tmp, u1tmp, u0, u1, u, deltaTmp, deltaMax = 0;
-    w0 = w1 = u0tmp = u1tmp = u0 = u1 = u = deltaTmp = 0;
-    for (j = 0; j < GrayScale; j++)
-    {
-        w0 += pixelPro[j];        // 背景部分每个灰度值的像素点所占比例之和   即背景部分的比例
-        u0tmp += j * pixelPro[j]; // 背景部分 每个灰度值的点的比例 *灰度值
-        w1 = 1 - w0;
-        u1tmp = gray_sum / pixelSum - u0tmp;
-        u0 = u0tmp / w0;   // 背景平均灰度
-        u1 = u1tmp / w1;   // 前景平均灰度
-        u = u0tmp + u1tmp; // 全局平均灰度
-        deltaTmp = w0 * pow((u0 - u), 2) + w1 * pow((u1 - u), 2);
-        if (deltaTmp > deltaMax)
-        {
-            deltaMax = deltaTmp;
-            threshold = j;
-        }
-        if (deltaTmp < deltaMax)
+    return otsu_threshold_from_histogram(pixelCount, pixelSum, gray_sum);
+}
+
+
+//  单行应用阈值（按需二值化时逐行调用）
+//--------------------------------------------------------------
+void applyThresholdRow(const uint8 *input, uint8 *output, int threshold)
+{
+    for (int j = 0; j < IMAGE_WIDTH; j++)
+    {
+        // 使用条件表达式优化二值化
+        output[j] = (input[j] > threshold) ? 255 : 0;
+    }
+}
+
+//  单行应用阈值，生成按位压缩的一行（1=白，0=黑）
+//--------------------------------------------------------------
+void applyThresholdPackedRow(const uint8 *input, uint32 *output, int threshold)
+{
+    for (int w = 0; w < BINARY_PACKED_WORDS; w++)
+    {
+        int n = (w == BINARY_PACKED_WORDS - 1) ? IMAGE_WIDTH - w * 32 : 32;
+        uint32 bits = 0;
+        for (int k = 0; k < n; k++)
         {
-            break;
+            bits = (bits << 1) | (input[k] > threshold);
         }
+        output[w] = bits << (32 - n);
+        input += n;
     }
-    return threshold;
 }
 
-
 //  应用阈值函数，生成二值化图像
 //--------------------------------------------------------------
 void applyThreshold(uint8 input[][IMAGE_WIDTH],
@@ -81,14 +277,155 @@ void applyThreshold(uint8 input[][IMAGE_WIDTH],
 {
     for (int i = 0; i < IMAGE_HEIGHT; i++)
     {
+        applyThresholdRow(input[i], output[i], threshold);
+    }
+}
+
+//  应用阈值函数，生成按位压缩的二值化图像（1=白，0=黑）
+//--------------------------------------------------------------
+void applyThresholdPacked(uint8 input[][IMAGE_WIDTH],
+                          uint32 output[][BINARY_PACKED_WORDS],
+                          int threshold)
+{
+    for (int i = 0; i < IMAGE_HEIGHT; i++)
+    {
+        applyThresholdPackedRow(input[i], output[i], threshold);
+    }
+}
+
+/**
+ * @brief  自适应阈值：滚动更新窗口列和并求本行前缀和
+ * @param  input 灰度图像
+ * @param  i 当前行
+ * @retval 窗口行数（上下边界处小于2R+1）
+ */
+static uint32 adaptive_prepare_row(uint8 input[][IMAGE_WIDTH], int i)
+{
+    int add = i + ADAPTIVE_RADIUS;
+    int sub = i - ADAPTIVE_RADIUS - 1;
+    int top = (i > ADAPTIVE_RADIUS) ? i - ADAPTIVE_RADIUS : 0;
+    int bottom = (add < IMAGE_HEIGHT) ? add : IMAGE_HEIGHT - 1;
+    int r, j;
+
+    if (i == 0)
+    {
+        memset(adaptive_column_sum, 0, sizeof(adaptive_column_sum));
+        for (r = 0; r < ADAPTIVE_RADIUS && r < IMAGE_HEIGHT; r++)
+        {
+            for (j = 0; j < IMAGE_WIDTH; j++)
+                adaptive_column_sum[j] += input[r][j];
+        }
+    }
+    if (add < IMAGE_HEIGHT)
+    {
+        for (j = 0; j < IMAGE_WIDTH; j++)
+            adaptive_column_sum[j] += input[add][j];
+    }
+    if (sub >= 0)
+    {
+        for (j = 0; j < IMAGE_WIDTH; j++)
+            adaptive_column_sum[j] -= input[sub][j];
+    }
+
+    adaptive_row_prefix[0] = 0;
+    for (j = 0; j < IMAGE_WIDTH; j++)
+        adaptive_row_prefix[j + 1] = adaptive_row_prefix[j] + adaptive_column_sum[j];
+
+    return (uint32)(bottom - top + 1);
+}
+
+/**
+ * @brief  自适应阈值单个像素判定
+ * @param  pixel 像素灰度
+ * @param  j 列号
+ * @param  rows 窗口行数
+ * @param  lo 局部阈值下限（全局阈值-裕量）
+ * @param  hi 局部阈值上限（全局阈值+裕量）
+ * @param  offset 偏移量
+ * @retval 1=白，0=黑
+ * @note   局部阈值 = clamp(窗口均值 - offset, lo, hi)；不超出限幅时
+ *         pixel > 均值 - offset 等价于 (pixel + offset) * 面积 > 窗口和，不做除法
+ */
+static inline uint32 adaptive_pixel(uint8 pixel, int j, uint32 rows, int lo, int hi, int offset)
+{
+    int left, right;
+    uint32 sum;
+
+    if (pixel > hi)
+        return 1;
+    if (pixel <= lo)
+        return 0;
+    left = (j > ADAPTIVE_RADIUS) ? j - ADAPTIVE_RADIUS : 0;
+    right = (j + ADAPTIVE_RADIUS < IMAGE_WIDTH) ? j + ADAPTIVE_RADIUS : IMAGE_WIDTH - 1;
+    sum = adaptive_row_prefix[right + 1] - adaptive_row_prefix[left];
+    return (uint32)(pixel + offset) * rows * (uint32)(right - left + 1) > sum;
+}
+
+//  自适应阈值二值化（255=白，0=黑）
+//--------------------------------------------------------------
+void applyAdaptiveThreshold(uint8 input[][IMAGE_WIDTH],
+                            uint8 output[][IMAGE_WIDTH],
+                            int threshold, int offset, int margin)
+{
+    int lo = threshold - margin;
+    int hi = threshold + margin;
+
+    for (int i = 0; i < IMAGE_HEIGHT; i++)
+    {
+        uint32 rows = adaptive_prepare_row(input, i);
         for (int j = 0; j < IMAGE_WIDTH; j++)
         {
-            // 使用条件表达式优化二值化
-            output[i][j] = (input[i][j] > threshold) ? 255 : 0;
+            output[i][j] = adaptive_pixel(input[i][j], j, rows, lo, hi, offset) ? 255 : 0;
+        }
+    }
+}
+
+//  自适应阈值二值化，生成按位压缩的二值化图像（1=白，0=黑）
+//--------------------------------------------------------------
+void applyAdaptiveThresholdPacked(uint8 input[][IMAGE_WIDTH],
+                                  uint32 output[][BINARY_PACKED_WORDS],
+                                  int threshold, int offset, int margin)
+{
+    int lo = threshold - margin;
+    int hi = threshold + margin;
+
+    for (int i = 0; i < IMAGE_HEIGHT; i++)
+    {
+        uint32 rows = adaptive_prepare_row(input, i);
+        for (int w = 0; w < BINARY_PACKED_WORDS; w++)
+        {
+            int n = (w == BINARY_PACKED_WORDS - 1) ? IMAGE_WIDTH - w * 32 : 32;
+            uint32 bits = 0;
+            for (int k = 0; k < n; k++)
+            {
+                int j = w * 32 + k;
+                bits = (bits << 1) | adaptive_pixel(input[i][j], j, rows, lo, hi, offset);
+            }
+            output[i][w] = bits << (32 - n);
         }
     }
 }
 
+/**
+ * @brief  获取压缩二值图某个字内列范围[start, end]对应的位掩码
+ * @param  word 字序号（0 ~ BINARY_PACKED_WORDS-1）
+ * @param  start 起始列（含）
+ * @param  end 结束列（含）
+ * @retval 位掩码，范围与该字无交集时返回0
+ */
+uint32 packed_range_mask(int word, int start, int end)
+{
+    int lo = start - word * 32;
+    int hi = end - word * 32;
+    if (lo < 0)
+        lo = 0;
+    if (hi > 31)
+        hi = 31;
+    if (lo > hi)
+        return 0;
+    return (0xFFFFFFFFu >> lo) & (0xFFFFFFFFu << (31 - hi));
+}
+
 // // 大津法（返回阈值）
 // //--------------------------------------------------------------
 // int otsuThreshold(uint8 image[][IMAGE_WIDTH])
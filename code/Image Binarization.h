@@ -7,15 +7,74 @@
 #define IMAGE_HEIGHT MT9V03X_H
 #define IMAGE_WIDTH MT9V03X_W
 
-extern uint8 binaryImage[IMAGE_HEIGHT][IMAGE_WIDTH];      // 最终输出结果的数组
+#define GRAY_LEVELS 256                      // 灰度级数
+#define OTSU_SAMPLE_COUNT (IMAGE_HEIGHT * IMAGE_WIDTH / 4) // 大津法隔行隔列采样像素数
+#ifndef OTSU_COARSE_STEP
+#define OTSU_COARSE_STEP 1                   // 大津法粗搜步长（1=逐级精确搜索，>1=先粗后细）
+#endif
+
+// 自适应阈值：以像素为中心的(2R+1)x(2R+1)窗口均值减偏移量作为局部阈值，并限制在大津法全局阈值±裕量内
+// （大片均匀的白色赛道或黑色背景局部均值无意义，由全局阈值兜底）
+// 窗口和由滚动的列和加每行前缀和求得（积分图的逐行形式，只需一行列和与一行前缀和），每像素O(1)
+#define ADAPTIVE_RADIUS 7                    // 窗口半径R（窗口15x15）
+
+// 按位压缩的二值图：每行188位存入6个32位字，第j列位于第j/32个字的第(31 - j%32)位（高位在左）
+// 1=白，0=黑，每行最后一个字低4位补0
+#define BINARY_PACKED_WORDS ((IMAGE_WIDTH + 31) / 32)
+#define PACKED_COLUMN_BIT(j) (0x80000000u >> ((j) & 31))
+
+// 位运算工具：TriCore上映射为CLZ/POPCNT单指令，主机编译时使用通用实现
+#if defined(__TASKING__) || defined(__TRICORE__) || defined(__ghs__) || defined(__DCC__)
+#define bit_clz32(x) ((uint32)__clz((sint32)(x)))
+#define bit_popcount32(x) ((uint32)__popcnt((sint32)(x)))
+#else
+static inline uint32 bit_clz32(uint32 x)
+{
+    uint32 n = 0;
+    if (x == 0)
+        return 32;
+    while ((x & 0x80000000u) == 0)
+    {
+        x <<= 1;
+        n++;
+    }
+    return n;
+}
+static inline uint32 bit_popcount32(uint32 x)
+{
+    x = x - ((x >> 1) & 0x55555555u);
+    x = (x & 0x33333333u) + ((x >> 2) & 0x33333333u);
+    x = (x + (x >> 4)) & 0x0F0F0F0Fu;
+    return (x * 0x01010101u) >> 24;
+}
+#endif
+
+extern uint8 binaryImage[IMAGE_HEIGHT][IMAGE_WIDTH];      // 最终输出结果的数组（IMAGE_PACKED_BINARY为1时不定义，见image.h）
 extern uint8 boundary_image[IMAGE_HEIGHT][IMAGE_WIDTH];   // 边界图像
 extern uint8 centerline_image[IMAGE_HEIGHT][IMAGE_WIDTH]; // 中心线图像
 extern int center_points[IMAGE_HEIGHT];                   // 存储每行的中心点坐标
+extern uint32 binaryPacked[IMAGE_HEIGHT][BINARY_PACKED_WORDS]; // 按位压缩的二值图（约2.8KB）
 
 int otsu_get_threshold(uint8 *image, uint16 col, uint16 row);
 
+uint32 image_copy_histogram(const uint8 *src, uint8 *dst, uint16 *hist);
+
+int otsu_threshold_from_histogram(const uint16 *hist, uint32 pixel_sum, uint32 gray_sum);
+
+void applyThresholdRow(const uint8 *input, uint8 *output, int threshold);
+
+void applyThresholdPackedRow(const uint8 *input, uint32 *output, int threshold);
+
 void applyThreshold(uint8 input[][IMAGE_WIDTH], uint8 output[][IMAGE_WIDTH], int threshold);
 
+void applyThresholdPacked(uint8 input[][IMAGE_WIDTH], uint32 output[][BINARY_PACKED_WORDS], int threshold);
+
+void applyAdaptiveThreshold(uint8 input[][IMAGE_WIDTH], uint8 output[][IMAGE_WIDTH], int threshold, int offset, int margin);
+
+void applyAdaptiveThresholdPacked(uint8 input[][IMAGE_WIDTH], uint32 output[][BINARY_PACKED_WORDS], int threshold, int offset, int margin);
+
+uint32 packed_range_mask(int word, int start, int end);
+
 void image_output();
 
 #endif
@@ -0,0 +1,88 @@
+/*********************************************************************
+ * 文件: auto_exposure.c
+ * 直方图自动曝光实现文件
+ * 说明：平均灰度偏离目标超过死区时按 目标/当前 比例调节曝光时间，单次调节量限幅；
+ *       过曝像素过多且亮度不低于目标时只减小曝光，避免反光区域把阈值拉高
+ ********************************************************************/
+
+#include "auto_exposure.h"
+#include "zf_common_headfile.h"
+
+//============================================================
+// 全局变量定义
+//============================================================
+
+uint32 ae_enable = 0;    // 自动曝光开关
+uint32 ae_target = 110;  // 目标平均灰度
+uint32 ae_deadband = 10; // 平均灰度死区
+uint32 ae_mean = 0;      // 本帧平均灰度
+
+static uint8 ae_frames = AE_UPDATE_FRAMES; // 距上次调节的帧数
+
+//============================================================
+// 函数实现
+//============================================================
+
+/**
+ * @brief 自动曝光更新
+ */
+void auto_exposure_update(const uint16 *hist, uint32 pixel_count)
+{
+    uint32 gray_sum = 0;
+    uint32 saturated = 0;
+    uint32 exposure, step;
+    int32 target_exposure;
+    int32 error;
+    uint16 i;
+
+    // 1. 平均灰度与过曝像素数（直方图已由大津法统计，这里只遍历256级）
+    for (i = 0; i < GRAY_LEVELS; i++)
+    {
+        gray_sum += (uint32)i * hist[i];
+        if (i >= AE_SATURATE_LEVEL)
+            saturated += hist[i];
+    }
+    ae_mean = gray_sum / pixel_count;
+
+    if (!ae_enable)
+        return;
+
+    // 2. 限速：上一条命令未应答或距上次调节帧数不足时不调节
+    if (ae_frames < AE_UPDATE_FRAMES)
+        ae_frames++;
+    if (mt9v03x_exposure_poll() || ae_frames < AE_UPDATE_FRAMES)
+        return;
+
+    // 3. 计算新曝光时间
+    exposure = mt9v03x_exposure_time;
+    error = (int32)ae_mean - (int32)ae_target;
+    if (saturated > (pixel_count >> AE_SATURATE_SHIFT) && error >= -(int32)ae_deadband)
+    {
+        target_exposure = (int32)(exposure - (exposure >> AE_STEP_SHIFT));
+    }
+    else if (error <= (int32)ae_deadband && error >= -(int32)ae_deadband)
+    {
+        return;
+    }
+    else
+    {
+        target_exposure = (int32)(exposure * ae_target / (ae_mean > 0 ? ae_mean : 1));
+    }
+
+    // 4. 单次调节量限幅与范围限幅
+    step = (exposure >> AE_STEP_SHIFT) > 0 ? (exposure >> AE_STEP_SHIFT) : 1;
+    if (target_exposure > (int32)(exposure + step))
+        target_exposure = (int32)(exposure + step);
+    if (target_exposure < (int32)exposure - (int32)step)
+        target_exposure = (int32)exposure - (int32)step;
+    if (target_exposure > AE_EXPOSURE_MAX)
+        target_exposure = AE_EXPOSURE_MAX;
+    if (target_exposure < AE_EXPOSURE_MIN)
+        target_exposure = AE_EXPOSURE_MIN;
+    if (target_exposure == (int32)exposure)
+        return;
+
+    // 5. 异步发送，应答在之后的帧中查询
+    if (mt9v03x_set_exposure_time_async((uint16)target_exposure) == 0)
+        ae_frames = 0;
+}
@@ -0,0 +1,48 @@
+/*********************************************************************
+ * 文件: auto_exposure.h
+ * 直方图自动曝光头文件
+ * 说明：复用大津法已统计的灰度直方图求平均灰度和过曝像素比例，按比例调节曝光时间，
+ *       使画面亮度稳定在目标区间内，全局阈值二值化更可靠
+ *       曝光命令经摄像头配置串口异步发送（mt9v03x_set_exposure_time_async），
+ *       上一条命令应答前不发新命令，且两次调节之间至少间隔AE_UPDATE_FRAMES帧，不阻塞图像处理
+ ********************************************************************/
+
+#ifndef _AUTO_EXPOSURE_H
+#define _AUTO_EXPOSURE_H
+
+#include "zf_common_typedef.h"
+#include "zf_common_headfile.h"
+
+//============================================================
+// 宏定义
+//============================================================
+
+#define AE_EXPOSURE_MIN 30          // 曝光时间下限
+#define AE_EXPOSURE_MAX 1000        // 曝光时间上限（摄像头还会按帧率限幅，以应答值为准）
+#define AE_UPDATE_FRAMES 4          // 两次调节的最小间隔帧数（新曝光约1~2帧后生效，间隔过短会振荡）
+#define AE_STEP_SHIFT 2             // 单次调节量不超过当前曝光的1/4
+#define AE_SATURATE_LEVEL 250       // 不低于该灰度的像素视为过曝
+#define AE_SATURATE_SHIFT 5         // 过曝像素超过采样数的1/32时按过曝处理（只减不加）
+
+//============================================================
+// 全局变量声明
+//============================================================
+
+extern uint32 ae_enable;   // 自动曝光开关（0/1），菜单可调
+extern uint32 ae_target;   // 目标平均灰度，菜单可调
+extern uint32 ae_deadband; // 平均灰度死区，菜单可调
+extern uint32 ae_mean;     // 本帧平均灰度（显示用）
+
+//============================================================
+// 函数声明
+//============================================================
+
+/**
+ * @brief 自动曝光更新
+ * @param hist 本帧灰度直方图（大津法采样）
+ * @param pixel_count 直方图采样像素数
+ * @note 每帧图像处理后调用，只做一次直方图遍历和一次非阻塞的应答查询
+ */
+void auto_exposure_update(const uint16 *hist, uint32 pixel_count);
+
+#endif
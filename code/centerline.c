@@ -0,0 +1,186 @@
+/*********************************************************************
+ * 文件: centerline.c
+ * 中线最小二乘拟合实现文件
+ * 说明：纵坐标y为每行地面前向距离（cm，减去CENTERLINE_Y_REF_CM），横坐标x为中线横向距离（mm）
+ *       逐行累加 Σy^k (k=0..4) 与 Σx*y^k (k=0..2)，全部为整数运算；
+ *       所有行累加完成后把各阶矩平移到纵坐标均值处（二项式展开，整数精确计算），
+ *       再用int64求法方程的代数余子式和行列式，只有最后的乘加与除法为浮点：
+ *       原始矩Σy^4可达6e9，直接用float做克莱姆法则时二阶子式相减严重抵消（误差可达数mm），
+ *       平移后各阶矩小一到两个数量级，代数余子式在int64内精确，拟合曲线误差在0.01mm以内
+ ********************************************************************/
+
+#include "centerline.h"
+#include "image.h"
+#include "ipm.h"
+#include "zf_common_headfile.h"
+#include <math.h>
+
+//============================================================
+// 全局变量定义
+//============================================================
+
+Centerline_Model centerline = {0};       // 本帧中线模型
+float centerline_lookahead_base = 400.0f; // 前瞻距离基础值（mm）
+float centerline_lookahead_gain = 2.0f;   // 前瞻距离速度系数（mm/编码器计数）
+
+extern int Left_Lost_Flag[MT9V03X_H];    // 左边界丢失标志（定义在image.c中）
+extern int Right_Lost_Flag[MT9V03X_H];   // 右边界丢失标志（定义在image.c中）
+
+static int16 centerline_row_y[MT9V03X_H]; // 每行纵坐标（cm，已减去CENTERLINE_Y_REF_CM）
+static uint8 centerline_row_ok[MT9V03X_H]; // 该行在地平线以下，可参与拟合
+
+// 法方程累加量（定点）
+typedef struct
+{
+    int32 s0, s1, s2, s3; // Σy^k
+    int64 s4;             // Σy^4
+    int32 t0, t1;         // Σx, Σx*y
+    int64 t2;             // Σx*y^2
+} Centerline_Sums;
+
+//============================================================
+// 函数实现
+//============================================================
+
+/**
+ * @brief 生成每行的定点纵坐标
+ */
+void centerline_init(void)
+{
+    int i;
+
+    for (i = 0; i <= MT9V03X_H - 1; i++)
+    {
+        centerline_row_ok[i] = (ipm_row_forward[i] > 0);
+        centerline_row_y[i] = (int16)(ipm_row_forward[i] / 10.0f + 0.5f) - CENTERLINE_Y_REF_CM;
+    }
+}
+
+/**
+ * @brief 累加一行数据
+ * @param sums 累加量
+ * @param y 纵坐标（cm）
+ * @param x 横坐标（mm）
+ */
+static inline void centerline_add_row(Centerline_Sums *sums, int32 y, int32 x)
+{
+    int32 y2 = y * y;
+
+    sums->s0 += 1;
+    sums->s1 += y;
+    sums->s2 += y2;
+    sums->s3 += y2 * y;
+    sums->s4 += (int64)y2 * y2;
+    sums->t0 += x;
+    sums->t1 += x * y;
+    sums->t2 += (int64)x * y2;
+}
+
+
+/**
+ * @brief 拟合本帧中线并计算前瞻点
+ * @param top_row 参与拟合的最高行
+ * @param speed 当前车速（编码器计数）
+ */
+void centerline_update(int top_row, float speed)
+{
+    Centerline_Sums sums = {0};
+    int i;
+    int32 x;
+    int16 y_near = 0x7FFF, y_far = -0x7FFF;
+    int64 m, c1, c2, c3, c4, u0, u1, u2; // 平移到均值m处的矩 Σ(y-m)^k 与 Σx*(y-m)^k
+    int64 k00, k01, k02, k11, k12, k22, det;
+    float a, b, c, fm, fdet, y, slope, norm;
+
+    if (top_row < 0)
+        top_row = 0;
+
+    // 1. 逐行累加（由近及远），双边丢线的行跳过，单边丢线时用另一侧边界推算中线
+    for (i = MT9V03X_H - 1; i >= top_row; i--)
+    {
+        if (!centerline_row_ok[i] || (Left_Lost_Flag[i] && Right_Lost_Flag[i]))
+            continue;
+
+        if (Left_Lost_Flag[i])
+            x = (int32)(Right_Line_Ground[i] - IPM_TRACK_WIDTH_MM * 0.5f);
+        else if (Right_Lost_Flag[i])
+            x = (int32)(Left_Line_Ground[i] + IPM_TRACK_WIDTH_MM * 0.5f);
+        else
+            x = (int32)Mid_Line_Ground[i];
+
+        centerline_add_row(&sums, centerline_row_y[i], x);
+        if (centerline_row_y[i] < y_near)
+            y_near = centerline_row_y[i];
+        if (centerline_row_y[i] > y_far)
+            y_far = centerline_row_y[i];
+    }
+
+    centerline.rows = (int16)sums.s0;
+    centerline.valid = 0;
+    if (sums.s0 < CENTERLINE_MIN_ROWS || y_far <= y_near)
+        return;
+
+    // 2. 各阶矩平移到纵坐标均值m（取整）处：Σ(y-m)^k按二项式展开，整数运算无舍入
+    m = (sums.s1 >= 0 ? sums.s1 + sums.s0 / 2 : sums.s1 - sums.s0 / 2) / sums.s0;
+    c1 = sums.s1 - m * sums.s0;
+    c2 = sums.s2 - 2 * m * sums.s1 + m * m * sums.s0;
+    c3 = sums.s3 - 3 * m * sums.s2 + 3 * m * m * sums.s1 - m * m * m * sums.s0;
+    c4 = sums.s4 - 4 * m * sums.s3 + 6 * m * m * sums.s2 - 4 * m * m * m * sums.s1 + m * m * m * m * sums.s0;
+    u0 = sums.t0;
+    u1 = sums.t1 - m * sums.t0;
+    u2 = sums.t2 - 2 * m * sums.t1 + m * m * sums.t0;
+    fm = (float)m;
+
+    // 3. 解法方程（每帧一次）：代数余子式与行列式在int64内精确计算
+    //    y-m不超过拟合纵向范围（约120cm），s0*c2*c4 < 6e18，不会溢出
+    k00 = c2 * c4 - c3 * c3;
+    k01 = c2 * c3 - c1 * c4;
+    k02 = c1 * c3 - c2 * c2;
+    det = sums.s0 * k00 + c1 * k01 + c2 * k02;
+    if (y_far - y_near >= CENTERLINE_QUAD_SPAN_CM && det > 0)
+    {
+        k11 = sums.s0 * c4 - c2 * c2;
+        k12 = c1 * c2 - sums.s0 * c3;
+        k22 = sums.s0 * c2 - c1 * c1;
+        fdet = (float)det;
+        a = ((float)k00 * (float)u0 + (float)k01 * (float)u1 + (float)k02 * (float)u2) / fdet;
+        b = ((float)k01 * (float)u0 + (float)k11 * (float)u1 + (float)k12 * (float)u2) / fdet;
+        c = ((float)k02 * (float)u0 + (float)k12 * (float)u1 + (float)k22 * (float)u2) / fdet;
+        centerline.order = 2;
+    }
+    else
+    {
+        // 纵向跨度太小，二次项不可靠，退化为直线拟合
+        det = sums.s0 * c2 - c1 * c1;
+        if (det <= 0)
+            return;
+        fdet = (float)det;
+        a = ((float)u0 * (float)c2 - (float)u1 * (float)c1) / fdet;
+        b = ((float)sums.s0 * (float)u1 - (float)c1 * (float)u0) / fdet;
+        c = 0;
+        centerline.order = 1;
+    }
+
+    // 平移回原纵坐标：x = a + b*(y-m) + c*(y-m)^2
+    centerline.a = a - (b - c * fm) * fm;
+    centerline.b = b - 2.0f * c * fm;
+    centerline.c = c;
+
+    // 4. 前瞻距离随车速增大，并限制在拟合覆盖范围内（不外推）
+    centerline.near_mm = (y_near + CENTERLINE_Y_REF_CM) * 10.0f;
+    centerline.far_mm = (y_far + CENTERLINE_Y_REF_CM) * 10.0f;
+    centerline.lookahead_mm = centerline_lookahead_base + centerline_lookahead_gain * (speed > 0 ? speed : -speed);
+    if (centerline.lookahead_mm > centerline.far_mm)
+        centerline.lookahead_mm = centerline.far_mm;
+    if (centerline.lookahead_mm < centerline.near_mm)
+        centerline.lookahead_mm = centerline.near_mm;
+
+    // 5. 前瞻点的偏差、航向、曲率（y单位为cm，x单位为mm）
+    y = centerline.lookahead_mm / 10.0f - CENTERLINE_Y_REF_CM;
+    centerline.offset_mm = centerline.a + (centerline.b + centerline.c * y) * y;
+    slope = (centerline.b + 2.0f * centerline.c * y) / 10.0f; // dx/dy（mm/mm）
+    centerline.heading = slope;
+    norm = 1.0f + slope * slope;
+    centerline.curvature = (2.0f * centerline.c / 100.0f * 1000.0f) / (norm * sqrtf(norm)); // 1/m
+    centerline.valid = 1;
+}
@@ -0,0 +1,67 @@
+/*********************************************************************
+ * 文件: centerline.h
+ * 中线最小二乘拟合头文件
+ * 说明：在地面坐标（见ipm.h）下用二次曲线 x = a + b*y + c*y^2 拟合中线，
+ *       逐行用定点整数累加法方程的各阶矩，每帧只解一次3x3方程，
+ *       输出随车速变化的前瞻距离处的横向偏差、航向和曲率，供转向提前入弯
+ ********************************************************************/
+
+#ifndef _CENTERLINE_H
+#define _CENTERLINE_H
+
+#include "zf_common_typedef.h"
+#include "zf_common_headfile.h"
+
+//============================================================
+// 宏定义
+//============================================================
+
+#define CENTERLINE_Y_REF_CM 50   // 拟合纵坐标零点（cm），使纵坐标在零附近，减小法方程的数值范围
+#define CENTERLINE_MIN_ROWS 8    // 参与拟合的最少行数，不足时本帧拟合无效
+#define CENTERLINE_QUAD_SPAN_CM 20 // 拟合覆盖的纵向跨度不小于该值（cm）时才拟合二次项，否则退化为直线
+
+//============================================================
+// 类型定义
+//============================================================
+
+typedef struct
+{
+    uint8 valid;        // 拟合是否有效
+    uint8 order;        // 拟合阶数（2=二次，1=退化为直线）
+    int16 rows;         // 参与拟合的行数
+    float a, b, c;      // x(mm) = a + b*y + c*y^2，y为(前向距离cm - CENTERLINE_Y_REF_CM)
+    float near_mm;      // 拟合覆盖的最近前向距离（mm）
+    float far_mm;       // 拟合覆盖的最远前向距离（mm）
+    float lookahead_mm; // 本帧前瞻距离（mm，已限制在拟合覆盖范围内）
+    float offset_mm;    // 前瞻点中线横向偏差（mm，中线在车右侧为正）
+    float heading;      // 前瞻点中线航向（dx/dy，右偏为正）
+    float curvature;    // 前瞻点中线曲率（1/m，向右弯为正）
+} Centerline_Model;
+
+//============================================================
+// 全局变量声明
+//============================================================
+
+extern Centerline_Model centerline;       // 本帧中线模型
+extern float centerline_lookahead_base;   // 前瞻距离基础值（mm）
+extern float centerline_lookahead_gain;   // 前瞻距离速度系数（mm/编码器计数）
+
+//============================================================
+// 函数声明
+//============================================================
+
+/**
+ * @brief 生成每行的定点纵坐标
+ * @note 在ipm_init()之后调用一次
+ */
+void centerline_init(void);
+
+/**
+ * @brief 拟合本帧中线并计算前瞻点
+ * @param top_row 参与拟合的最高行（一般为MT9V03X_H - Search_Stop_Line）
+ * @param speed 当前车速（编码器计数），用于计算前瞻距离
+ * @note 需在ipm_convert_lines()之后调用；双边丢线的行不参与拟合，单边丢线的行用另一侧边界加半个赛道宽度估计中线
+ */
+void centerline_update(int top_row, float speed);
+
+#endif
@@ -0,0 +1,235 @@
+/*********************************************************************
+ * 文件: contour.c
+ * 八邻域边界跟踪（迷宫法）实现文件
+ * 说明：沿赛道白区边界做Moore邻域跟踪，左轮廓保持黑区在左手侧（顺时针搜索），
+ *       右轮廓保持黑区在右手侧（逆时针搜索），位置较低的一侧先走，两侧相遇时停止
+ *       急弯、十字等边界接近水平的位置仍能连续跟踪，不依赖逐行扫描
+ ********************************************************************/
+
+#include "contour.h"
+#include "image.h"
+#include "Image Binarization.h"
+#include "zf_common_headfile.h"
+
+//============================================================
+// 宏定义
+//============================================================
+
+#if IMAGE_PACKED_BINARY
+#define CONTOUR_IS_WHITE(i, j) ((binaryPacked[i][(j) >> 5] & PACKED_COLUMN_BIT(j)) != 0)
+#else
+#define CONTOUR_IS_WHITE(i, j) (binaryImage[i][j] == 255)
+#endif
+
+//============================================================
+// 全局变量定义
+//============================================================
+
+Contour_Point contour_left[CONTOUR_MAX_POINTS];   // 左边界轮廓点
+Contour_Point contour_right[CONTOUR_MAX_POINTS];  // 右边界轮廓点
+uint16 contour_left_num = 0;                      // 左边界轮廓点数
+uint16 contour_right_num = 0;                     // 右边界轮廓点数
+uint8 contour_meet_row = MT9V03X_H - 1;           // 左右轮廓相遇行
+
+// 八邻域方向偏移（与CONTOUR_DIR_*编号对应）
+static const int8 contour_di[8] = {-1, -1, 0, 1, 1, 1, 0, -1};
+static const int8 contour_dj[8] = {0, 1, 1, 1, 0, -1, -1, -1};
+
+// 由相对偏移(di+1, dj+1)查方向编号（中心无效）
+static const uint8 contour_dir_of[3][3] =
+{
+    {7, 0, 1},
+    {6, 0, 2},
+    {5, 4, 3}
+};
+
+// 跟踪器状态
+typedef struct
+{
+    int row;    // 当前点行号
+    int col;    // 当前点列号
+    uint8 back; // 回溯方向：当前点指向已知黑点的方向，下一步从这里开始搜索
+} Contour_Tracer;
+
+//============================================================
+// 函数实现
+//============================================================
+
+/**
+ * @brief 判断像素是否为白点（图像外视为黑点）
+ */
+static inline uint8 Contour_Pixel_White(int i, int j)
+{
+    if (i < 0 || i > MT9V03X_H - 1 || j < 0 || j > MT9V03X_W - 1)
+        return 0;
+    Binary_Row_Ready(i);
+    return CONTOUR_IS_WHITE(i, j);
+}
+
+/**
+ * @brief 跟踪器前进一步
+ * @param t 跟踪器
+ * @param clockwise 1=顺时针搜索（左轮廓），0=逆时针搜索（右轮廓）
+ * @param dir 输出本步生长方向
+ * @return 1=前进成功，0=孤立点无法前进
+ * @note 从回溯方向（黑点）开始依次检查邻域，第一个白点为下一点，
+ *       它之前检查的黑点成为新的回溯点，两点在邻域环上相邻，必然互为八邻域
+ */
+static uint8 Contour_Step(Contour_Tracer *t, uint8 clockwise, uint8 *dir)
+{
+    uint8 k, d, prev = t->back;
+
+    for (k = 1; k < 8; k++)
+    {
+        d = clockwise ? ((t->back + k) & 7) : ((t->back + 8 - k) & 7);
+        if (Contour_Pixel_White(t->row + contour_di[d], t->col + contour_dj[d]))
+        {
+            t->row += contour_di[d];
+            t->col += contour_dj[d];
+            t->back = contour_dir_of[contour_di[prev] - contour_di[d] + 1][contour_dj[prev] - contour_dj[d] + 1];
+            *dir = d;
+            return 1;
+        }
+        prev = d;
+    }
+    return 0;
+}
+
+/**
+ * @brief 记录一个轮廓点
+ */
+static inline void Contour_Push(Contour_Point *list, uint16 *num, const Contour_Tracer *t, uint8 dir)
+{
+    list[*num].row = (uint8)t->row;
+    list[*num].col = (uint8)t->col;
+    list[*num].dir = dir;
+    (*num)++;
+}
+
+/**
+ * @brief 八邻域轮廓跟踪
+ * @param seed_row 种子行
+ * @param seed_col 种子列（白点）
+ * @return 左右轮廓是否相遇
+ */
+uint8 Contour_Extract(int seed_row, int seed_col)
+{
+    Contour_Tracer left, right;
+    uint8 left_run = 1, right_run = 1;
+    uint8 dir;
+
+    contour_left_num = 0;
+    contour_right_num = 0;
+    contour_meet_row = (uint8)seed_row;
+
+    if (!Contour_Pixel_White(seed_row, seed_col))
+        return 0;
+
+    // 在种子行上向左右找到白区边缘作为起点（与逐行扫描一致，需连续两个黑点，单个噪点直接跨过），
+    // 回溯方向指向外侧黑点
+    left.row = seed_row;
+    left.col = seed_col;
+    while (1)
+    {
+        if (Contour_Pixel_White(seed_row, left.col - 1))
+            left.col -= 1;
+        else if (Contour_Pixel_White(seed_row, left.col - 2))
+            left.col -= 2;
+        else
+            break;
+    }
+    left.back = CONTOUR_DIR_LEFT;
+
+    right.row = seed_row;
+    right.col = seed_col;
+    while (1)
+    {
+        if (Contour_Pixel_White(seed_row, right.col + 1))
+            right.col += 1;
+        else if (Contour_Pixel_White(seed_row, right.col + 2))
+            right.col += 2;
+        else
+            break;
+    }
+    right.back = CONTOUR_DIR_RIGHT;
+
+    Contour_Push(contour_left, &contour_left_num, &left, CONTOUR_DIR_UP);
+    Contour_Push(contour_right, &contour_right_num, &right, CONTOUR_DIR_UP);
+
+    // 位置较低（行号较大）的一侧先走，高度相同时两侧各走一步，
+    // 保证两侧以相近的高度向上生长，相遇点位于前方赛道的尽头
+    while (left_run || right_run)
+    {
+        uint8 left_go = left_run && (!right_run || left.row >= right.row);
+        uint8 right_go = right_run && (!left_run || right.row >= left.row);
+
+        if (left_go)
+        {
+            left_run = (contour_left_num < CONTOUR_MAX_POINTS) && Contour_Step(&left, 1, &dir);
+            if (left_run)
+                Contour_Push(contour_left, &contour_left_num, &left, dir);
+        }
+        if (right_go)
+        {
+            right_run = (contour_right_num < CONTOUR_MAX_POINTS) && Contour_Step(&right, 0, &dir);
+            if (right_run)
+                Contour_Push(contour_right, &contour_right_num, &right, dir);
+        }
+
+        // 左右跟踪点重合或相邻即为相遇
+        if (abs(left.row - right.row) <= 1 && abs(left.col - right.col) <= 1)
+        {
+            contour_meet_row = (uint8)((left.row > right.row) ? left.row : right.row);
+            return 1;
+        }
+    }
+
+    contour_meet_row = (uint8)((left.row > right.row) ? left.row : right.row);
+    return 0;
+}
+
+/**
+ * @brief 把左右轮廓换算为逐行边界
+ * @param top_row 需要换算的最高行
+ * @param left_line 输出左边界数组
+ * @param right_line 输出右边界数组
+ * @param left_lost 输出左边界丢失标志
+ * @param right_lost 输出右边界丢失标志
+ */
+void Contour_To_Rows(int top_row, volatile int *left_line, volatile int *right_line, int *left_lost, int *right_lost)
+{
+    int i;
+    uint16 k;
+
+    // 先全部记为丢线，再用轮廓第一次到达各行的点覆盖
+    for (i = top_row; i <= MT9V03X_H - 1; i++)
+    {
+        left_line[i] = -1;
+        right_line[i] = -1;
+    }
+
+    for (k = 0; k < contour_left_num; k++)
+    {
+        i = contour_left[k].row;
+        if (i >= top_row && left_line[i] < 0)
+            left_line[i] = contour_left[k].col;
+    }
+    for (k = 0; k < contour_right_num; k++)
+    {
+        i = contour_right[k].row;
+        if (i >= top_row && right_line[i] < 0)
+            right_line[i] = contour_right[k].col;
+    }
+
+    // 贴着图像边缘或未到达的行记为丢线，取值与逐行扫描一致
+    for (i = top_row; i <= MT9V03X_H - 1; i++)
+    {
+        left_lost[i] = (left_line[i] < 2);
+        if (left_lost[i])
+            left_line[i] = 2;
+
+        right_lost[i] = (right_line[i] < 0 || right_line[i] > MT9V03X_W - 1 - 2);
+        if (right_lost[i])
+            right_line[i] = MT9V03X_W - 1 - 2;
+    }
+}
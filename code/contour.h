@@ -0,0 +1,77 @@
+/*********************************************************************
+ * 文件: contour.h
+ * 八邻域边界跟踪（迷宫法）头文件
+ * 说明：从底行左右种子点出发，沿赛道白区边界做八邻域轮廓跟踪，
+ *       得到有序的左右边界点列（含每步生长方向），并可换算为逐行边界数组
+ *       作为Longest_White_Column()逐行扫描之外的可选边界提取引擎
+ ********************************************************************/
+
+#ifndef _CONTOUR_H
+#define _CONTOUR_H
+
+#include "zf_common_typedef.h"
+#include "zf_common_headfile.h"
+
+//============================================================
+// 宏定义
+//============================================================
+
+#define CONTOUR_MAX_POINTS (MT9V03X_H * 3)  // 单侧轮廓最大点数（即最大跟踪步数）
+
+// 八邻域方向编号（按屏幕顺时针，行号向下增大）
+// 7 0 1
+// 6 * 2
+// 5 4 3
+#define CONTOUR_DIR_UP 0
+#define CONTOUR_DIR_RIGHT 2
+#define CONTOUR_DIR_DOWN 4
+#define CONTOUR_DIR_LEFT 6
+
+//============================================================
+// 类型定义
+//============================================================
+
+typedef struct
+{
+    uint8 row;  // 行号
+    uint8 col;  // 列号
+    uint8 dir;  // 从上一点到本点的生长方向（种子点为CONTOUR_DIR_UP）
+} Contour_Point;
+
+//============================================================
+// 全局变量声明
+//============================================================
+
+extern Contour_Point contour_left[CONTOUR_MAX_POINTS];   // 左边界轮廓点（从底部种子点开始有序排列）
+extern Contour_Point contour_right[CONTOUR_MAX_POINTS];  // 右边界轮廓点
+extern uint16 contour_left_num;                          // 左边界轮廓点数
+extern uint16 contour_right_num;                         // 右边界轮廓点数
+extern uint8 contour_meet_row;                           // 左右轮廓相遇行（未相遇时为最后一点中较低的行）
+
+//============================================================
+// 函数声明
+//============================================================
+
+/**
+ * @brief 八邻域轮廓跟踪
+ * @param seed_row 种子行（一般为图像最底行）
+ * @param seed_col 种子列（该行上的任一白点，一般取最长白列）
+ * @return 左右轮廓是否相遇（1=相遇，0=达到最大步数或种子点不是白点）
+ * @note 从种子点向左右找到白区边缘作为左右种子，随后左轮廓顺时针、右轮廓逆时针跟踪，
+ *       位置较低的一侧先走，两侧相遇或达到CONTOUR_MAX_POINTS步时停止；图像外视为黑点
+ */
+uint8 Contour_Extract(int seed_row, int seed_col);
+
+/**
+ * @brief 把左右轮廓换算为逐行边界
+ * @param top_row 需要换算的最高行（更高的行不处理）
+ * @param left_line 输出左边界数组
+ * @param right_line 输出右边界数组
+ * @param left_lost 输出左边界丢失标志
+ * @param right_lost 输出右边界丢失标志
+ * @note 每行取轮廓第一次到达该行的点；轮廓贴着图像左右边缘或未到达的行记为丢线，
+ *       丢线时边界取值与逐行扫描一致（左2，右MT9V03X_W-3）
+ */
+void Contour_To_Rows(int top_row, volatile int *left_line, volatile int *right_line, int *left_lost, int *right_lost);
+
+#endif
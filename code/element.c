@@ -0,0 +1,162 @@
+/*********************************************************************
+ * 文件: element.c
+ * 赛道元素检测调度实现文件
+ * 说明：检测器表按运行顺序排列，新元素只需实现检测函数并在表中登记一行
+ ********************************************************************/
+
+#include "element.h"
+#include "image.h"
+#include "island.h"
+#include "stm_stat.h"
+#include "zf_common_headfile.h"
+#include "IfxStm.h"
+#include <stdio.h>
+
+//============================================================
+// 检测器适配函数
+//============================================================
+
+/**
+ * @brief 十字路口本帧不检测时清除标志（Cross_Flag逐帧判定）
+ */
+static void Cross_Skip(void)
+{
+    Cross_Flag = 0;
+}
+
+/**
+ * @brief 斑马线检测并更新标志
+ */
+static void Zebra_Update(void)
+{
+    Zebra_Stripes_Flag = Zebra_Detect();
+}
+
+/**
+ * @brief 斑马线本帧不检测时清除标志
+ */
+static void Zebra_Skip(void)
+{
+    Zebra_Stripes_Flag = 0;
+}
+
+//============================================================
+// 全局变量定义
+//============================================================
+
+// 检测器表（按运行顺序排列，前面检测器本帧的结果对后面的检测器立即生效）
+// 坡道检测在搜索停止行不足时自行清除坡道状态，环岛入环后视野变短仍需推进状态机，二者不设最小搜索停止行
+// 只初始化配置字段，运行统计字段（run_count起）为0
+Element_Detector element_detectors[] = {
+    {.name = "Cross",  .detect = Cross_Detect,  .skip = Cross_Skip, .block_state = ELEMENT_STATE_ISLAND | ELEMENT_STATE_RAMP,   .min_stop_line = 0,   .cost_us = 60},
+    {.name = "Island", .detect = Island_Detect, .skip = NULL,       .block_state = ELEMENT_STATE_CROSS | ELEMENT_STATE_RAMP,    .min_stop_line = 0,   .cost_us = 40},
+    {.name = "Ramp",   .detect = Ramp_Detect,   .skip = NULL,       .block_state = ELEMENT_STATE_CROSS | ELEMENT_STATE_ISLAND,  .min_stop_line = 0,   .cost_us = 20},
+    {.name = "Zebra",  .detect = Zebra_Update,  .skip = Zebra_Skip, .block_state = ELEMENT_STATE_CROSS | ELEMENT_STATE_ISLAND,  .min_stop_line = 110, .cost_us = 15},
+};
+const uint8 element_detector_num = sizeof(element_detectors) / sizeof(element_detectors[0]);
+
+uint32 element_frame_ticks = 0;     // 本帧元素检测总耗时
+uint32 element_frame_ticks_max = 0; // 元素检测单帧最长耗时
+
+//============================================================
+// 函数实现
+//============================================================
+
+/**
+ * @brief 由各元素标志生成当前赛道状态位
+ */
+uint8 element_state(void)
+{
+    uint8 state = 0;
+
+    if (Cross_Flag)
+        state |= ELEMENT_STATE_CROSS;
+    if (Ramp_Flag)
+        state |= ELEMENT_STATE_RAMP;
+    if (Island_State || circle_flag)
+        state |= ELEMENT_STATE_ISLAND;
+    if (Zebra_Stripes_Flag)
+        state |= ELEMENT_STATE_ZEBRA;
+    return state;
+}
+
+/**
+ * @brief 运行本帧符合条件的元素检测器
+ */
+void element_schedule(void)
+{
+    Element_Detector *detector;
+    uint32 frame_start = IfxStm_getLower(&MODULE_STM0);
+    uint32 start;
+    uint8 state;
+
+    for (detector = element_detectors; detector < element_detectors + element_detector_num; detector++)
+    {
+        state = element_state();
+
+        // 1. 前置条件：阻塞状态、所需搜索行范围
+        if ((state & detector->block_state) || Search_Stop_Line < detector->min_stop_line)
+        {
+            detector->skip_count++;
+            if (detector->skip != NULL)
+                detector->skip();
+            continue;
+        }
+
+        // 2. 运行并计时，超出声明耗时时计数（声明值偏小，单帧上界不再成立）
+        start = IfxStm_getLower(&MODULE_STM0);
+        detector->detect();
+        detector->last_ticks = IfxStm_getLower(&MODULE_STM0) - start;
+        if (detector->last_ticks > detector->max_ticks)
+            detector->max_ticks = detector->last_ticks;
+        if (detector->last_ticks > (uint32)detector->cost_us * STM_TICKS_PER_US)
+            detector->overrun_count++;
+        detector->run_count++;
+    }
+
+    element_frame_ticks = IfxStm_getLower(&MODULE_STM0) - frame_start;
+    if (element_frame_ticks > element_frame_ticks_max)
+        element_frame_ticks_max = element_frame_ticks;
+}
+
+/**
+ * @brief 清零各检测器的运行统计
+ */
+void element_stats_reset(void)
+{
+    uint8 i;
+
+    for (i = 0; i < element_detector_num; i++)
+    {
+        element_detectors[i].run_count = 0;
+        element_detectors[i].skip_count = 0;
+        element_detectors[i].overrun_count = 0;
+        element_detectors[i].last_ticks = 0;
+        element_detectors[i].max_ticks = 0;
+    }
+    element_frame_ticks = 0;
+    element_frame_ticks_max = 0;
+}
+
+/**
+ * @brief 经调试串口输出各检测器的运行统计
+ */
+void element_stats_dump(void)
+{
+    uint8 i;
+
+    printf("detector,run,skip,overrun,cost_us,max_us\r\n");
+    for (i = 0; i < element_detector_num; i++)
+    {
+        const Element_Detector *detector = &element_detectors[i];
+
+        // STM计数为10ns，输出保留两位小数
+        printf("%s,%lu,%lu,%lu,%u,%lu.%02lu\r\n", detector->name,
+               (unsigned long)detector->run_count, (unsigned long)detector->skip_count,
+               (unsigned long)detector->overrun_count, (unsigned)detector->cost_us,
+               (unsigned long)(detector->max_ticks / STM_TICKS_PER_US), (unsigned long)(detector->max_ticks % STM_TICKS_PER_US));
+    }
+    printf("element_frame_max_us,%lu.%02lu\r\n",
+           (unsigned long)(element_frame_ticks_max / STM_TICKS_PER_US),
+           (unsigned long)(element_frame_ticks_max % STM_TICKS_PER_US));
+}
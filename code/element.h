@@ -0,0 +1,80 @@
+/*********************************************************************
+ * 文件: element.h
+ * 赛道元素检测调度头文件
+ * 说明：各元素检测器以表格登记前置条件、声明耗时和所需搜索行范围，
+ *       每帧按当前赛道状态只运行符合条件的检测器，并统计各检测器的运行次数和耗时，
+ *       单帧最坏耗时不超过本帧符合条件的检测器声明耗时之和，实测值超出声明时计入overrun_count
+ ********************************************************************/
+
+#ifndef _ELEMENT_H
+#define _ELEMENT_H
+
+#include "zf_common_typedef.h"
+#include "zf_common_headfile.h"
+
+//============================================================
+// 宏定义
+//============================================================
+
+// 赛道元素状态位（由各元素标志实时生成）
+#define ELEMENT_STATE_CROSS  (1 << 0)   // 十字路口（Cross_Flag非0）
+#define ELEMENT_STATE_RAMP   (1 << 1)   // 坡道（Ramp_Flag非0）
+#define ELEMENT_STATE_ISLAND (1 << 2)   // 环岛（Island_State或circle_flag非0）
+#define ELEMENT_STATE_ZEBRA  (1 << 3)   // 斑马线（Zebra_Stripes_Flag非0）
+
+//============================================================
+// 类型定义
+//============================================================
+
+typedef struct
+{
+    const char *name;       // 检测器名称
+    void (*detect)(void);   // 检测函数
+    void (*skip)(void);     // 本帧不运行时调用（清除逐帧有效的标志），可为NULL
+    uint8 block_state;      // 这些元素进行中时不运行
+    uint8 min_stop_line;    // 所需的最小搜索停止行（检测器读取的行须已被边界搜索覆盖），0表示不限
+    uint16 cost_us;         // 声明的最坏耗时（us，超出计入overrun_count），应参考max_ticks实测值设定
+    uint32 run_count;       // 运行次数
+    uint32 skip_count;      // 因前置条件不满足跳过的次数
+    uint32 overrun_count;   // 实测耗时超出声明耗时的次数
+    uint32 last_ticks;      // 最近一次运行耗时（STM0计数，10ns）
+    uint32 max_ticks;       // 最长一次运行耗时（STM0计数，10ns）
+} Element_Detector;
+
+//============================================================
+// 全局变量声明
+//============================================================
+
+extern Element_Detector element_detectors[];  // 检测器表（按运行顺序排列）
+extern const uint8 element_detector_num;      // 检测器数量
+extern uint32 element_frame_ticks;            // 本帧元素检测总耗时（STM0计数，10ns）
+extern uint32 element_frame_ticks_max;        // 元素检测单帧最长耗时（STM0计数，10ns）
+
+//============================================================
+// 函数声明
+//============================================================
+
+/**
+ * @brief 由各元素标志生成当前赛道状态位
+ * @return ELEMENT_STATE_*的组合
+ */
+uint8 element_state(void);
+
+/**
+ * @brief 运行本帧符合条件的元素检测器
+ * @note 在边界提取之后调用；每个检测器运行前重新生成状态位，前面检测器本帧的结果对后面的检测器立即生效
+ */
+void element_schedule(void);
+
+/**
+ * @brief 清零各检测器的运行统计
+ */
+void element_stats_reset(void);
+
+/**
+ * @brief 经调试串口输出各检测器的运行统计（CSV，单位us）
+ * @note 由prof_dump()在分段统计表之后调用
+ */
+void element_stats_dump(void);
+
+#endif
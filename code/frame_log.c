@@ -0,0 +1,74 @@
+/*********************************************************************
+ * 文件: frame_log.c
+ * 图像录制与逐帧结果输出实现文件
+ * 说明：CSV经printf输出到调试串口，原始帧用uart_write_buffer直接发送
+ ********************************************************************/
+
+#include "frame_log.h"
+#include "image.h"
+#include "stm_stat.h"
+#include "zf_common_headfile.h"
+#include <stdio.h>
+
+//============================================================
+// 全局变量定义
+//============================================================
+
+uint32 frame_log_stream = 0; // 逐帧CSV输出间隔（0=关闭）
+
+//============================================================
+// 函数实现
+//============================================================
+
+/**
+ * @brief 输出CSV表头
+ */
+void frame_log_csv_header(void)
+{
+    int16 row;
+
+    printf("frame,threshold,stop_line,cross,ramp,island,circle,zebra,steer_error,process_us");
+    for (row = MT9V03X_H - 1; row >= 0; row -= FRAME_LOG_ROW_STEP)
+    {
+        printf(",l%d,r%d", row, row);
+    }
+    printf("\r\n");
+}
+
+/**
+ * @brief 输出当前帧的处理结果（一行CSV）
+ */
+void frame_log_csv_line(uint32 frame_id, float steer_error, uint32 process_ticks)
+{
+    int16 row;
+
+    printf("%lu,%d,%d,%d,%d,%d,%d,%d,%.2f,%lu",
+           (unsigned long)frame_id, threshold, Search_Stop_Line,
+           Cross_Flag, Ramp_Flag, Island_State, circle_flag, Zebra_Stripes_Flag,
+           steer_error, (unsigned long)(process_ticks / STM_TICKS_PER_US));
+    for (row = MT9V03X_H - 1; row >= 0; row -= FRAME_LOG_ROW_STEP)
+    {
+        printf(",%d,%d", Left_Line[row], Right_Line[row]);
+    }
+    printf("\r\n");
+}
+
+/**
+ * @brief 输出一帧原始灰度图像
+ */
+void frame_log_dump_frame(uint32 frame_id, const uint8 *gray)
+{
+    uint8 header[12] = {'F', 'R', 'M', '0'};
+
+    header[4] = (uint8)(frame_id);
+    header[5] = (uint8)(frame_id >> 8);
+    header[6] = (uint8)(frame_id >> 16);
+    header[7] = (uint8)(frame_id >> 24);
+    header[8] = (uint8)(MT9V03X_W);
+    header[9] = (uint8)(MT9V03X_W >> 8);
+    header[10] = (uint8)(MT9V03X_H);
+    header[11] = (uint8)(MT9V03X_H >> 8);
+
+    uart_write_buffer(DEBUG_UART_INDEX, header, sizeof(header));
+    uart_write_buffer(DEBUG_UART_INDEX, gray, MT9V03X_W * MT9V03X_H);
+}
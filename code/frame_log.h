@@ -0,0 +1,54 @@
+/*********************************************************************
+ * 文件: frame_log.h
+ * 图像录制与逐帧结果输出头文件
+ * 说明：通过调试串口输出原始灰度帧（188x120）和逐帧处理结果CSV，供上位机回放
+ *       上位机回放时用录制的帧调用image_process_frame()，再调用frame_log_csv_line()，
+ *       与车上输出的CSV逐行比对即可做回归检查；图像处理代码不依赖摄像头驱动
+ *       帧格式：4字节帧头"FRM0" + 帧号(uint32小端) + 宽(uint16) + 高(uint16) + 宽*高字节灰度
+ ********************************************************************/
+
+#ifndef _FRAME_LOG_H
+#define _FRAME_LOG_H
+
+#include "zf_common_typedef.h"
+#include "zf_common_headfile.h"
+
+//============================================================
+// 宏定义
+//============================================================
+
+#define FRAME_LOG_ROW_STEP 10     // CSV中边界数组的采样行间隔（从底部开始，每隔该行数输出一对左右边界）
+
+//============================================================
+// 全局变量声明
+//============================================================
+
+extern uint32 frame_log_stream; // 逐帧CSV输出间隔（0=关闭，N=每N帧输出一行），菜单可调
+
+//============================================================
+// 函数声明
+//============================================================
+
+/**
+ * @brief 输出CSV表头
+ */
+void frame_log_csv_header(void);
+
+/**
+ * @brief 输出当前帧的处理结果（一行CSV）
+ * @param frame_id 帧号
+ * @param steer_error 转向误差
+ * @param process_ticks 本帧处理耗时（STM计数，上位机回放时可填0）
+ * @note 内容：帧号、阈值、搜索停止行、各元素标志、转向误差、耗时、采样行的左右边界
+ */
+void frame_log_csv_line(uint32 frame_id, float steer_error, uint32 process_ticks);
+
+/**
+ * @brief 输出一帧原始灰度图像
+ * @param frame_id 帧号
+ * @param gray 灰度图像（MT9V03X_H x MT9V03X_W）
+ * @note 115200波特率下一帧约需2s，只用于按键抓拍，不能在行驶中连续调用
+ */
+void frame_log_dump_frame(uint32 frame_id, const uint8 *gray);
+
+#endif
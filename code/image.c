@@ -7,6 +7,12 @@
  ********************************************************************/
 
 #include "image.h"
+#include "auto_exposure.h"
+#include "centerline.h"
+#include "contour.h"
+#include "element.h"
+#include "ipm.h"
+#include "latency.h"
 #include "zf_common_headfile.h"
 
 //============================================================
@@ -16,12 +22,20 @@
 #define IMG_BLACK 0     // 黑色像素值
 #define IMG_WHITE 255   // 白色像素值
 
+// 调试叠加（Show_Boundry/Draw_Line）把像素置黑，写入当前使用的二值图
+#if IMAGE_PACKED_BINARY
+#define BINARY_SET_BLACK(i, j) (binaryPacked[i][(j) >> 5] &= ~PACKED_COLUMN_BIT(j))
+#else
+#define BINARY_SET_BLACK(i, j) (binaryImage[i][j] = IMG_BLACK)
+#endif
+
 //============================================================
 // 全局变量定义
 //============================================================
 
 // -------------------- 元素检测标志 --------------------
-volatile int circle_flag = 0;       // 环岛标志
+volatile int circle_flag = 0;       // 环岛标志（0=无环岛，1=左环岛，2=右环岛）
+volatile int left_circle_flag = 0;  // 左环岛标志（0/1/2/3不同状态）
 volatile int right_circle_flag = 0; // 右环岛标志（0/1/2/3不同状态）
 volatile int Island_State = 0;      // 环岛状态
 volatile int Cross_Flag = 0;        // 十字路口检测标志
@@ -34,10 +48,15 @@ int Encoder_Left = 0;  // 左编码器累计值
 int encoder_sum = 0;   // 编码器总和
 
 // -------------------- 图像数据数组 --------------------
-uint8 image_copy[IMAGE_HEIGHT][IMAGE_WIDTH];  // 图像副本数组
+#if MT9V03X_FRAME_BUFFER_NUM == 1
+IFX_ALIGN(4) uint8 image_copy[IMAGE_HEIGHT][IMAGE_WIDTH];  // 图像副本数组（按字复制，需4字节对齐）
+#endif
+uint8 (*image_gray)[IMAGE_WIDTH] = mt9v03x_image;          // 本帧处理所用的灰度图
+uint32 image_frame_stamp = 0;                              // 本帧场同步时刻（STM0计数，0表示未知）
+uint32 image_frame_id = 0;                                 // 本帧帧号（采集驱动随帧交接的帧号）
+static uint16 gray_histogram[GRAY_LEVELS];                 // 本帧灰度直方图（大津法采样）
 
 extern const uint8 Image_Flags[][9][8];       // 外部图像标志数组
-extern uint8_t binaryImage[IMAGE_HEIGHT][IMAGE_WIDTH]; // 二值化图像数组
 
 volatile int Left_Line[MT9V03X_H];            // 左边界数组
 volatile int Right_Line[MT9V03X_H];           // 右边界数组
@@ -90,23 +109,442 @@ int turn_start = 50;  // 转弯检测起始行
 int turn_end = 53;    // 转弯检测结束行
 
 int threshold;         // 全局二值化阈值
+uint32 adaptive_threshold_enable = 0;  // 自适应阈值开关（0=全局大津法阈值，1=局部均值阈值），菜单可调
+uint32 adaptive_threshold_offset = 8;  // 自适应阈值：局部均值减去的偏移量
+uint32 adaptive_threshold_margin = 40; // 自适应阈值：局部阈值相对全局阈值的最大偏离
+#if IMAGE_PYRAMID
+uint8 binary_half[IMAGE_PYRAMID_ROWS / 2][IMAGE_HALF_WIDTH]; // 远场半分辨率二值图
+#endif
+#if IMAGE_LAZY_BINARY
+uint32 binary_row_valid[BINARY_ROW_VALID_WORDS]; // 本帧已二值化的行
+int binary_row_count = 0;                        // 本帧已二值化的行数
+#endif
 uint8 image_proess = 0; // 图像处理完成标志
 
 //============================================================
 // 函数实现
 //============================================================
 
+#if IMAGE_PACKED_BINARY
+/**
+ * @brief 统计每列从底部开始的连续白点数（压缩二值图版本）
+ * @param start_column 起始列
+ * @param end_column 结束列
+ * @note 逐行与运算维护"仍为白"的列掩码，某列变黑时用CLZ定位并记录其白点数，
+ *       所有列都变黑后提前结束
+ */
+static void White_Column_Count_Packed(int start_column, int end_column)
+{
+    uint32 alive[BINARY_PACKED_WORDS];
+    uint32 any;
+    int i, w;
+
+    for (w = 0; w < BINARY_PACKED_WORDS; w++)
+    {
+        alive[w] = packed_range_mask(w, start_column, end_column);
+    }
+
+    for (i = MT9V03X_H - 1; i >= 0; i--)
+    {
+        Binary_Row_Ready(i);
+        any = 0;
+        for (w = 0; w < BINARY_PACKED_WORDS; w++)
+        {
+            uint32 dead = alive[w] & ~binaryPacked[i][w];
+            alive[w] &= binaryPacked[i][w];
+            while (dead)
+            {
+                uint32 b = bit_clz32(dead);
+                White_Column[w * 32 + b] = MT9V03X_H - 1 - i;
+                dead &= ~(0x80000000u >> b);
+            }
+            any |= alive[w];
+        }
+        if (any == 0)
+        {
+            return;
+        }
+    }
+
+    // 整列全白
+    for (w = 0; w < BINARY_PACKED_WORDS; w++)
+    {
+        while (alive[w])
+        {
+            uint32 b = bit_clz32(alive[w]);
+            White_Column[w * 32 + b] = MT9V03X_H;
+            alive[w] &= ~(0x80000000u >> b);
+        }
+    }
+}
+
+/**
+ * @brief 计算某行第w个字的"白-黑-黑"右边界候选位（压缩二值图）
+ * @note 候选列j满足：j白、j+1黑、j+2黑
+ */
+static inline uint32 Packed_Right_Edge_Word(const uint32 *row, int w)
+{
+    uint32 next = (w + 1 < BINARY_PACKED_WORDS) ? row[w + 1] : 0;
+    uint32 s1 = (row[w] << 1) | (next >> 31);
+    uint32 s2 = (row[w] << 2) | (next >> 30);
+    return row[w] & ~s1 & ~s2;
+}
+
+/**
+ * @brief 计算某行第w个字的"黑-黑-白"左边界候选位（压缩二值图）
+ * @note 候选列j满足：j白、j-1黑、j-2黑
+ */
+static inline uint32 Packed_Left_Edge_Word(const uint32 *row, int w)
+{
+    uint32 prev = (w > 0) ? row[w - 1] : 0;
+    uint32 p1 = (row[w] >> 1) | (prev << 31);
+    uint32 p2 = (row[w] >> 2) | (prev << 30);
+    return row[w] & ~p1 & ~p2;
+}
+
+#if !IMAGE_CONTOUR_ENGINE
+/**
+ * @brief 从start列向右搜索右边界（压缩二值图）
+ * @param row 行数据
+ * @param start 起始列
+ * @param lost 输出丢线标志
+ * @return 右边界列号，丢线时返回MT9V03X_W - 3
+ */
+static int Packed_Find_Right_Border(const uint32 *row, int start, int *lost)
+{
+    for (int w = start >> 5; w < BINARY_PACKED_WORDS; w++)
+    {
+        uint32 m = Packed_Right_Edge_Word(row, w) & packed_range_mask(w, start, MT9V03X_W - 1 - 2);
+        if (m)
+        {
+            *lost = 0;
+            return w * 32 + (int)bit_clz32(m);
+        }
+    }
+    *lost = 1;
+    return MT9V03X_W - 1 - 2;
+}
+
+/**
+ * @brief 从start列向左搜索左边界（压缩二值图）
+ * @param row 行数据
+ * @param start 起始列
+ * @param lost 输出丢线标志
+ * @return 左边界列号，丢线时返回2
+ */
+static int Packed_Find_Left_Border(const uint32 *row, int start, int *lost)
+{
+    for (int w = start >> 5; w >= 0; w--)
+    {
+        uint32 m = Packed_Left_Edge_Word(row, w) & packed_range_mask(w, 2, start);
+        if (m)
+        {
+            *lost = 0;
+            return w * 32 + (int)bit_clz32(m & (~m + 1)); // 取最低位，即最靠右的候选列
+        }
+    }
+    *lost = 1;
+    return 2;
+}
+#endif
+#endif
+
+/**
+ * @brief 统计[start_column, end_column]内每列从底部开始的连续白点数
+ * @param start_column 起始列
+ * @param end_column 结束列
+ */
+static void White_Column_Count(int start_column, int end_column)
+{
+#if IMAGE_PACKED_BINARY
+    White_Column_Count_Packed(start_column, end_column);
+#else
+    int i, j;
+
+    for (j = start_column; j <= end_column; j++)
+    {
+        White_Column[j] = 0;
+        for (i = MT9V03X_H - 1; i >= 0; i--)
+        {
+            Binary_Row_Ready(i);
+            if (binaryImage[i][j] == IMG_BLACK)
+                break;
+            else
+                White_Column[j]++;
+        }
+    }
+#endif
+}
+
+#if IMAGE_BOUNDARY_TRACKING
+#if IMAGE_PACKED_BINARY
+#define BINARY_IS_WHITE(i, j) ((binaryPacked[i][(j) >> 5] & PACKED_COLUMN_BIT(j)) != 0)
+#else
+#define BINARY_IS_WHITE(i, j) (binaryImage[i][j] == IMG_WHITE)
+#endif
+
+// -------------------- 帧间跟踪状态 --------------------
+static int track_valid = 0;           // 上一帧结果可用于跟踪
+static int track_left[MT9V03X_H];     // 上一帧搜索得到的左边界（-1表示丢线或未搜索）
+static int track_right[MT9V03X_H];    // 上一帧搜索得到的右边界（-1表示丢线或未搜索）
+static int track_column_left = 0;     // 上一帧左侧最长白列列号
+static int track_column_right = 0;    // 上一帧右侧最长白列列号
+static int track_stop_line = 0;       // 上一帧搜索停止行
+int Boundary_Track_Rows = 0;          // 本帧在跟踪窗口内找到边界的行数
+
+/**
+ * @brief 在上一帧右边界附近的窗口内搜索本行右边界
+ * @param i 行号
+ * @param start 本帧右侧最长白列（全行搜索的起点）
+ * @return 右边界列号，窗口内找不到时返回-1
+ * @note 窗口起点必须为白点，保证窗口内第一个"白-黑-黑"与全行搜索结果一致的可能性
+ */
+static int Track_Right_Border(int i, int start)
+{
+    int j, lo, hi;
+
+    if (track_right[i] < 0)
+        return -1;
+
+    lo = track_right[i] - IMAGE_TRACK_EDGE_WINDOW;
+    hi = track_right[i] + IMAGE_TRACK_EDGE_WINDOW;
+    if (lo < start)
+        lo = start;
+    if (hi > MT9V03X_W - 1 - 2)
+        hi = MT9V03X_W - 1 - 2;
+    if (lo > hi || !BINARY_IS_WHITE(i, lo))
+        return -1;
+
+    for (j = lo; j <= hi; j++)
+    {
+        if (BINARY_IS_WHITE(i, j) && !BINARY_IS_WHITE(i, j + 1) && !BINARY_IS_WHITE(i, j + 2))
+            return j;
+    }
+    return -1;
+}
+
+/**
+ * @brief 在上一帧左边界附近的窗口内搜索本行左边界
+ * @param i 行号
+ * @param start 本帧左侧最长白列（全行搜索的起点）
+ * @return 左边界列号，窗口内找不到时返回-1
+ */
+static int Track_Left_Border(int i, int start)
+{
+    int j, lo, hi;
+
+    if (track_left[i] < 0)
+        return -1;
+
+    lo = track_left[i] - IMAGE_TRACK_EDGE_WINDOW;
+    hi = track_left[i] + IMAGE_TRACK_EDGE_WINDOW;
+    if (hi > start)
+        hi = start;
+    if (lo < 2)
+        lo = 2;
+    if (lo > hi || !BINARY_IS_WHITE(i, hi))
+        return -1;
+
+    for (j = hi; j >= lo; j--)
+    {
+        if (BINARY_IS_WHITE(i, j) && !BINARY_IS_WHITE(i, j - 1) && !BINARY_IS_WHITE(i, j - 2))
+            return j;
+    }
+    return -1;
+}
+
+/**
+ * @brief 在上一帧最长白列附近的窗口内统计白列
+ * @param start_column 本帧允许的起始列
+ * @param end_column 本帧允许的结束列
+ * @note 两个窗口重叠时重叠部分重复统计，结果不变
+ */
+static void White_Column_Count_Track(int start_column, int end_column)
+{
+    int lo, hi;
+
+    lo = track_column_left - IMAGE_TRACK_COLUMN_WINDOW;
+    hi = track_column_left + IMAGE_TRACK_COLUMN_WINDOW;
+    White_Column_Count(lo < start_column ? start_column : lo, hi > end_column ? end_column : hi);
+
+    lo = track_column_right - IMAGE_TRACK_COLUMN_WINDOW;
+    hi = track_column_right + IMAGE_TRACK_COLUMN_WINDOW;
+    White_Column_Count(lo < start_column ? start_column : lo, hi > end_column ? end_column : hi);
+}
+
+/**
+ * @brief 保存本帧边界供下一帧跟踪，并判断下一帧能否继续跟踪
+ * @param tracking 本帧是否使用了跟踪
+ * @note 处于元素状态、有效行太少或本帧跟踪成功行数不足一半时，下一帧退回全图搜索
+ */
+static void Boundary_Track_Update(int tracking)
+{
+    int i;
+    int scan_rows = 0;
+    int found_rows = 0;
+
+    for (i = 0; i <= MT9V03X_H - 1; i++)
+    {
+        if (i >= MT9V03X_H - Search_Stop_Line)
+        {
+            scan_rows++;
+            track_left[i] = Left_Lost_Flag[i] ? -1 : Left_Line[i];
+            track_right[i] = Right_Lost_Flag[i] ? -1 : Right_Line[i];
+            if (!Left_Lost_Flag[i] && !Right_Lost_Flag[i])
+                found_rows++;
+        }
+        else
+        {
+            track_left[i] = -1;
+            track_right[i] = -1;
+        }
+    }
+
+    track_column_left = Longest_White_Column_Left[1];
+    track_column_right = Longest_White_Column_Right[1];
+    track_stop_line = Search_Stop_Line;
+
+    track_valid = (circle_flag == 0 && Cross_Flag == 0 && Island_State == 0 && Ramp_Flag == 0) &&
+                  scan_rows >= 20 && found_rows * 2 >= scan_rows &&
+                  (!tracking || Boundary_Track_Rows * 2 >= found_rows);
+}
+#endif
+
+#if IMAGE_PYRAMID
+/**
+ * @brief 生成远场半分辨率二值图
+ * @note 2x2像素灰度和与4倍阈值比较，等价于均值与阈值比较，不做除法
+ */
+static void Pyramid_Build(void)
+{
+    int h, c;
+    uint32 limit = (uint32)threshold * 4;
+
+    for (h = 0; h < IMAGE_PYRAMID_ROWS / 2; h++)
+    {
+        const uint8 *r0 = image_gray[2 * h];
+        const uint8 *r1 = image_gray[2 * h + 1];
+        for (c = 0; c < IMAGE_HALF_WIDTH; c++)
+        {
+            uint32 sum = (uint32)r0[2 * c] + r0[2 * c + 1] + r1[2 * c] + r1[2 * c + 1];
+            binary_half[h][c] = (sum > limit) ? IMG_WHITE : IMG_BLACK;
+        }
+    }
+}
+
+/**
+ * @brief 在半分辨率二值图上搜索远场行右边界
+ * @param i 全分辨率行号
+ * @param start 全分辨率起始列
+ * @param lost 输出丢线标志
+ * @return 全分辨率右边界列号，丢线时返回MT9V03X_W - 3
+ * @note 与全分辨率逐点搜索相同的"白-黑-黑"规则和跳列方式
+ */
+static int Pyramid_Find_Right_Border(int i, int start, int *lost)
+{
+    const uint8 *row = binary_half[i >> 1];
+    int j = start >> 1;
+
+    while (j <= IMAGE_HALF_WIDTH - 1 - 2)
+    {
+        if (row[j + 2] == IMG_WHITE)
+            j += 2;
+        else if (row[j + 1] == IMG_WHITE)
+            j += 1;
+        else if (row[j] == IMG_WHITE)
+        {
+            *lost = 0;
+            return 2 * j + 1;
+        }
+        else
+            j += 3;
+    }
+    *lost = 1;
+    return MT9V03X_W - 1 - 2;
+}
+
+/**
+ * @brief 在半分辨率二值图上搜索远场行左边界
+ * @param i 全分辨率行号
+ * @param start 全分辨率起始列
+ * @param lost 输出丢线标志
+ * @return 全分辨率左边界列号，丢线时返回2
+ */
+static int Pyramid_Find_Left_Border(int i, int start, int *lost)
+{
+    const uint8 *row = binary_half[i >> 1];
+    int j = start >> 1;
+
+    while (j >= 0 + 2)
+    {
+        if (row[j - 2] == IMG_WHITE)
+            j -= 2;
+        else if (row[j - 1] == IMG_WHITE)
+            j -= 1;
+        else if (row[j] == IMG_WHITE)
+        {
+            *lost = 0;
+            return 2 * j;
+        }
+        else
+            j -= 3;
+    }
+    *lost = 1;
+    return 2;
+}
+#endif
+
+#if !IMAGE_CONTOUR_ENGINE
+static int white_front_min[MT9V03X_W]; // 白列累积最小值（已知白区前沿用）
+
+/**
+ * @brief 计算已知白区前沿所需的白列累积最小值
+ * @param start_column 白列统计起始列
+ * @param end_column 白列统计结束列
+ * @note 右侧：white_front_min[c] = min(White_Column[右最长白列..c])
+ *       左侧：white_front_min[c] = min(White_Column[c..左最长白列])
+ *       第i行若white_front_min[c] >= MT9V03X_H - i，则从最长白列到c列在第i行全为白点
+ */
+static void White_Front_Build(int start_column, int end_column)
+{
+    int c;
+
+    white_front_min[Longest_White_Column_Right[1]] = White_Column[Longest_White_Column_Right[1]];
+    for (c = Longest_White_Column_Right[1] + 1; c <= end_column; c++)
+    {
+        white_front_min[c] = (White_Column[c] < white_front_min[c - 1]) ? White_Column[c] : white_front_min[c - 1];
+    }
+
+    white_front_min[Longest_White_Column_Left[1]] = White_Column[Longest_White_Column_Left[1]];
+    for (c = Longest_White_Column_Left[1] - 1; c >= start_column; c--)
+    {
+        white_front_min[c] = (White_Column[c] < white_front_min[c + 1]) ? White_Column[c] : white_front_min[c + 1];
+    }
+}
+#endif
+
 /**
  * @brief 最长白列检测并提取边界
  * @note 通过扫描每列的白色像素，找到最长的白色列作为起跑线或停止线的参考
  *       同时从最长白列位置开始，向左右扫描边界
+ *       IMAGE_BOUNDARY_TRACKING开启时优先在上一帧结果附近的窗口内搜索
  */
 void Longest_White_Column()
 {
-    int i, j;
+    int i;
     int start_column = 35;
     int end_column = MT9V03X_W - 35;
+#if !IMAGE_CONTOUR_ENGINE
     int left_border = 0, right_border = 0;
+    int right_front, left_front;  // 已知白区前沿（右侧为第一个未知列，左侧为最后一个未知列）
+    int right_start, left_start;  // 本行全行搜索的实际起点
+#if !IMAGE_PACKED_BINARY
+    int j;
+#endif
+#endif
+#if IMAGE_BOUNDARY_TRACKING
+    int tracking = track_valid && circle_flag == 0;
+#endif
 
     // 初始化变量
     Longest_White_Column_Left[0] = 0;
@@ -132,7 +570,7 @@ void Longest_White_Column()
         White_Column[i] = 0;
     }
 
-    // 环岛状态下调整扫描范围
+    // 环岛状态下调整扫描范围（入环时只在环岛一侧统计白列，避免最长白列落在直行方向）
     if (circle_flag)
     {
         if (right_circle_flag == 2)
@@ -140,20 +578,23 @@ void Longest_White_Column()
             start_column = 60;
             end_column = MT9V03X_W - 20;
         }
-    }
-
-    // 统计每列的白色像素数量
-    for (j = start_column; j <= end_column; j++)
-    {
-        for (i = MT9V03X_H - 1; i >= 0; i--)
+        else if (left_circle_flag == 2)
         {
-            if (binaryImage[i][j] == IMG_BLACK)
-                break;
-            else
-                White_Column[j]++;
+            start_column = 20;
+            end_column = MT9V03X_W - 60;
         }
     }
 
+    // 统计每列的白色像素数量
+#if IMAGE_BOUNDARY_TRACKING
+    if (tracking)
+        White_Column_Count_Track(start_column, end_column);
+    else
+        White_Column_Count(start_column, end_column);
+#else
+    White_Column_Count(start_column, end_column);
+#endif
+
     // 找左侧最长白列
     Longest_White_Column_Left[0] = 0;
     for (i = start_column; i <= end_column; i++)
@@ -179,45 +620,116 @@ void Longest_White_Column()
     // 确定搜索停止行（取左右最长白列中的较大值）
     Search_Stop_Line = (Longest_White_Column_Left[0] > Longest_White_Column_Right[0]) ? Longest_White_Column_Left[0] : Longest_White_Column_Right[0];
 
+#if IMAGE_BOUNDARY_TRACKING
+    // 跟踪窗口内的最长白列明显变短，说明最长白列已移出窗口，本帧退回全图搜索
+    if (tracking && Search_Stop_Line < track_stop_line - IMAGE_TRACK_STOP_LINE_DROP)
+    {
+        tracking = 0;
+        track_valid = 0;
+        Longest_White_Column();
+        return;
+    }
+    Boundary_Track_Rows = 0;
+#endif
+
+#if IMAGE_CONTOUR_ENGINE
+    // 八邻域轮廓跟踪代替逐行扫描，从最底行的最长白列出发
+    Contour_Extract(MT9V03X_H - 1, Longest_White_Column_Left[1]);
+    Contour_To_Rows(MT9V03X_H - Search_Stop_Line, Left_Line, Right_Line, Left_Lost_Flag, Right_Lost_Flag);
+#else
+    // 已知白区前沿：白列统计已证明最长白列到前沿之间在本行全为白点，这些列不可能是边界，
+    // 全行搜索从前沿处开始，结果与从最长白列开始逐点搜索完全一致。
+    // 行号越往上需要的连续白点越多，前沿只会向最长白列收缩，逐行接着上一行的位置移动即可
+    White_Front_Build(start_column, end_column);
+    right_front = end_column + 1;
+    left_front = start_column - 1;
+
     // 从最长白列位置开始，向上扫描边界
     for (i = MT9V03X_H - 1; i >= MT9V03X_H - Search_Stop_Line; i--)
     {
-        // 扫描右边界
-        for (j = Longest_White_Column_Right[1]; j <= MT9V03X_W - 1 - 2; j++)
+        right_border = -1;
+        left_border = -1;
+
+        while (right_front > Longest_White_Column_Right[1] && white_front_min[right_front - 1] < MT9V03X_H - i)
+            right_front--;
+        while (left_front < Longest_White_Column_Left[1] && white_front_min[left_front + 1] < MT9V03X_H - i)
+            left_front++;
+        // 前沿以内全白，"白-黑-黑"最早只能从前沿前一列开始
+        right_start = (right_front - 1 > Longest_White_Column_Right[1]) ? right_front - 1 : Longest_White_Column_Right[1];
+        left_start = (left_front + 1 < Longest_White_Column_Left[1]) ? left_front + 1 : Longest_White_Column_Left[1];
+#if IMAGE_PYRAMID
+        // 远场行在半分辨率图上搜索
+        if (IMAGE_PYRAMID_FAR(i))
+        {
+            right_border = Pyramid_Find_Right_Border(i, right_start, &Right_Lost_Flag[i]);
+            left_border = Pyramid_Find_Left_Border(i, left_start, &Left_Lost_Flag[i]);
+        }
+#endif
+#if IMAGE_BOUNDARY_TRACKING
+        // 先在上一帧边界附近的窗口内搜索
+        if (tracking && !IMAGE_PYRAMID_FAR(i))
+        {
+            right_border = Track_Right_Border(i, Longest_White_Column_Right[1]);
+            left_border = Track_Left_Border(i, Longest_White_Column_Left[1]);
+            if (right_border >= 0 && left_border >= 0)
+                Boundary_Track_Rows++;
+        }
+#endif
+#if IMAGE_PACKED_BINARY
+        if (right_border < 0)
+            right_border = Packed_Find_Right_Border(binaryPacked[i], right_start, &Right_Lost_Flag[i]);
+        if (left_border < 0)
+            left_border = Packed_Find_Left_Border(binaryPacked[i], left_start, &Left_Lost_Flag[i]);
+#else
+        // 扫描右边界（逐个候选列j检查"白-黑-黑"，先看最远的j+2：
+        // j+2为白则j、j+1都不可能是边界，跳2列；j+2黑、j+1白则下一候选为j+1；三点全黑跳3列）
+        j = right_start;
+        while (right_border < 0 && j <= MT9V03X_W - 1 - 2)
         {
-            if (binaryImage[i][j] == IMG_WHITE && binaryImage[i][j + 1] == IMG_BLACK && binaryImage[i][j + 2] == IMG_BLACK)
+            if (binaryImage[i][j + 2] == IMG_WHITE)
+                j += 2;
+            else if (binaryImage[i][j + 1] == IMG_WHITE)
+                j += 1;
+            else if (binaryImage[i][j] == IMG_WHITE)
             {
                 right_border = j;
                 Right_Lost_Flag[i] = 0;
-                break;
-            }
-            else if (j >= MT9V03X_W - 1 - 2)
-            {
-                right_border = j;
-                Right_Lost_Flag[i] = 1;
-                break;
             }
+            else
+                j += 3;
+        }
+        if (right_border < 0)
+        {
+            right_border = MT9V03X_W - 1 - 2;
+            Right_Lost_Flag[i] = 1;
         }
 
-        // 扫描左边界
-        for (j = Longest_White_Column_Left[1]; j >= 0 + 2; j--)
+        // 扫描左边界（与右边界对称，先看j-2）
+        j = left_start;
+        while (left_border < 0 && j >= 0 + 2)
         {
-            if (binaryImage[i][j] == IMG_WHITE && binaryImage[i][j - 1] == IMG_BLACK && binaryImage[i][j - 2] == IMG_BLACK)
+            if (binaryImage[i][j - 2] == IMG_WHITE)
+                j -= 2;
+            else if (binaryImage[i][j - 1] == IMG_WHITE)
+                j -= 1;
+            else if (binaryImage[i][j] == IMG_WHITE)
             {
                 left_border = j;
                 Left_Lost_Flag[i] = 0;
-                break;
-            }
-            else if (j <= 2)
-            {
-                left_border = j;
-                Left_Lost_Flag[i] = 1;
-                break;
             }
+            else
+                j -= 3;
+        }
+        if (left_border < 0)
+        {
+            left_border = 2;
+            Left_Lost_Flag[i] = 1;
         }
+#endif
         Left_Line[i] = left_border;
         Right_Line[i] = right_border;
     }
+#endif
 
     // 统计边界丢失次数和边界起始行
     for (i = MT9V03X_H - 1; i >= 0; i--)
@@ -234,6 +746,10 @@ void Longest_White_Column()
             Boundry_Start_Right = i;
         Road_Wide[i] = Right_Line[i] - Left_Line[i];
     }
+
+#if IMAGE_BOUNDARY_TRACKING
+    Boundary_Track_Update(tracking);
+#endif
 }
 
 /**
@@ -245,24 +761,122 @@ void Show_Boundry(void)
     int16 i;
     for (i = MT9V03X_H - 1; i >= MT9V03X_H - Search_Stop_Line; i--)
     {
-        binaryImage[i][Left_Line[i] + 1] = IMG_BLACK;
-        binaryImage[i][(Left_Line[i] + Right_Line[i]) >> 1] = IMG_BLACK;
-        binaryImage[i][Right_Line[i] - 1] = IMG_BLACK;
+        BINARY_SET_BLACK(i, Left_Line[i] + 1);
+        BINARY_SET_BLACK(i, (Left_Line[i] + Right_Line[i]) >> 1);
+        BINARY_SET_BLACK(i, Right_Line[i] - 1);
+    }
+}
+
+// -------------------- 整数增量画线（DDA） --------------------
+// 按 v = v1 + (t - t1) * (v2 - v1) / (t2 - t1) 逐个t计算直线坐标，
+// 初始化时做一次除法，之后每步只做加法和一次比较（TriCore没有单周期除法）；
+// 同时保存商和余数，可精确得到与C语言整数除法（向零取整）或向下取整完全相同的结果
+typedef struct
+{
+    int base;      // 起点坐标v1
+    int num;       // 当前分子 (t - t1) * dv（分母取正后的符号）
+    int quot;      // 当前分子除以分母的商（向下取整）
+    int rem;       // 当前余数（0 <= rem < den）
+    int den;       // 分母 |t2 - t1|
+    int step_num;  // t每加1分子的增量
+    int step_quot; // t每加1商的增量（向下取整）
+    int step_rem;  // t每加1余数的增量（0 <= step_rem < den）
+} Line_DDA;
+
+/**
+ * @brief 向下取整的整数除法
+ * @param a 被除数
+ * @param b 除数（必须为正）
+ */
+static inline int Floor_Div(int a, int b)
+{
+    int q = a / b;
+    if (a % b != 0 && a < 0)
+        q--;
+    return q;
+}
+
+/**
+ * @brief 初始化画线迭代器
+ * @param dda 迭代器
+ * @param v1 起点坐标
+ * @param t1 起点自变量
+ * @param v2 终点坐标
+ * @param t2 终点自变量
+ * @param t 迭代起始的自变量
+ * @note t1 == t2时退化为常量v1（原逐行公式在该情况下会除零）
+ */
+static void Line_DDA_Init(Line_DDA *dda, int v1, int t1, int v2, int t2, int t)
+{
+    int dv = v2 - v1;
+    int dt = t2 - t1;
+
+    dda->base = v1;
+    if (dt == 0)
+    {
+        dda->num = dda->quot = dda->rem = 0;
+        dda->step_num = dda->step_quot = dda->step_rem = 0;
+        dda->den = 1;
+        return;
+    }
+    if (dt < 0)
+    {
+        dt = -dt;
+        dv = -dv;
+    }
+    dda->den = dt;
+    dda->step_num = dv;
+    dda->step_quot = Floor_Div(dv, dt);
+    dda->step_rem = dv - dda->step_quot * dt;
+    dda->num = (t - t1) * dv;
+    dda->quot = Floor_Div(dda->num, dt);
+    dda->rem = dda->num - dda->quot * dt;
+}
+
+/**
+ * @brief 自变量加1
+ */
+static inline void Line_DDA_Step(Line_DDA *dda)
+{
+    dda->num += dda->step_num;
+    dda->quot += dda->step_quot;
+    dda->rem += dda->step_rem;
+    if (dda->rem >= dda->den)
+    {
+        dda->rem -= dda->den;
+        dda->quot++;
     }
 }
 
+/**
+ * @brief 当前坐标（商向零取整，与 v1 + (t - t1) * dv / dt 相同）
+ */
+static inline int Line_DDA_Trunc(const Line_DDA *dda)
+{
+    return dda->base + dda->quot + (dda->num < 0 && dda->rem != 0);
+}
+
+/**
+ * @brief 当前坐标（商向下取整）
+ */
+static inline int Line_DDA_Floor(const Line_DDA *dda)
+{
+    return dda->base + dda->quot;
+}
+
 /**
  * @brief 添加左边界线段
  * @param x1 起点X坐标
  * @param y1 起点Y坐标
  * @param x2 终点X坐标
  * @param y2 终点Y坐标
- * @note 使用线性插值在两点间连接左边界
+ * @note 使用线性插值在两点间连接左边界，两点在同一行时只写该行
  */
 void Left_Add_Line(int x1, int y1, int x2, int y2)
 {
     int i, max, a1, a2;
     int hx;
+    Line_DDA dda;
 
     // 边界检查
     if (x1 >= MT9V03X_W - 1)
@@ -292,15 +906,17 @@ void Left_Add_Line(int x1, int y1, int x2, int y2)
         a2 = max;
     }
 
-    // 线性插值连接边界
+    // 线性插值连接边界（增量计算，y1 == y2时只写该行）
+    Line_DDA_Init(&dda, x1, y1, x2, y2, a1);
     for (i = a1; i <= a2; i++)
     {
-        hx = (i - y1) * (x2 - x1) / (y2 - y1) + x1;
+        hx = Line_DDA_Trunc(&dda);
         if (hx >= MT9V03X_W)
             hx = MT9V03X_W;
         else if (hx <= 0)
             hx = 0;
         Left_Line[i] = hx;
+        Line_DDA_Step(&dda);
     }
 }
 
@@ -310,12 +926,13 @@ void Left_Add_Line(int x1, int y1, int x2, int y2)
  * @param y1 起点Y坐标
  * @param x2 终点X坐标
  * @param y2 终点Y坐标
- * @note 使用线性插值在两点间连接右边界
+ * @note 使用线性插值在两点间连接右边界，两点在同一行时只写该行
  */
 void Right_Add_Line(int x1, int y1, int x2, int y2)
 {
     int i, max, a1, a2;
     int hx;
+    Line_DDA dda;
 
     // 边界检查
     if (x1 >= MT9V03X_W - 1)
@@ -345,15 +962,17 @@ void Right_Add_Line(int x1, int y1, int x2, int y2)
         a2 = max;
     }
 
-    // 线性插值连接边界
+    // 线性插值连接边界（增量计算，y1 == y2时只写该行）
+    Line_DDA_Init(&dda, x1, y1, x2, y2, a1);
     for (i = a1; i <= a2; i++)
     {
-        hx = (i - y1) * (x2 - x1) / (y2 - y1) + x1;
+        hx = Line_DDA_Trunc(&dda);
         if (hx >= MT9V03X_W)
             hx = MT9V03X_W;
         else if (hx <= 0)
             hx = 0;
         Right_Line[i] = hx;
+        Line_DDA_Step(&dda);
     }
 }
 
@@ -480,8 +1099,8 @@ void Find_Up_Point(int start, int end)
         }
     }
 
-    // 如果左右上拐点位置差距过大，认为检测无效
-    if (abs(Right_Up_Find - Left_Up_Find) >= 30)
+    // 如果左右上拐点都找到但位置差距过大，认为检测无效（只找到单侧拐点时保留，供环岛识别使用）
+    if (Left_Up_Find != 0 && Right_Up_Find != 0 && abs(Right_Up_Find - Left_Up_Find) >= 30)
     {
         Right_Up_Find = 0;
         Left_Up_Find = 0;
@@ -496,8 +1115,8 @@ void Find_Up_Point(int start, int end)
  */
 void Lengthen_Left_Boundry(int start, int end)
 {
-    int i, t;
-    float k = 0;
+    int i, t, x;
+    Line_DDA dda;
 
     // 边界检查
     if (start >= MT9V03X_H - 1)
@@ -522,13 +1141,21 @@ void Lengthen_Left_Boundry(int start, int end)
     {
         Left_Add_Line(Left_Line[start], start, Left_Line[end], end);
     }
-    // 否则根据斜率延长
+    // 否则根据斜率延长（斜率为start-4行到start行的变化量/5，按向下取整增量计算，不做浮点运算）
     else
     {
-        k = (float)(Left_Line[start] - Left_Line[start - 4]) / 5.0;
+        // 起点先按输出范围限幅，后续各行以限幅后的起点为基准
+        t = Left_Line[start] - Left_Line[start - 4];
+        x = Left_Line[start];
+        if (x >= MT9V03X_W - 1)
+            x = MT9V03X_W - 1;
+        else if (x <= 0)
+            x = 0;
+        Line_DDA_Init(&dda, x, start, x + t, start + 5, start);
         for (i = start; i <= end; i++)
         {
-            Left_Line[i] = (int)(i - start) * k + Left_Line[start];
+            Left_Line[i] = Line_DDA_Floor(&dda);
+            Line_DDA_Step(&dda);
             if (Left_Line[i] >= MT9V03X_W - 1)
             {
                 Left_Line[i] = MT9V03X_W - 1;
@@ -549,8 +1176,8 @@ void Lengthen_Left_Boundry(int start, int end)
  */
 void Lengthen_Right_Boundry(int start, int end)
 {
-    int i, t;
-    float k = 0;
+    int i, t, x;
+    Line_DDA dda;
 
     // 边界检查
     if (start >= MT9V03X_H - 1)
@@ -575,13 +1202,21 @@ void Lengthen_Right_Boundry(int start, int end)
     {
         Right_Add_Line(Right_Line[start], start, Right_Line[end], end);
     }
-    // 否则根据斜率延长
+    // 否则根据斜率延长（斜率为start-4行到start行的变化量/5，按向下取整增量计算，不做浮点运算）
     else
     {
-        k = (float)(Right_Line[start] - Right_Line[start - 4]) / 5.0;
+        // 起点先按输出范围限幅，后续各行以限幅后的起点为基准
+        t = Right_Line[start] - Right_Line[start - 4];
+        x = Right_Line[start];
+        if (x >= MT9V03X_W - 1)
+            x = MT9V03X_W - 1;
+        else if (x <= 0)
+            x = 0;
+        Line_DDA_Init(&dda, x, start, x + t, start + 5, start);
         for (i = start; i <= end; i++)
         {
-            Right_Line[i] = (int)(i - start) * k + Right_Line[start];
+            Right_Line[i] = Line_DDA_Floor(&dda);
+            Line_DDA_Step(&dda);
             if (Right_Line[i] >= MT9V03X_W - 1)
             {
                 Right_Line[i] = MT9V03X_W - 1;
@@ -597,74 +1232,71 @@ void Lengthen_Right_Boundry(int start, int end)
 /**
  * @brief 十字路口检测
  * @note 通过检测上下拐点判断是否为十字路口，并修补边界
+ *       环岛、坡道状态下由元素调度器跳过（见element.c）
  */
 void Cross_Detect()
 {
     int down_search_start = 0;
     Cross_Flag = 0;
 
-    // 环岛和坡道状态下不检测十字路口
-    if (Island_State == 0 && Ramp_Flag == 0)
-    {
-        Left_Up_Find = 0;
-        Right_Up_Find = 0;
+    Left_Up_Find = 0;
+    Right_Up_Find = 0;
 
-        // 如果双边界丢失较多，尝试搜索上拐点
-        if (Both_Lost_Time >= 10)
+    // 如果双边界丢失较多，尝试搜索上拐点
+    if (Both_Lost_Time >= 10)
+    {
+        Find_Up_Point(MT9V03X_H - 1, 0);
+        if (Left_Up_Find == 0 && Right_Up_Find == 0)
         {
-            Find_Up_Point(MT9V03X_H - 1, 0);
-            if (Left_Up_Find == 0 && Right_Up_Find == 0)
-            {
-                return;
-            }
+            return;
         }
+    }
 
-        // 如果找到左右上拐点，判定为十字路口
-        if (Left_Up_Find != 0 && Right_Up_Find != 0)
-        {
-            Cross_Flag = 1;
-            down_search_start = Left_Up_Find > Right_Up_Find ? Left_Up_Find : Right_Up_Find;
+    // 如果找到左右上拐点，判定为十字路口
+    if (Left_Up_Find != 0 && Right_Up_Find != 0)
+    {
+        Cross_Flag = 1;
+        down_search_start = Left_Up_Find > Right_Up_Find ? Left_Up_Find : Right_Up_Find;
 
-            // 搜索下拐点
-            Find_Down_Point(MT9V03X_H - 5, down_search_start + 2);
+        // 搜索下拐点
+        Find_Down_Point(MT9V03X_H - 5, down_search_start + 2);
 
-            // 确保下拐点在上拐点下方
-            if (Left_Down_Find <= Left_Up_Find)
-            {
-                Left_Down_Find = 0;
-            }
-            if (Right_Down_Find <= Right_Up_Find)
-            {
-                Right_Down_Find = 0;
-            }
+        // 确保下拐点在上拐点下方
+        if (Left_Down_Find <= Left_Up_Find)
+        {
+            Left_Down_Find = 0;
+        }
+        if (Right_Down_Find <= Right_Up_Find)
+        {
+            Right_Down_Find = 0;
+        }
 
-            // 根据找到的拐点情况修补边界
-            if (Left_Down_Find != 0 && Right_Down_Find != 0)
-            {
-                Left_Add_Line(Left_Line[Left_Up_Find], Left_Up_Find, Left_Line[Left_Down_Find], Left_Down_Find);
-                Right_Add_Line(Right_Line[Right_Up_Find], Right_Up_Find, Right_Line[Right_Down_Find], Right_Down_Find);
-            }
-            else if (Left_Down_Find == 0 && Right_Down_Find != 0)
-            {
-                Lengthen_Left_Boundry(Left_Up_Find - 1, MT9V03X_H - 1);
-                Right_Add_Line(Right_Line[Right_Up_Find], Right_Up_Find, Right_Line[Right_Down_Find], Right_Down_Find);
-            }
-            else if (Left_Down_Find != 0 && Right_Down_Find == 0)
-            {
-                Left_Add_Line(Left_Line[Left_Up_Find], Left_Up_Find, Left_Line[Left_Down_Find], Left_Down_Find);
-                Lengthen_Right_Boundry(Right_Up_Find - 1, MT9V03X_H - 1);
-            }
-            else if (Left_Down_Find == 0 && Right_Down_Find == 0)
-            {
-                Lengthen_Left_Boundry(Left_Up_Find - 1, MT9V03X_H - 1);
-                Lengthen_Right_Boundry(Right_Up_Find - 1, MT9V03X_H - 1);
-            }
+        // 根据找到的拐点情况修补边界
+        if (Left_Down_Find != 0 && Right_Down_Find != 0)
+        {
+            Left_Add_Line(Left_Line[Left_Up_Find], Left_Up_Find, Left_Line[Left_Down_Find], Left_Down_Find);
+            Right_Add_Line(Right_Line[Right_Up_Find], Right_Up_Find, Right_Line[Right_Down_Find], Right_Down_Find);
         }
-        else
+        else if (Left_Down_Find == 0 && Right_Down_Find != 0)
+        {
+            Lengthen_Left_Boundry(Left_Up_Find - 1, MT9V03X_H - 1);
+            Right_Add_Line(Right_Line[Right_Up_Find], Right_Up_Find, Right_Line[Right_Down_Find], Right_Down_Find);
+        }
+        else if (Left_Down_Find != 0 && Right_Down_Find == 0)
+        {
+            Left_Add_Line(Left_Line[Left_Up_Find], Left_Up_Find, Left_Line[Left_Down_Find], Left_Down_Find);
+            Lengthen_Right_Boundry(Right_Up_Find - 1, MT9V03X_H - 1);
+        }
+        else if (Left_Down_Find == 0 && Right_Down_Find == 0)
         {
-            Cross_Flag = 0;
+            Lengthen_Left_Boundry(Left_Up_Find - 1, MT9V03X_H - 1);
+            Lengthen_Right_Boundry(Right_Up_Find - 1, MT9V03X_H - 1);
         }
     }
+    else
+    {
+        Cross_Flag = 0;
+    }
 }
 
 /**
@@ -673,12 +1305,13 @@ void Cross_Detect()
  * @param startY 起点Y坐标
  * @param endX 终点X坐标
  * @param endY 终点Y坐标
- * @note 用于在图像上绘制辅助线
+ * @note 用于在图像上绘制辅助线，斜线按Y、X两个方向各增量计算一遍
  */
 void Draw_Line(int startX, int startY, int endX, int endY)
 {
     int i, x, y;
     int start = 0, end = 0;
+    Line_DDA dda;
 
     // 边界检查
     if (startX >= MT9V03X_W - 1)
@@ -706,12 +1339,17 @@ void Draw_Line(int startX, int startY, int endX, int endY)
             start = endY;
             end = startY;
         }
+        else
+        {
+            start = startY;
+            end = endY;
+        }
         for (i = start; i <= end; i++)
         {
             if (i <= 1)
                 i = 1;
-            binaryImage[i][startX] = IMG_BLACK;
-            binaryImage[i - 1][startX] = IMG_BLACK;
+            BINARY_SET_BLACK(i, startX);
+            BINARY_SET_BLACK(i - 1, startX);
         }
     }
     // 水平线
@@ -722,12 +1360,17 @@ void Draw_Line(int startX, int startY, int endX, int endY)
             start = endX;
             end = startX;
         }
+        else
+        {
+            start = startX;
+            end = endX;
+        }
         for (i = start; i <= end; i++)
         {
             if (startY <= 1)
                 startY = 1;
-            binaryImage[startY][i] = IMG_BLACK;
-            binaryImage[startY - 1][i] = IMG_BLACK;
+            BINARY_SET_BLACK(startY, i);
+            BINARY_SET_BLACK(startY - 1, i);
         }
     }
     // 斜线
@@ -744,15 +1387,17 @@ void Draw_Line(int startX, int startY, int endX, int endY)
             start = startY;
             end = endY;
         }
+        Line_DDA_Init(&dda, startX, startY, endX, endY, start);
         for (i = start; i <= end; i++)
         {
-            x = (int)(startX + (endX - startX) * (i - startY) / (endY - startY));
+            x = Line_DDA_Trunc(&dda);
+            Line_DDA_Step(&dda);
             if (x >= MT9V03X_W - 1)
                 x = MT9V03X_W - 1;
             else if (x <= 1)
                 x = 1;
-            binaryImage[i][x] = IMG_BLACK;
-            binaryImage[i][x - 1] = IMG_BLACK;
+            BINARY_SET_BLACK(i, x);
+            BINARY_SET_BLACK(i, x - 1);
         }
 
         // 按X方向绘制
@@ -766,14 +1411,16 @@ void Draw_Line(int startX, int startY, int endX, int endY)
             start = startX;
             end = endX;
         }
+        Line_DDA_Init(&dda, startY, startX, endY, endX, start);
         for (i = start; i <= end; i++)
         {
-            y = (int)(startY + (endY - startY) * (i - startX) / (endX - startX));
+            y = Line_DDA_Trunc(&dda);
+            Line_DDA_Step(&dda);
             if (y >= MT9V03X_H - 1)
                 y = MT9V03X_H - 1;
             else if (y <= 0)
                 y = 0;
-            binaryImage[y][i] = IMG_BLACK;
+            BINARY_SET_BLACK(y, i);
         }
     }
 }
@@ -795,6 +1442,13 @@ int Zebra_Detect(void)
         // 扫描图像底部几行
         for (int i = IMAGE_HEIGHT - 1; i >= IMAGE_HEIGHT - 3; i--)
         {
+#if IMAGE_PACKED_BINARY
+            // 按字计算白黑跳变候选位并用POPCNT计数
+            for (int w = 0; w < BINARY_PACKED_WORDS; w++)
+            {
+                zebra_count += bit_popcount32(Packed_Right_Edge_Word(binaryPacked[i], w) & packed_range_mask(w, 20, IMAGE_WIDTH - 1 - 20));
+            }
+#else
             for (int j = 20; j <= IMAGE_WIDTH - 1 - 20; j++)
             {
                 // 统计白黑跳变次数
@@ -803,6 +1457,7 @@ int Zebra_Detect(void)
                     zebra_count++;
                 }
             }
+#endif
 
             // 跳变次数超过阈值，判定为斑马线
             if (zebra_count >= 10)
@@ -817,6 +1472,7 @@ int Zebra_Detect(void)
 /**
  * @brief 坡道检测
  * @note 通过赛道宽度变化和编码器变化判断坡道状态
+ *       十字路口、环岛状态下由元素调度器跳过（见element.c）
  */
 void Ramp_Detect(void)
 {
@@ -824,18 +1480,16 @@ void Ramp_Detect(void)
     int i = 0;
     int count = 0;
 
-    // 十字路口或环岛状态下不检测坡道
-    if (Cross_Flag != 0 || Island_State != 0)
-    {
-        return;
-    }
-
     // 检测赛道宽度是否超过标准宽度（坡道特征）
     if (Search_Stop_Line >= 66)
     {
         for (i = MT9V03X_H - 1; i > MT9V03X_H - Search_Stop_Line; i--)
         {
+#if IMAGE_IPM_METRIC
+            if (Road_Wide[i] * ipm_row_lateral[i] > IPM_TRACK_WIDTH_MM + Ramp_offset)
+#else
             if (Road_Wide[i] > Road_Standard_Wide[i] + Ramp_offset)
+#endif
             {
                 count++;
             }
@@ -905,6 +1559,21 @@ float err_sum_average(uint8 start_point, uint8 end_point)
     if (end_point < MT9V03X_H - Search_Stop_Line)
         end_point = MT9V03X_H - Search_Stop_Line - 2;
 
+#if IMAGE_IPM_METRIC
+    // 按每行覆盖的地面长度加权平均横向偏差（mm），远处行不再因透视压缩而失真
+    float err = 0;
+    float weight = 0;
+    for (int i = start_point; i <= end_point; i++)
+    {
+        err += (MT9V03X_W / 2 - ((Left_Line[i] + Right_Line[i]) >> 1)) * ipm_row_lateral[i] * ipm_row_weight[i];
+        weight += ipm_row_weight[i];
+    }
+    if (weight <= 0 || ipm_row_lateral[(start_point + end_point) >> 1] <= 0)
+        return 0;
+
+    // 按采样段中间行的横向比例折算回像素，保持与原转向PID参数相同的量级
+    return err / weight / ipm_row_lateral[(start_point + end_point) >> 1];
+#else
     // 计算偏差累加值
     float err = 0;
     for (int i = start_point; i <= end_point; i++)
@@ -912,9 +1581,14 @@ float err_sum_average(uint8 start_point, uint8 end_point)
         err += (MT9V03X_W / 2 - ((Left_Line[i] + Right_Line[i]) >> 1));
     }
 
+    // 采样段整段位于搜索停止行之上时边界检查后start_point > end_point，没有有效行
+    if (end_point < start_point)
+        return 0;
+
     // 计算平均偏差
     err = err / (end_point - start_point + 1);
     return err;
+#endif
 }
 
 /**
@@ -925,8 +1599,8 @@ float err_sum_average(uint8 start_point, uint8 end_point)
  */
 uint8 image_out_of_bounds(uint8 binaryImage[IMAGE_HEIGHT][IMAGE_WIDTH])
 {
-    // 如果检测到斑马线，不判定为出界
-    if (Zebra_Detect())
+    // 如果本帧检测到斑马线（由元素调度器更新），不判定为出界
+    if (Zebra_Stripes_Flag)
     {
         return 0;
     }
@@ -937,7 +1611,7 @@ uint8 image_out_of_bounds(uint8 binaryImage[IMAGE_HEIGHT][IMAGE_WIDTH])
     {
         for (int j = 0; j < 2; j++)
         {
-            sum += image_copy[IMAGE_HEIGHT - 1 - j][IMAGE_WIDTH / 2 - 5 + i];
+            sum += image_gray[IMAGE_HEIGHT - 1 - j][IMAGE_WIDTH / 2 - 5 + i];
         }
     }
 
@@ -956,24 +1630,151 @@ uint8 image_out_of_bounds(uint8 binaryImage[IMAGE_HEIGHT][IMAGE_WIDTH])
 }
 
 /**
- * @brief 图像处理主函数
- * @note 集成边界提取和元素识别的主函数
- *       包括：图像复制、大津法二值化、边界搜索、元素检测等
+ * @brief 二值化第i行并标记为有效
  */
-void image_process(void)
+void Binary_Row_Fill(int i)
 {
-    // 0. 复制图像数据并进行大津法二值化
-    memcpy(image_copy, mt9v03x_image, MT9V03X_H * MT9V03X_W);
-    threshold = otsu_get_threshold((uint8 *)image_copy, MT9V03X_W, MT9V03X_H);
-    applyThreshold(image_copy, binaryImage, threshold);
+#if IMAGE_PACKED_BINARY
+    applyThresholdPackedRow(image_gray[i], binaryPacked[i], threshold);
+#else
+    applyThresholdRow(image_gray[i], binaryImage[i], threshold);
+#endif
+#if IMAGE_LAZY_BINARY
+    binary_row_valid[i >> 5] |= 1u << (i & 31);
+    binary_row_count++;
+#endif
+}
+
+#if IMAGE_LAZY_BINARY
+/**
+ * @brief 按需二值化：清除行有效标记，预先二值化上一帧搜索停止行以下的区域
+ * @note 其余行由Binary_Row_Ready()在读取时补做
+ */
+static void Binary_Lazy_Begin(void)
+{
+    int i, top;
+
+    memset(binary_row_valid, 0, sizeof(binary_row_valid));
+    binary_row_count = 0;
+
+    // 自适应阈值的窗口和需要自上而下逐行滚动，整幅处理
+    if (adaptive_threshold_enable)
+    {
+#if IMAGE_PACKED_BINARY
+        applyAdaptiveThresholdPacked(image_gray, binaryPacked, threshold, (int)adaptive_threshold_offset, (int)adaptive_threshold_margin);
+#else
+        applyAdaptiveThreshold(image_gray, binaryImage, threshold, (int)adaptive_threshold_offset, (int)adaptive_threshold_margin);
+#endif
+        memset(binary_row_valid, 0xFF, sizeof(binary_row_valid));
+        binary_row_count = MT9V03X_H;
+        return;
+    }
+
+    // 此时Search_Stop_Line仍为上一帧的结果
+    top = MT9V03X_H - Search_Stop_Line - IMAGE_LAZY_ROW_MARGIN;
+    if (top < 0)
+        top = 0;
+    if (top > MT9V03X_H - IMAGE_LAZY_ROW_MARGIN)
+        top = MT9V03X_H - IMAGE_LAZY_ROW_MARGIN;
+    for (i = MT9V03X_H - 1; i >= top; i--)
+        Binary_Row_Fill(i);
+}
+#endif
+
+/**
+ * @brief 处理一帧灰度图像
+ * @param src 灰度图像（IMAGE_HEIGHT x IMAGE_WIDTH）
+ * @param dst 图像副本缓冲区，NULL表示直接处理src（处理期间src不得被改写）
+ * @note 不访问摄像头驱动，上位机回放录制的图像时直接调用本函数
+ *       包括：图像复制（同步统计直方图）、大津法二值化、边界搜索、元素检测、中线拟合
+ */
+void image_process_frame(uint8 *src, uint8 *dst)
+{
+    // 0. 复制图像并同步统计直方图，再用大津法阈值二值化（共两遍遍历）
+    uint32 stamp_start = latency_now();
+    uint32 stamp_binarize, stamp_boundary;
+    uint32 gray_sum = image_copy_histogram(src, dst, gray_histogram);
+
+    image_gray = (uint8 (*)[IMAGE_WIDTH])((dst != NULL) ? dst : src);
+    threshold = otsu_threshold_from_histogram(gray_histogram, OTSU_SAMPLE_COUNT, gray_sum);
+#if IMAGE_LAZY_BINARY
+    Binary_Lazy_Begin();
+#elif IMAGE_PACKED_BINARY
+    if (adaptive_threshold_enable)
+        applyAdaptiveThresholdPacked(image_gray, binaryPacked, threshold, (int)adaptive_threshold_offset, (int)adaptive_threshold_margin);
+    else
+        applyThresholdPacked(image_gray, binaryPacked, threshold);
+#else
+    if (adaptive_threshold_enable)
+        applyAdaptiveThreshold(image_gray, binaryImage, threshold, (int)adaptive_threshold_offset, (int)adaptive_threshold_margin);
+    else
+        applyThreshold(image_gray, binaryImage, threshold);
+#endif
+#if IMAGE_PYRAMID
+    Pyramid_Build();
+#endif
+    stamp_binarize = latency_now();
+    latency_record(LATENCY_BINARIZE, stamp_start, stamp_binarize);
 
     // 1. 双边巡线 - 提取左右边界
     Longest_White_Column();
+    stamp_boundary = latency_now();
+    latency_record(LATENCY_BOUNDARY, stamp_binarize, stamp_boundary);
+
+    // 2. 赛道元素检测（按当前赛道状态调度十字、坡道、斑马线等检测器）
+    element_schedule();
 
-    // 2. 赛道元素检测
-    Cross_Detect();  // 十字路口检测
-    Ramp_Detect();   // 坡道检测
+    // 边界换算为地面坐标（补线之后进行），再拟合中线求前瞻点
+    ipm_convert_lines(MT9V03X_H - Search_Stop_Line);
+    centerline_update(MT9V03X_H - Search_Stop_Line, (float)encoder[1]);
+    latency_record(LATENCY_ELEMENT, stamp_boundary, latency_now());
 
     // 3. 设置图像处理完成标志
     image_proess = 1;
 }
+
+/**
+ * @brief 从摄像头取得最新一帧并处理
+ * @param only_fresh 1=没有新帧时不处理直接返回，0=没有新帧时重新处理上一帧（菜单显示页面）
+ * @return 1=取得了新帧，0=没有新帧
+ * @note 帧号image_frame_id与新帧标志由采集驱动随帧一起返回，与所处理的图像一致
+ *       三缓冲采集或IMAGE_DIRECT_DMA_BUFFER为1时跳过复制，直接处理采集缓冲区
+ */
+uint8 image_process_latest(uint8 only_fresh)
+{
+    uint32 stamp_start = latency_now();
+    uint8 fresh;
+    // 三缓冲采集：取得最新完整帧的所有权，处理期间DMA不会写入该帧，无需复制
+    uint8 *src = mt9v03x_frame_acquire(&image_frame_id, &fresh);
+#if MT9V03X_FRAME_BUFFER_NUM > 1 || IMAGE_DIRECT_DMA_BUFFER
+    uint8 *dst = NULL;
+#else
+    uint8 *dst = image_copy[0];
+#endif
+
+    if (only_fresh && !fresh)
+        return 0;
+
+    // 同一帧重复处理（菜单显示页面）时采集与等待阶段只记录一次
+    if (mt9v03x_frame_vsync_stamp != image_frame_stamp)
+    {
+        image_frame_stamp = mt9v03x_frame_vsync_stamp;
+        latency_record(LATENCY_CAPTURE, mt9v03x_frame_vsync_stamp, mt9v03x_frame_done_stamp);
+        latency_record(LATENCY_QUEUE, mt9v03x_frame_done_stamp, stamp_start);
+    }
+
+    image_process_frame(src, dst);
+
+    // 自动曝光复用本帧直方图，曝光命令异步发送
+    auto_exposure_update(gray_histogram, OTSU_SAMPLE_COUNT);
+    return fresh;
+}
+
+/**
+ * @brief 图像处理主函数
+ * @note 处理最新一帧，没有新帧时重新处理上一帧
+ */
+void image_process(void)
+{
+    image_process_latest(0);
+}
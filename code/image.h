@@ -23,18 +23,102 @@
 #define TURN_STANDARD_START turn_start  // 转弯检测起始行
 #define TURN_STANDARD_END turn_end      // 转弯检测结束行
 
+// 以下编译开关均可在编译命令行上用 -D名称=值 覆盖（主机回放按不同配置构建，见replay/check.sh）
+// 图像流水线配置（仅MT9V03X_FRAME_BUFFER_NUM为1的单缓冲采集时有效，三缓冲采集始终直接处理所持有的帧）
+// 0：先复制到image_copy再处理（处理期间DMA覆盖缓冲区也不影响）
+// 1：直接在DMA缓冲区mt9v03x_image上统计直方图和二值化，省去整帧复制
+#ifndef IMAGE_DIRECT_DMA_BUFFER
+#define IMAGE_DIRECT_DMA_BUFFER 0
+#endif
+// 0：二值图按字节存储于binaryImage（默认）
+// 1：二值图按位压缩存储于binaryPacked，最长白列、边界搜索和斑马线检测按32位字处理
+//    （此时不分配binaryImage，省去22.5KB；Show_Boundry/Draw_Line的调试叠加直接画在binaryPacked上）
+#ifndef IMAGE_PACKED_BINARY
+#define IMAGE_PACKED_BINARY 0
+#endif
+// 0：每帧整幅二值化
+// 1：按需二值化。先只二值化上一帧搜索停止行以下的区域（再向上多留IMAGE_LAZY_ROW_MARGIN行），
+//    白列统计或轮廓跟踪向上越出该区域时逐行补做；binary_row_valid按行记录本帧已二值化的行，
+//    读取二值图前用Binary_Row_Ready()保证该行有效，不会读到上一帧的旧数据。
+//    边界搜索只使用白列统计已经走过的行，无需检查；自适应阈值需要逐行滚动窗口，开启时仍整幅二值化
+#ifndef IMAGE_LAZY_BINARY
+#define IMAGE_LAZY_BINARY 0
+#endif
+#define IMAGE_LAZY_ROW_MARGIN 8          // 按需二值化预先处理的区域在上一帧搜索停止行之上多留的行数
+#define BINARY_ROW_VALID_WORDS ((MT9V03X_H + 31) / 32)
+// 0：所有行在全分辨率二值图上搜索边界
+// 1：远场金字塔。第0 ~ IMAGE_PYRAMID_ROWS-1行（远处，每像素覆盖的地面大、噪点多）按2x2均值降采样为
+//    半分辨率二值图binary_half，这些行的边界在半分辨率图上搜索（点数为1/4，均值同时抑制噪点），
+//    结果换算回全分辨率列号（左边界取半分辨率像素的左列，右边界取右列）；近场行不受影响。
+//    仅用于逐行扫描边界搜索，远场行不做帧间跟踪；半分辨率图使用全局阈值
+#ifndef IMAGE_PYRAMID
+#define IMAGE_PYRAMID 0
+#endif
+#define IMAGE_PYRAMID_ROWS 40            // 远场行数（须为偶数）
+#define IMAGE_HALF_WIDTH (IMAGE_WIDTH / 2)
+#define IMAGE_PYRAMID_FAR(i) (IMAGE_PYRAMID && (i) < IMAGE_PYRAMID_ROWS)
+// 0：每帧全图统计白列、从最长白列向两侧搜索边界
+// 1：帧间边界跟踪。上一帧结果可信时，只在上一帧最长白列附近统计白列，
+//    每行边界先在上一帧边界附近的窗口内搜索，窗口内找不到时该行退回全行搜索；
+//    跟踪成功的行数不足一半、搜索停止行突降或处于元素状态时退回全图搜索
+#ifndef IMAGE_BOUNDARY_TRACKING
+#define IMAGE_BOUNDARY_TRACKING 0
+#endif
+#define IMAGE_TRACK_EDGE_WINDOW 6        // 边界跟踪窗口半宽（列）
+#define IMAGE_TRACK_COLUMN_WINDOW 12     // 最长白列跟踪窗口半宽（列）
+#define IMAGE_TRACK_STOP_LINE_DROP 10    // 搜索停止行比上一帧减少超过该值时认为跟踪丢失
+// 0：逐行扫描提取边界（从最长白列向左右扫描）
+// 1：八邻域轮廓跟踪（迷宫法）提取边界，同时输出有序轮廓点列contour_left/contour_right（见contour.h），
+//    急弯和十字处接近水平的边界也能连续跟踪；逐行边界数组由轮廓换算，元素检测照常使用
+#ifndef IMAGE_CONTOUR_ENGINE
+#define IMAGE_CONTOUR_ENGINE 0
+#endif
+
+// 0：转向误差为采样行像素偏差的直接平均，坡道按Road_Standard_Wide[]像素宽度判断
+// 1：按逆透视查找表（见ipm.h）换算为地面距离：转向误差按每行覆盖的地面长度加权平均横向偏差，
+//    再按采样段中间行的横向比例折算回像素量级，原转向PID参数仍可用；坡道按赛道实际宽度（mm）判断，
+//    此时Ramp_offset单位为mm；环岛补线的标准宽度取查找表生成的ipm_standard_width[]
+#ifndef IMAGE_IPM_METRIC
+#define IMAGE_IPM_METRIC 0
+#endif
+
+// 第i行标准赛道宽度（像素），元素补线按此推算丢线一侧的边界
+#if IMAGE_IPM_METRIC
+#define ROAD_STANDARD_WIDTH(i) (ipm_standard_width[i])
+#else
+#define ROAD_STANDARD_WIDTH(i) (Road_Standard_Wide[i])
+#endif
+
+#if IMAGE_CONTOUR_ENGINE && IMAGE_BOUNDARY_TRACKING
+#error "IMAGE_BOUNDARY_TRACKING only applies to the row-scan engine, disable it when IMAGE_CONTOUR_ENGINE is 1"
+#endif
+#if IMAGE_CONTOUR_ENGINE && IMAGE_PYRAMID
+#error "IMAGE_PYRAMID only applies to the row-scan engine, disable it when IMAGE_CONTOUR_ENGINE is 1"
+#endif
+#if IMAGE_PYRAMID_ROWS % 2
+#error "IMAGE_PYRAMID_ROWS must be even"
+#endif
+
 //============================================================
 // 全局变量声明
 //============================================================
 
 // -------------------- 图像处理基本参数 --------------------
 extern int threshold;           // 全局二值化阈值
+extern uint32 adaptive_threshold_enable; // 自适应阈值开关（见Image Binarization.h）
+extern uint32 adaptive_threshold_offset; // 自适应阈值偏移量
+extern uint32 adaptive_threshold_margin; // 自适应阈值相对全局阈值的最大偏离
 extern uint8 image_proess;      // 图像处理标志
 extern int turn_start;          // 转弯检测起始行
 extern int turn_end;            // 转弯检测结束行
 
 // -------------------- 图像数据 --------------------
-extern uint8 image_copy[IMAGE_HEIGHT][IMAGE_WIDTH];  // 图像副本数组
+#if MT9V03X_FRAME_BUFFER_NUM == 1
+extern uint8 image_copy[IMAGE_HEIGHT][IMAGE_WIDTH];  // 图像副本数组（仅单缓冲采集时使用）
+#endif
+extern uint8 (*image_gray)[IMAGE_WIDTH];             // 本帧处理所用的灰度图（image_copy或mt9v03x_image）
+extern uint32 image_frame_stamp;                     // 本帧场同步时刻（STM0计数，用于延迟统计）
+extern uint32 image_frame_id;                        // 本帧帧号（采集驱动随帧交接，与image_gray一致）
 extern volatile int Left_Line[MT9V03X_H];            // 左边界数组
 extern volatile int Right_Line[MT9V03X_H];           // 右边界数组
 extern const uint8 Road_Standard_Wide[MT9V03X_H];    // 赛道标准宽度数组
@@ -44,7 +128,8 @@ extern volatile int Cross_Flag;         // 十字路口检测标志
 extern volatile int Island_State;       // 环岛状态标志
 extern volatile int Ramp_Flag;          // 坡道检测标志
 extern int Ramp_offset;                 // 坡道偏移量
-extern volatile int circle_flag;        // 环岛标志（0=无环岛，非0=有环岛）
+extern volatile int circle_flag;        // 环岛标志（0=无环岛，1=左环岛，2=右环岛，见island.h）
+extern volatile int left_circle_flag;   // 左环岛标志（0/1/2/3不同状态）
 extern volatile int right_circle_flag;  // 右环岛标志（0/1/2/3不同状态）
 extern volatile int Zebra_Stripes_Flag; // 斑马线标志位
 
@@ -52,6 +137,16 @@ extern volatile int Zebra_Stripes_Flag; // 斑马线标志位
 extern volatile int Search_Stop_Line;           // 边界搜索停止行
 extern int Longest_White_Column_Left[2];        // 左侧最长白列：[0]长度，[1]列号
 extern int Longest_White_Column_Right[2];       // 右侧最长白列：[0]长度，[1]列号
+#if IMAGE_BOUNDARY_TRACKING
+extern int Boundary_Track_Rows;                 // 本帧在跟踪窗口内找到边界的行数（0表示本帧为全图搜索）
+#endif
+#if IMAGE_PYRAMID
+extern uint8 binary_half[IMAGE_PYRAMID_ROWS / 2][IMAGE_HALF_WIDTH]; // 远场半分辨率二值图（255=白，0=黑）
+#endif
+#if IMAGE_LAZY_BINARY
+extern uint32 binary_row_valid[BINARY_ROW_VALID_WORDS]; // 本帧已二值化的行（第i行对应第i/32个字的第i%32位）
+extern int binary_row_count;                    // 本帧已二值化的行数
+#endif
 
 // -------------------- 编码器相关变量 --------------------
 extern int Encoder_Left;  // 左编码器累计值
@@ -61,6 +156,27 @@ extern int encoder_sum;   // 编码器总和
 // 函数声明
 //============================================================
 
+// -------------------- 按需二值化 --------------------
+/**
+ * @brief 二值化第i行并标记为有效
+ * @param i 行号
+ */
+void Binary_Row_Fill(int i);
+
+/**
+ * @brief 保证第i行已二值化（IMAGE_LAZY_BINARY为0时为空）
+ * @param i 行号
+ */
+static inline void Binary_Row_Ready(int i)
+{
+#if IMAGE_LAZY_BINARY
+    if (!(binary_row_valid[i >> 5] & (1u << (i & 31))))
+        Binary_Row_Fill(i);
+#else
+    (void)i;
+#endif
+}
+
 // -------------------- 赛道元素检测函数 --------------------
 /**
  * @brief 最长白列检测
@@ -166,10 +282,26 @@ float err_sum_average(uint8 start_point, uint8 end_point);
 uint8 image_out_of_bounds(uint8 binaryImage[IMAGE_HEIGHT][IMAGE_WIDTH]);
 
 // -------------------- 总图像处理函数 --------------------
+/**
+ * @brief 处理一帧灰度图像
+ * @param src 灰度图像（IMAGE_HEIGHT x IMAGE_WIDTH）
+ * @param dst 图像副本缓冲区，NULL表示直接处理src
+ * @note 不访问摄像头驱动，可在上位机上回放录制的图像（见frame_log.h）
+ */
+void image_process_frame(uint8 *src, uint8 *dst);
+
+/**
+ * @brief 从摄像头取得最新一帧并处理
+ * @param only_fresh 1=没有新帧时不处理直接返回，0=没有新帧时重新处理上一帧
+ * @return 1=取得了新帧，0=没有新帧
+ * @note 所处理帧的帧号存于image_frame_id
+ */
+uint8 image_process_latest(uint8 only_fresh);
+
 /**
  * @brief 图像处理主函数
  * @note 集成边界提取和元素识别的主函数
- *       包括：边界搜索、元素检测、边界延长等完整处理流程
+ *       从摄像头取得最新一帧后调用image_process_frame()，没有新帧时重新处理上一帧
  */
 void image_process(void);
 
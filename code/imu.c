@@ -223,8 +223,13 @@ void imu_calculate_attitude(void)
  ********************************************************************************************************************/
 void imu_update(void)
 {
-    imu_get_data();           // 读取传感器数据
+    uint32 prof_start = prof_begin();
+    imu_get_data(); // 读取传感器数据
+    prof_end(PROF_IMU_READ, prof_start);
+
+    prof_start = prof_begin();
     imu_calculate_attitude(); // 计算姿态角
+    prof_end(PROF_ATTITUDE, prof_start);
 }
 
 /*********************************************************************************************************************
@@ -0,0 +1,99 @@
+/*********************************************************************
+ * 文件: ipm.c
+ * 逆透视变换（IPM）查找表实现文件
+ * 说明：针孔相机模型，相机高度h、光轴俯角θ、焦距f
+ *       第v行光线相对光轴的俯角 α = atan((v - cy) / f)，相对水平面的俯角为 θ + α
+ *       前向距离 Y = h / tan(θ + α)
+ *       沿光轴的深度 Zc = h * cos(α) / sin(θ + α)，横向比例 = Zc / f（mm/列）
+ ********************************************************************/
+
+#include "ipm.h"
+#include "image.h"
+#include "zf_common_headfile.h"
+#include <math.h>
+
+//============================================================
+// 全局变量定义
+//============================================================
+
+float ipm_row_forward[MT9V03X_H];    // 第i行地面点的前向距离（mm）
+float ipm_row_lateral[MT9V03X_H];    // 第i行横向比例（mm/列）
+float ipm_row_weight[MT9V03X_H];     // 第i行覆盖的地面纵向长度（mm）
+uint8 ipm_standard_width[MT9V03X_H]; // 标准赛道宽度在第i行对应的像素数
+
+float Left_Line_Ground[MT9V03X_H];   // 左边界横向坐标（mm）
+float Right_Line_Ground[MT9V03X_H];  // 右边界横向坐标（mm）
+float Mid_Line_Ground[MT9V03X_H];    // 中线横向坐标（mm）
+
+//============================================================
+// 函数实现
+//============================================================
+
+/**
+ * @brief 计算图像第v行（可为小数）对应的地面前向距离
+ * @param v 行号
+ * @return 前向距离（mm），地平线及以上返回0
+ */
+static float ipm_forward_at(float v)
+{
+    float angle = IPM_CAMERA_PITCH_DEG * 3.1415926f / 180.0f + atanf((v - IPM_CENTER_ROW) / IPM_FOCAL_PX);
+
+    if (angle <= 0.001f)
+        return 0;
+    return IPM_CAMERA_HEIGHT_MM / tanf(angle);
+}
+
+/**
+ * @brief 生成逆透视查找表
+ */
+void ipm_init(void)
+{
+    int i;
+    float alpha, angle, near_edge, far_edge, width;
+
+    for (i = 0; i <= MT9V03X_H - 1; i++)
+    {
+        alpha = atanf((i - IPM_CENTER_ROW) / IPM_FOCAL_PX);
+        angle = IPM_CAMERA_PITCH_DEG * 3.1415926f / 180.0f + alpha;
+
+        if (angle <= 0.001f)
+        {
+            // 地平线以上没有地面点
+            ipm_row_forward[i] = 0;
+            ipm_row_lateral[i] = 0;
+            ipm_row_weight[i] = 0;
+            ipm_standard_width[i] = MT9V03X_W - 1;
+            continue;
+        }
+
+        ipm_row_forward[i] = IPM_CAMERA_HEIGHT_MM / tanf(angle);
+        ipm_row_lateral[i] = IPM_CAMERA_HEIGHT_MM * cosf(alpha) / sinf(angle) / IPM_FOCAL_PX;
+
+        // 本行覆盖的地面长度：上下半行边缘的前向距离之差
+        far_edge = ipm_forward_at(i - 0.5f);
+        near_edge = ipm_forward_at(i + 0.5f);
+        ipm_row_weight[i] = (far_edge > near_edge) ? (far_edge - near_edge) : 0;
+
+        width = IPM_TRACK_WIDTH_MM / ipm_row_lateral[i] + 0.5f;
+        ipm_standard_width[i] = (width > MT9V03X_W - 1) ? (MT9V03X_W - 1) : (uint8)width;
+    }
+}
+
+/**
+ * @brief 把边界数组换算为地面横向坐标
+ * @param top_row 换算的最高行
+ */
+void ipm_convert_lines(int top_row)
+{
+    int i;
+
+    if (top_row < 0)
+        top_row = 0;
+
+    for (i = MT9V03X_H - 1; i >= top_row; i--)
+    {
+        Left_Line_Ground[i] = ipm_lateral_mm(i, (float)Left_Line[i]);
+        Right_Line_Ground[i] = ipm_lateral_mm(i, (float)Right_Line[i]);
+        Mid_Line_Ground[i] = (Left_Line_Ground[i] + Right_Line_Ground[i]) * 0.5f;
+    }
+}
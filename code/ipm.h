@@ -0,0 +1,70 @@
+/*********************************************************************
+ * 文件: ipm.h
+ * 逆透视变换（IPM）查找表头文件
+ * 说明：上电时按相机安装参数生成逐行查找表，把图像坐标(row, col)换算为地面坐标，
+ *       运行时每行只需一次乘法，不做逐像素三角运算
+ *       地面坐标：前向距离只与行号有关，横向距离 = (col - IPM_CENTER_COL) * 该行横向比例
+ ********************************************************************/
+
+#ifndef _IPM_H
+#define _IPM_H
+
+#include "zf_common_typedef.h"
+#include "zf_common_headfile.h"
+
+//============================================================
+// 宏定义
+//============================================================
+
+// 相机安装参数（针孔模型，无横滚）
+// 默认值由Road_Standard_Wide[]拟合得到：按赛道宽450mm，该表与针孔模型的线性关系误差不超过2个像素；
+// 高度、俯角、焦距三者只确定了两个组合量，换车或改装相机后应实测标定
+#define IPM_CAMERA_HEIGHT_MM 287.0f            // 相机光心离地高度（mm）
+#define IPM_CAMERA_PITCH_DEG 40.0f             // 光轴俯角（度）
+#define IPM_FOCAL_PX 112.2f                    // 焦距（像素）
+#define IPM_CENTER_COL (MT9V03X_W / 2)         // 横向零点列（与err_sum_average的图像中线一致）
+#define IPM_CENTER_ROW ((MT9V03X_H - 1) * 0.5f) // 光轴所在行
+#define IPM_TRACK_WIDTH_MM 450.0f              // 标准赛道宽度（mm）
+
+//============================================================
+// 全局变量声明
+//============================================================
+
+extern float ipm_row_forward[MT9V03X_H];   // 第i行地面点的前向距离（mm，地平线以上为0）
+extern float ipm_row_lateral[MT9V03X_H];   // 第i行横向比例（mm/列，地平线以上为0）
+extern float ipm_row_weight[MT9V03X_H];    // 第i行覆盖的地面纵向长度（mm），用于按真实距离加权
+extern uint8 ipm_standard_width[MT9V03X_H]; // 标准赛道宽度在第i行对应的像素数（由查找表生成）
+
+extern float Left_Line_Ground[MT9V03X_H];  // 左边界横向坐标（mm，左负右正）
+extern float Right_Line_Ground[MT9V03X_H]; // 右边界横向坐标（mm）
+extern float Mid_Line_Ground[MT9V03X_H];   // 中线横向坐标（mm）
+
+//============================================================
+// 函数声明
+//============================================================
+
+/**
+ * @brief 生成逆透视查找表
+ * @note 上电初始化时调用一次，三角运算只在这里进行
+ */
+void ipm_init(void);
+
+/**
+ * @brief 把边界数组换算为地面横向坐标
+ * @param top_row 换算的最高行（更高的行不处理）
+ * @note 在边界补线之后调用，每行三次乘法
+ */
+void ipm_convert_lines(int top_row);
+
+/**
+ * @brief 图像坐标转地面横向坐标
+ * @param row 行号
+ * @param col 列号（可为小数）
+ * @return 横向距离（mm，左负右正）
+ */
+static inline float ipm_lateral_mm(int row, float col)
+{
+    return (col - IPM_CENTER_COL) * ipm_row_lateral[row];
+}
+
+#endif
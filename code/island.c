@@ -0,0 +1,386 @@
+/*********************************************************************
+ * 文件: island.c
+ * 环岛识别状态机实现文件
+ * 说明：左右环岛通过Island_Side描述环岛侧与外侧的边界数组、拐点和补线函数，
+ *       状态机只写一份；列方向的差异由inward（环岛侧边界指向赛道内部的列方向）统一
+ ********************************************************************/
+
+#include "island.h"
+#include "image.h"
+#include "zf_common_headfile.h"
+
+//============================================================
+// 类型定义
+//============================================================
+
+typedef struct
+{
+    volatile int *line;                     // 环岛侧边界
+    volatile int *other;                    // 外侧边界
+    int *lost;                              // 环岛侧丢线标志
+    int *other_lost;                        // 外侧丢线标志
+    volatile int *down_find;                // 环岛侧下拐点（Find_Down_Point结果）
+    volatile int *up_find;                  // 环岛侧上拐点（Find_Up_Point结果）
+    volatile int *other_down_find;          // 外侧下拐点
+    void (*add_line)(int, int, int, int);   // 环岛侧补线
+    void (*other_add_line)(int, int, int, int); // 外侧补线
+    volatile int *side_flag;                // 环岛侧阶段标志（left/right_circle_flag）
+    int inward;                             // 环岛侧边界指向赛道内部的列方向（左环岛+1，右环岛-1）
+} Island_Side;
+
+//============================================================
+// 全局变量定义
+//============================================================
+
+uint16 island_state_frames = 0; // 当前状态已持续的帧数
+uint32 island_count = 0;        // 已识别的环岛个数
+
+extern int Left_Lost_Flag[MT9V03X_H];     // 左边界丢失标志（定义在image.c中）
+extern int Right_Lost_Flag[MT9V03X_H];    // 右边界丢失标志（定义在image.c中）
+extern volatile int Left_Down_Find;       // 左下拐点（定义在image.c中）
+extern volatile int Left_Up_Find;         // 左上拐点（定义在image.c中）
+extern volatile int Right_Down_Find;      // 右下拐点（定义在image.c中）
+extern volatile int Right_Up_Find;        // 右上拐点（定义在image.c中）
+
+static const Island_Side island_left_side = {
+    Left_Line, Right_Line, Left_Lost_Flag, Right_Lost_Flag,
+    &Left_Down_Find, &Left_Up_Find, &Right_Down_Find,
+    Left_Add_Line, Right_Add_Line, &left_circle_flag, 1};
+static const Island_Side island_right_side = {
+    Right_Line, Left_Line, Right_Lost_Flag, Left_Lost_Flag,
+    &Right_Down_Find, &Right_Up_Find, &Left_Down_Find,
+    Right_Add_Line, Left_Add_Line, &right_circle_flag, -1};
+
+static uint8 island_confirm_count = 0; // 状态切换条件已连续满足的帧数
+static int island_patch_row = 0;       // 上一帧补线所用拐点的行（本帧拐点丢失时沿用）
+static int island_patch_col = 0;       // 上一帧补线所用拐点的列
+
+//============================================================
+// 辅助函数
+//============================================================
+
+/**
+ * @brief 本帧可用的最高行
+ */
+static int island_top(void)
+{
+    int top = MT9V03X_H - Search_Stop_Line;
+    return (top < 5) ? 5 : top;
+}
+
+/**
+ * @brief 统计行范围内的丢线行数
+ * @param lost 丢线标志数组
+ * @param start 起始行（下方）
+ * @param end 结束行（上方）
+ */
+static int island_lost_count(const int *lost, int start, int end)
+{
+    int i, count = 0;
+
+    for (i = start; i >= end; i--)
+        count += lost[i];
+    return count;
+}
+
+/**
+ * @brief 统计拐点上方连续丢线的行数
+ * @param lost 丢线标志数组
+ * @param row 输入拐点行，输出丢线段上方第一个不丢线的行
+ * @param end 结束行（上方）
+ * @return 连续丢线行数
+ * @note 拐点判定比较的是上方2~4行，拐点与丢线段之间允许隔ISLAND_CORNER_GAP行
+ */
+static int island_lost_run(const int *lost, int *row, int end)
+{
+    int i = *row - 1;
+    int start;
+
+    while (i >= end && i > *row - 1 - ISLAND_CORNER_GAP && !lost[i])
+        i--;
+    for (start = i; i >= end && lost[i]; i--)
+        ;
+    *row = i;
+    return start - i;
+}
+
+/**
+ * @brief 判断边界在行范围内是否连续且不丢线
+ * @return 1=连续，0=存在跳变或丢线行
+ */
+static uint8 island_continuous(volatile int *line, const int *lost, int start, int end)
+{
+    int i;
+
+    for (i = start; i > end; i--)
+    {
+        if (lost[i] || abs(line[i] - line[i - 1]) > ISLAND_CONTINUITY_STEP)
+            return 0;
+    }
+    return 1;
+}
+
+/**
+ * @brief 在行范围内由下向上搜索环岛弧线顶点
+ * @return 顶点行，未找到返回0
+ * @note 顶点处环岛侧边界最靠近赛道内部，且上下ISLAND_APEX_SPAN行内都不丢线
+ */
+static int island_apex(const Island_Side *side, int start, int end)
+{
+    int i, k, v;
+
+    if (start > MT9V03X_H - 1 - ISLAND_APEX_SPAN)
+        start = MT9V03X_H - 1 - ISLAND_APEX_SPAN;
+    if (end < ISLAND_APEX_SPAN)
+        end = ISLAND_APEX_SPAN;
+
+    for (i = start; i >= end; i--)
+    {
+        if (side->lost[i])
+            continue;
+        v = side->inward * side->line[i];
+        for (k = 1; k <= ISLAND_APEX_SPAN; k++)
+        {
+            if (side->lost[i - k] || side->lost[i + k] ||
+                side->inward * side->line[i - k] > v || side->inward * side->line[i + k] > v)
+                break;
+        }
+        if (k > ISLAND_APEX_SPAN &&
+            side->inward * side->line[i - ISLAND_APEX_SPAN] < v &&
+            side->inward * side->line[i + ISLAND_APEX_SPAN] < v)
+            return i;
+    }
+    return 0;
+}
+
+/**
+ * @brief 环岛侧丢线行按外侧边界和标准赛道宽度补线
+ * @param start 起始行（下方）
+ * @param end 结束行（上方）
+ */
+static void island_patch_straight(const Island_Side *side, int start, int end)
+{
+    int i, col;
+
+    for (i = start; i >= end; i--)
+    {
+        if (!side->lost[i])
+            continue;
+        col = side->other[i] - side->inward * ROAD_STANDARD_WIDTH(i);
+        if (col < 0)
+            col = 0;
+        else if (col > MT9V03X_W - 1)
+            col = MT9V03X_W - 1;
+        side->line[i] = col;
+    }
+}
+
+/**
+ * @brief 状态切换条件需连续满足ISLAND_CONFIRM_FRAMES帧
+ */
+static uint8 island_confirm(uint8 condition)
+{
+    island_confirm_count = condition ? island_confirm_count + 1 : 0;
+    return island_confirm_count >= ISLAND_CONFIRM_FRAMES;
+}
+
+/**
+ * @brief 切换环岛状态
+ */
+static void island_set_state(const Island_Side *side, int state)
+{
+    Island_State = state;
+    island_state_frames = 0;
+    island_confirm_count = 0;
+    // 环岛侧阶段：1=经过开口与弧线，2=入环（最长白列只在环岛侧统计），3=环内与出环
+    *side->side_flag = (state <= 3) ? 1 : (state == 4) ? 2 : 3;
+}
+
+/**
+ * @brief 在环岛侧识别环岛
+ * @return 1=识别到环岛
+ * @note 外侧边界连续；环岛侧有下拐点，其上方连续丢线，再上方可见弧线顶点
+ *       调用前需已执行Find_Down_Point()（左右下拐点一次搜索得到）
+ */
+static uint8 island_find(const Island_Side *side, int top)
+{
+    int row;
+
+    if (!island_continuous(side->other, side->other_lost, MT9V03X_H - 1, top + 5))
+        return 0;
+
+    row = *side->down_find;
+    if (row == 0 || island_lost_run(side->lost, &row, top) < ISLAND_LOST_ROWS)
+        return 0;
+
+    return island_apex(side, row, top) != 0;
+}
+
+//============================================================
+// 函数实现
+//============================================================
+
+/**
+ * @brief 退出环岛状态，清除全部环岛标志
+ */
+void Island_Reset(void)
+{
+    Island_State = 0;
+    circle_flag = ISLAND_NONE;
+    left_circle_flag = 0;
+    right_circle_flag = 0;
+    island_state_frames = 0;
+    island_confirm_count = 0;
+}
+
+/**
+ * @brief 环岛识别与补线
+ */
+void Island_Detect(void)
+{
+    const Island_Side *side;
+    int top = island_top();
+    int down, up, apex, col, row;
+
+    // 0. 未进入环岛：识别条件需连续满足，且只在视野足够长时识别
+    if (Island_State == 0)
+    {
+        uint8 left, right;
+
+        if (Search_Stop_Line < ISLAND_MIN_STOP_LINE)
+        {
+            island_confirm(0);
+            return;
+        }
+        Find_Down_Point(MT9V03X_H - 5, top + 10);
+        right = island_find(&island_right_side, top);
+        left = right ? 0 : island_find(&island_left_side, top);
+        if (!island_confirm(left || right))
+            return;
+
+        circle_flag = right ? ISLAND_RIGHT : ISLAND_LEFT;
+        island_set_state(right ? &island_right_side : &island_left_side, 1);
+        return;
+    }
+
+    side = (circle_flag == ISLAND_RIGHT) ? &island_right_side : &island_left_side;
+
+    // 超时保护：识别错误或丢失状态时回到正常巡线
+    if (island_state_frames < 0xFFFF)
+        island_state_frames++;
+    if (island_state_frames > ((Island_State == 5) ? ISLAND_RING_TIMEOUT_FRAMES : ISLAND_TIMEOUT_FRAMES))
+    {
+        Island_Reset();
+        return;
+    }
+
+    switch (Island_State)
+    {
+    case 1:
+        // 接近环岛：连接下拐点与弧线顶点
+        Find_Down_Point(MT9V03X_H - 5, top + 10);
+        down = *side->down_find;
+        apex = island_apex(side, down ? down - 1 : MT9V03X_H - 1, top);
+        if (down && apex)
+            side->add_line(side->line[down], down, side->line[apex], apex);
+        else
+            island_patch_straight(side, MT9V03X_H - 1, top);
+
+        // 下拐点移出视野后环岛侧底部丢线（弧线上方的丢线段仍会被识别为下拐点，不能用拐点消失判断）
+        if (island_confirm(island_lost_count(side->lost, MT9V03X_H - 1, MT9V03X_H - ISLAND_BOTTOM_ROWS) >= ISLAND_BOTTOM_ROWS / 2))
+            island_set_state(side, 2);
+        break;
+
+    case 2:
+        // 经过第一个开口：连接弧线顶点与底部（底部按标准宽度推算）
+        apex = island_apex(side, MT9V03X_H - 1, top);
+        if (apex)
+        {
+            col = side->other[MT9V03X_H - 1] - side->inward * ROAD_STANDARD_WIDTH(MT9V03X_H - 1);
+            side->add_line(side->line[apex], apex, col, MT9V03X_H - 1);
+        }
+        else
+        {
+            island_patch_straight(side, MT9V03X_H - 1, top);
+        }
+
+        if (island_confirm(island_lost_count(side->lost, MT9V03X_H - 1, MT9V03X_H - ISLAND_BOTTOM_ROWS) <= 2))
+            island_set_state(side, 3);
+        break;
+
+    case 3:
+        // 经过弧线：先找入环口上拐点（补线会抹掉拐点特征），再补线直行
+        Find_Up_Point(MT9V03X_H - 5, top);
+        up = *side->up_find;
+        island_patch_straight(side, MT9V03X_H - 1, top);
+
+        if (island_confirm(up != 0 && up >= ISLAND_ENTER_ROW))
+        {
+            island_patch_row = up;
+            island_patch_col = side->line[up];
+            island_set_state(side, 4);
+        }
+        break;
+
+    case 4:
+        // 入环：外侧边界从上拐点连到底部，有效行截止于上拐点
+        Find_Up_Point(MT9V03X_H - 5, top);
+        up = *side->up_find;
+        if (up)
+        {
+            island_patch_row = up;
+            island_patch_col = side->line[up];
+        }
+        side->other_add_line(island_patch_col, island_patch_row, side->other[MT9V03X_H - 1], MT9V03X_H - 1);
+        if (Search_Stop_Line > MT9V03X_H - island_patch_row)
+            Search_Stop_Line = MT9V03X_H - island_patch_row;
+
+        if (island_confirm(up == 0))
+            island_set_state(side, 5);
+        break;
+
+    case 5:
+        // 环内：等待外侧出现出环下拐点，其上方丢线
+        Find_Down_Point(MT9V03X_H - 5, top + 10);
+        down = *side->other_down_find;
+        row = down;
+        if (island_confirm(down != 0 && island_lost_run(side->other_lost, &row, top) >= ISLAND_LOST_ROWS))
+        {
+            island_patch_row = down;
+            island_patch_col = side->other[down];
+            island_set_state(side, 6);
+        }
+        break;
+
+    case 6:
+        // 出环：外侧边界从出环下拐点连到环岛侧顶部
+        Find_Down_Point(MT9V03X_H - 5, top);
+        down = *side->other_down_find;
+        if (down)
+        {
+            island_patch_row = down;
+            island_patch_col = side->other[down];
+        }
+        side->other_add_line(island_patch_col, island_patch_row, side->line[top], top);
+
+        if (island_confirm(down == 0))
+            island_set_state(side, 7);
+        break;
+
+    case 7:
+        // 离开环岛：环岛侧底部边界恢复后结束
+        if (island_confirm(island_lost_count(side->lost, MT9V03X_H - 1, MT9V03X_H - ISLAND_BOTTOM_ROWS) <= 2 &&
+                           island_continuous(side->line, side->lost, MT9V03X_H - 1, MT9V03X_H - ISLAND_BOTTOM_ROWS)))
+        {
+            island_count++;
+            Island_Reset();
+            break;
+        }
+        island_patch_straight(side, MT9V03X_H - 1, top);
+        break;
+
+    default:
+        Island_Reset();
+        break;
+    }
+}
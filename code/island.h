@@ -0,0 +1,69 @@
+/*********************************************************************
+ * 文件: island.h
+ * 环岛识别状态机头文件
+ * 说明：基于拐点搜索（Find_Up_Point/Find_Down_Point）和边界补线（Left_Add_Line/Right_Add_Line）
+ *       实现左右环岛的完整状态机，左右环岛共用同一套逻辑（按环岛所在侧镜像）
+ *       每个状态只搜索本状态需要的行范围，单帧耗时有上界；由元素调度器调用（见element.c）
+ *       状态机只读写边界数组和元素标志，可在上位机上用录制的边界数据回放测试
+ ********************************************************************/
+
+#ifndef _ISLAND_H
+#define _ISLAND_H
+
+#include "zf_common_typedef.h"
+#include "zf_common_headfile.h"
+
+//============================================================
+// 宏定义
+//============================================================
+
+// 环岛方向（circle_flag取值）
+#define ISLAND_NONE  0
+#define ISLAND_LEFT  1
+#define ISLAND_RIGHT 2
+
+// 环岛状态（Island_State取值，"环岛侧"指环岛所在的一侧，"外侧"指另一侧）
+// 0 无环岛
+// 1 接近环岛：环岛侧出现下拐点，其上方丢线，再上方可见圆环弧线，补线连接下拐点与弧线顶点
+// 2 经过第一个开口：下拐点已过，环岛侧底部丢线，补线连接弧线顶点与底部
+// 3 经过圆环弧线：等待入环口上拐点出现，环岛侧丢线行按标准宽度补线直行
+// 4 入环：外侧边界从入环口上拐点连线到底部，引导车转入环岛，有效行截止于上拐点
+// 5 环内：正常巡线，等待外侧出现出环下拐点
+// 6 出环：外侧边界从出环下拐点连线到环岛侧顶部，保持转向驶出
+// 7 离开环岛：环岛侧丢线行按标准宽度补线直行，环岛侧边界恢复后回到0
+#define ISLAND_STATE_NUM 8
+
+#define ISLAND_CONFIRM_FRAMES 2      // 状态切换条件需连续满足的帧数
+#define ISLAND_TIMEOUT_FRAMES 300    // 单个状态（环内除外）的最长帧数，超时退出环岛
+#define ISLAND_RING_TIMEOUT_FRAMES 600 // 环内状态的最长帧数
+#define ISLAND_MIN_STOP_LINE 70      // 识别环岛所需的最小搜索停止行
+#define ISLAND_CONTINUITY_STEP 5     // 相邻行边界差不超过该值视为连续
+#define ISLAND_LOST_ROWS 8           // 下拐点上方环岛侧至少连续丢线的行数
+#define ISLAND_CORNER_GAP 3          // 下拐点与其上方丢线段之间允许间隔的行数
+#define ISLAND_APEX_SPAN 5           // 弧线顶点判定的上下邻域行数
+#define ISLAND_BOTTOM_ROWS 15        // 判断底部是否丢线所用的行数
+#define ISLAND_ENTER_ROW 40          // 入环口上拐点低于该行（行号大于该值）时开始入环
+
+//============================================================
+// 全局变量声明
+//============================================================
+
+extern uint16 island_state_frames; // 当前状态已持续的帧数
+extern uint32 island_count;        // 已识别的环岛个数
+
+//============================================================
+// 函数声明
+//============================================================
+
+/**
+ * @brief 环岛识别与补线
+ * @note 在边界提取之后由元素调度器调用，更新Island_State、circle_flag、left/right_circle_flag并修补边界
+ */
+void Island_Detect(void);
+
+/**
+ * @brief 退出环岛状态，清除全部环岛标志
+ */
+void Island_Reset(void);
+
+#endif
@@ -0,0 +1,45 @@
+/*********************************************************************
+ * 文件: latency.c
+ * 摄像头到舵机的延迟统计实现文件
+ * 说明：记录函数在latency.h中内联，这里只有显示用的换算和清零
+ ********************************************************************/
+
+#include "latency.h"
+#include "zf_common_headfile.h"
+#include <string.h>
+
+//============================================================
+// 全局变量定义
+//============================================================
+
+Latency_Stat latency_stats[LATENCY_STAGE_NUM];  // 各阶段统计
+
+const char *const latency_stage_name[LATENCY_STAGE_NUM] = {
+    "Capture",
+    "Queue",
+    "Binarize",
+    "Boundary",
+    "Element",
+    "Handoff",
+    "Cam->Srv",
+};
+
+//============================================================
+// 函数实现
+//============================================================
+
+/**
+ * @brief 计算阶段平均耗时
+ */
+uint32 latency_mean_us(Latency_Stage stage)
+{
+    return stm_stat_mean(&latency_stats[stage].stat) / STM_TICKS_PER_US;
+}
+
+/**
+ * @brief 清零全部统计
+ */
+void latency_reset(void)
+{
+    memset(latency_stats, 0, sizeof(latency_stats));
+}
@@ -0,0 +1,106 @@
+/*********************************************************************
+ * 文件: latency.h
+ * 摄像头到舵机的延迟统计头文件
+ * 说明：热路径上用STM0系统定时器打时间戳（场同步、DMA完成、图像处理各阶段、舵机输出），
+ *       每个阶段累计最小/平均/最大值和直方图；记录一次只有几次比较和加法，不做除法
+ *       统计类型和最小/平均/最大的记录与分段耗时统计共用（stm_stat.h）
+ ********************************************************************/
+
+#ifndef _LATENCY_H
+#define _LATENCY_H
+
+#include "zf_common_typedef.h"
+#include "zf_common_headfile.h"
+#include "stm_stat.h"
+#include "IfxStm.h"
+
+//============================================================
+// 宏定义
+//============================================================
+
+#define LATENCY_ENABLE 1          // 延迟统计开关（0时记录函数为空）
+#define LATENCY_HIST_BINS 10      // 直方图格数（最后一格包含所有更大的值）
+#define LATENCY_HIST_SHIFT 18     // 直方图格宽 = 2^18个STM计数（约2.62ms），用移位代替除法
+
+// 统计阶段
+typedef enum
+{
+    LATENCY_CAPTURE = 0,  // 场同步 -> DMA完成（曝光读出与传输）
+    LATENCY_QUEUE,        // DMA完成 -> 开始处理（等待处理核心取帧）
+    LATENCY_BINARIZE,     // 取帧、直方图与二值化
+    LATENCY_BOUNDARY,     // 边界提取
+    LATENCY_ELEMENT,      // 元素检测、补线、逆透视与中线拟合
+    LATENCY_HANDOFF,      // 处理完成 -> 舵机输出（邮箱交接与控制核心轮询）
+    LATENCY_END_TO_END,   // 场同步 -> 舵机输出
+    LATENCY_STAGE_NUM
+} Latency_Stage;
+
+//============================================================
+// 类型定义
+//============================================================
+
+typedef struct
+{
+    Stm_Stat stat;                    // 样本数与最小/平均/最大值（STM计数）
+    uint32 hist[LATENCY_HIST_BINS];   // 直方图
+} Latency_Stat;
+
+//============================================================
+// 全局变量声明
+//============================================================
+
+extern Latency_Stat latency_stats[LATENCY_STAGE_NUM];  // 各阶段统计（每个阶段只由一个核心写入）
+extern const char *const latency_stage_name[LATENCY_STAGE_NUM]; // 阶段名称（显示用，不超过8个字符）
+
+//============================================================
+// 函数声明
+//============================================================
+
+/**
+ * @brief 读取STM0时间戳
+ * @return STM0低32位计数（10ns）
+ */
+static inline uint32 latency_now(void)
+{
+    return IfxStm_getLower(&MODULE_STM0);
+}
+
+/**
+ * @brief 记录一个阶段的耗时
+ * @param stage 阶段
+ * @param start 阶段开始时刻（latency_now()）
+ * @param end 阶段结束时刻
+ * @note start为0表示时间戳无效（如尚未采集到图像），不记录
+ */
+static inline void latency_record(Latency_Stage stage, uint32 start, uint32 end)
+{
+#if LATENCY_ENABLE
+    Latency_Stat *stat = &latency_stats[stage];
+    uint32 ticks, bin;
+
+    if (start == 0)
+        return;
+    ticks = end - start;
+    bin = ticks >> LATENCY_HIST_SHIFT;
+    stat->hist[(bin < LATENCY_HIST_BINS) ? bin : (LATENCY_HIST_BINS - 1)]++;
+    stm_stat_record(&stat->stat, ticks);
+#else
+    (void)stage;
+    (void)start;
+    (void)end;
+#endif
+}
+
+/**
+ * @brief 计算阶段平均耗时
+ * @param stage 阶段
+ * @return 平均耗时（us），无样本时为0
+ */
+uint32 latency_mean_us(Latency_Stage stage);
+
+/**
+ * @brief 清零全部统计
+ */
+void latency_reset(void);
+
+#endif
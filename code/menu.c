@@ -22,6 +22,7 @@ extern Page page_cargo; // Cargo运行模式页面（用于特殊退出处理）
 
 Page *Now_Menu = NULL;         // 当前菜单页面指针
 static uint8 need_refresh = 1; // 屏幕刷新标志
+volatile uint8 menu_key_event = 0; // 按键事件标志（主循环据此立即刷新菜单）
 
 /**************** 按键扫描相关函数 ****************/
 
@@ -700,6 +701,12 @@ void Menu_Show(void)
  */
 void Key_operation(uint8 key)
 {
+    // 通知主循环有按键事件，不必等到下一个菜单刷新周期
+    if (key != KEY_NONE)
+    {
+        menu_key_event = 1;
+    }
+
     switch (key)
     {
     case KEY_UP: // KEY1 - 上
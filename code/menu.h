@@ -29,6 +29,7 @@
 /**************** 长按配置 ****************/
 #define LONG_PRESS_CNT 30 // 长按阈值：连续检测15次认为长按（约300ms）
 #define REPEAT_INTERVAL 3 // 长按后每3次循环触发一次（约60ms间隔）
+#define MENU_REFRESH_PERIOD_MS 20 // 主循环菜单刷新周期（ms），按键事件会立即触发刷新
 
 /**************** 字体配置 ****************/
 #define FONT_W 8 // 字符宽度
@@ -101,6 +102,7 @@ struct Page
 
 /**************** 全局变量声明 ****************/
 extern Page *Now_Menu; // 当前菜单指针
+extern volatile uint8 menu_key_event; // 按键事件标志（Key_operation置位，主循环清零后立即刷新菜单）
 
 /**************** 函数声明 ****************/
 
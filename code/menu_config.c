@@ -40,6 +40,7 @@ extern volatile int Left_Line[MT9V03X_H];  // 左边界数组
 extern volatile int Right_Line[MT9V03X_H]; // 右边界数组
 extern uint32 steer_sample_start;          // 转向PID采样起始行
 extern uint32 steer_sample_end;            // 转向PID采样结束行
+extern uint32 steer_lookahead;             // 转向误差使用中线拟合前瞻点
 
 /**************** 外部变量引用 ****************/
 extern volatile bool enable; // volatile 关键字
@@ -120,6 +121,7 @@ float pid_ki_step[] = {0.01f, 0.1f, 1.0f, 10.0f, 100.0f};
 float pid_kd_step[] = {0.01f, 0.1f, 1.0f, 10.0f, 100.0f};
 float pid_limit_step[] = {1.0f, 10.0f, 100.0f};
 float gain_scale_step[] = {0.01f, 0.1f, 0.2f};
+uint32 fixed_point_step[] = {1}; // 定点计算开关步进值（0/1切换）
 
 // 3.1 角速度环PID
 CustomData gyro_pid_data[] = {
@@ -129,12 +131,13 @@ CustomData gyro_pid_data[] = {
     {&gyro_pid.max_integral, data_float_show, "Max Integral", pid_limit_step, 3, 0, 5, 1},
     {&gyro_pid.max_output, data_float_show, "Max Output", pid_limit_step, 3, 0, 5, 1},
     {&gyro_gain_scale, data_float_show, "Gain Scale", gain_scale_step, 3, 0, 3, 2},
+    {&gyro_pid.fixed_point, data_uint32_show, "Fixed Point", fixed_point_step, 1, 0, 1, 0},
 };
 
 Page page_gyro_pid = {
     .name = "Gyro PID",
     .data = gyro_pid_data,
-    .len = 6,
+    .len = 7,
     .stage = Menu,
     .back = NULL, // 在 Menu_Config_Init() 中设置
     .enter = {NULL},
@@ -156,12 +159,13 @@ CustomData angle_pid_data[] = {
     {&angle_pid.max_output, data_float_show, "Max Output", pid_limit_step, 3, 0, 5, 1},
     {&angle_deadzone, data_float_show, "Angle Deadzone", deadzone_step, 4, 0, 4, 1},
     {&angle_gain_scale, data_float_show, "Gain Scale", gain_scale_step, 3, 0, 3, 2},
+    {&angle_pid.fixed_point, data_uint32_show, "Fixed Point", fixed_point_step, 1, 0, 1, 0},
 };
 
 Page page_angle_pid = {
     .name = "Angle PID",
     .data = angle_pid_data,
-    .len = 8,
+    .len = 9,
     .stage = Menu,
     .back = NULL, // 在 Menu_Config_Init() 中设置
     .enter = {NULL},
@@ -177,12 +181,13 @@ CustomData speed_pid_data[] = {
     {&speed_pid.kd, data_float_show, "Kd", pid_kd_step, 5, 0, 4, 4},
     {&speed_pid.max_integral, data_float_show, "Max Integral", pid_limit_step, 3, 0, 5, 1},
     {&speed_pid.max_output, data_float_show, "Max Output", pid_limit_step, 3, 0, 5, 1},
+    {&speed_pid.fixed_point, data_uint32_show, "Fixed Point", fixed_point_step, 1, 0, 1, 0},
 };
 
 Page page_speed_pid = {
     .name = "Speed PID",
     .data = speed_pid_data,
-    .len = 5,
+    .len = 6,
     .stage = Menu,
     .back = NULL, // 在 Menu_Config_Init() 中设置
     .enter = {NULL},
@@ -205,12 +210,13 @@ CustomData drive_speed_pid_data[] = {
     {&drive_speed_pid.kd, data_float_show, "Kd", pid_kd_step, 5, 0, 4, 4},
     {&drive_speed_pid.max_integral, data_float_show, "Max Integral", pid_limit_step, 3, 0, 5, 1},
     {&drive_speed_pid.max_output, data_float_show, "Max Output", pid_limit_step, 3, 0, 5, 1},
+    {&drive_speed_pid.fixed_point, data_uint32_show, "Fixed Point", fixed_point_step, 1, 0, 1, 0},
 };
 
 Page page_drive_speed_pid = {
     .name = "Drive Speed PID",
     .data = drive_speed_pid_data,
-    .len = 8,
+    .len = 9,
     .stage = Menu,
     .back = NULL, // 在 Menu_Config_Init() 中设置
     .enter = {NULL},
@@ -312,6 +318,8 @@ float steer_kp_step[] = {0.01f, 0.1f, 1.0f, 5.0f};
 float steer_kd_step[] = {0.001f, 0.01f, 0.1f};
 float steer_limit_step[] = {1.0f, 5.0f, 10.0f};
 uint32 sample_row_step[] = {1, 5, 10};
+float lookahead_base_step[] = {10.0f, 50.0f, 100.0f};
+float lookahead_gain_step[] = {0.1f, 0.5f, 1.0f};
 
 CustomData steer_pid_data[] = {
     {&steer_enable, data_uint32_show, "Enable (0/1)", steer_enable_step, 1, 0, 1, 0},
@@ -320,12 +328,15 @@ CustomData steer_pid_data[] = {
     {&steer_output_limit, data_float_show, "Output Limit", steer_limit_step, 3, 0, 4, 1},
     {&steer_sample_start, data_uint32_show, "Sample Start", sample_row_step, 3, 0, 3, 0},
     {&steer_sample_end, data_uint32_show, "Sample End", sample_row_step, 3, 0, 3, 0},
+    {&steer_lookahead, data_uint32_show, "Lookahead (0/1)", steer_enable_step, 1, 0, 1, 0},
+    {&centerline_lookahead_base, data_float_show, "LA Base(mm)", lookahead_base_step, 3, 0, 4, 0},
+    {&centerline_lookahead_gain, data_float_show, "LA Gain", lookahead_gain_step, 3, 0, 2, 1},
 };
 
 Page page_steer_pid = {
     .name = "Steer PID",
     .data = steer_pid_data,
-    .len = 6,
+    .len = 9,
     .stage = Menu,
     .back = NULL, // 在 Menu_Config_Init() 中设置
     .enter = {NULL},
@@ -474,8 +485,9 @@ Page page_cargo = {
 };
 
 //============================================================
-// 7. 调试监控页面
+// 7. 调试页面
 //============================================================
+// 7.1 调试监控页面
 void debug_monitor_mode(void)
 {
     ips_clear();
@@ -504,7 +516,7 @@ void debug_monitor_mode(void)
     }
 }
 
-Page page_debug = {
+Page page_debug_monitor = {
     .name = "Debug Monitor",
     .data = NULL,
     .len = 0,
@@ -516,6 +528,206 @@ Page page_debug = {
     .scroll_offset = 0,
 };
 
+// 7.2 延迟统计页面：各阶段最小/平均/最大耗时（us），OK键切换端到端直方图，DOWN键清零
+void latency_monitor_mode(void)
+{
+    uint8 show_hist = 0; // 0=阶段列表，1=端到端直方图
+    uint8 key = KEY_NONE;
+    uint8 i;
+
+    ips_clear();
+    while (1)
+    {
+        if (show_hist == 0)
+        {
+            show_string(0, 0, "Stage    Min   Mean  Max");
+            for (i = 0; i < LATENCY_STAGE_NUM; i++)
+            {
+                show_string(0, 2 + i * 2, latency_stage_name[i]);
+                show_int(9, 2 + i * 2, latency_stats[i].stat.min / STM_TICKS_PER_US, 5);
+                show_int(15, 2 + i * 2, latency_mean_us((Latency_Stage)i), 5);
+                show_int(21, 2 + i * 2, latency_stats[i].stat.max / STM_TICKS_PER_US, 6);
+            }
+        }
+        else
+        {
+            // 每格左端对应的毫秒数 = 格号 * 2^LATENCY_HIST_SHIFT / 每毫秒STM计数
+            show_string(0, 0, "Cam->Srv hist(ms:count)");
+            for (i = 0; i < LATENCY_HIST_BINS; i++)
+            {
+                uint16 x = (i < LATENCY_HIST_BINS / 2) ? 0 : 15;
+                uint16 y = 2 + (i % (LATENCY_HIST_BINS / 2)) * 2;
+
+                show_int(x, y, ((uint32)i << LATENCY_HIST_SHIFT) / (STM_TICKS_PER_US * 1000), 2);
+                show_string(x + 3, y, ":");
+                show_int(x + 4, y, latency_stats[LATENCY_END_TO_END].hist[i], 7);
+            }
+            show_string(0, 12, "N:");
+            show_int(2, 12, latency_stats[LATENCY_END_TO_END].stat.count, 8);
+        }
+
+        key = Key_Scan();
+        if (key == KEY_OK)
+        {
+            show_hist = !show_hist;
+            ips_clear();
+            system_delay_ms(200); // 防止按键连续触发
+        }
+        else if (key == KEY_DOWN)
+        {
+            latency_reset();
+            ips_clear();
+            system_delay_ms(200);
+        }
+        else if (key == KEY_BACK)
+        {
+            ips_clear();
+            break;
+        }
+
+        system_delay_ms(50);
+    }
+}
+
+Page page_latency = {
+    .name = "Latency",
+    .data = NULL,
+    .len = 0,
+    .stage = Funtion,
+    .back = NULL, // 在 Menu_Config_Init() 中设置
+    .enter = {NULL},
+    .content = {.function = latency_monitor_mode},
+    .order = 0,
+    .scroll_offset = 0,
+};
+
+// 7.3 分段耗时页面：各分段最小/平均/最大耗时（us），分段之后一页为各元素检测器的运行次数/超时次数/最长耗时，
+//     OK键翻页，UP键经串口输出统计表，DOWN键清零
+#define PROF_ROWS_PER_PAGE 6 // 每页显示的分段数
+
+void profiler_monitor_mode(void)
+{
+    uint8 first = 0; // 本页第一个分段，等于PROF_SECTION_NUM时为元素检测器页
+    uint8 key = KEY_NONE;
+    uint8 i, y;
+
+    ips_clear();
+    while (1)
+    {
+        if (first < PROF_SECTION_NUM)
+        {
+            show_string(0, 0, "Section  Min   Mean  Max");
+            for (i = first; i < PROF_SECTION_NUM && i < first + PROF_ROWS_PER_PAGE; i++)
+            {
+                y = 2 + (i - first) * 2;
+                show_string(0, y, prof_section_name[i]);
+                show_float(9, y, (float)prof_stats[i].min / STM_TICKS_PER_US, 3, 1);
+                show_float(15, y, (float)prof_mean_ticks((Prof_Section)i) / STM_TICKS_PER_US, 3, 1);
+                show_float(21, y, (float)prof_stats[i].max / STM_TICKS_PER_US, 4, 1);
+            }
+            if (first + PROF_ROWS_PER_PAGE >= PROF_SECTION_NUM)
+            {
+                // 最后一页附带调度器单节拍最长耗时
+                show_string(0, 14, "Tick max(us):");
+                show_float(14, 14, (float)sched_tick_ticks_max / STM_TICKS_PER_US, 4, 1);
+            }
+        }
+        else
+        {
+            show_string(0, 0, "Element  Runs  Over  Max");
+            for (i = 0; i < element_detector_num && i < PROF_ROWS_PER_PAGE; i++)
+            {
+                y = 2 + i * 2;
+                show_string(0, y, element_detectors[i].name);
+                show_int(9, y, element_detectors[i].run_count, 5);
+                show_int(15, y, element_detectors[i].overrun_count, 5);
+                show_float(21, y, (float)element_detectors[i].max_ticks / STM_TICKS_PER_US, 4, 1);
+            }
+            // 附带元素检测单帧最长耗时
+            show_string(0, 14, "Frame max(us):");
+            show_float(15, 14, (float)element_frame_ticks_max / STM_TICKS_PER_US, 4, 1);
+        }
+
+        key = Key_Scan();
+        if (key == KEY_OK)
+        {
+            // 分段页之后是元素检测器页，再回到第一页
+            if (first >= PROF_SECTION_NUM)
+                first = 0;
+            else if (first + PROF_ROWS_PER_PAGE >= PROF_SECTION_NUM)
+                first = PROF_SECTION_NUM;
+            else
+                first += PROF_ROWS_PER_PAGE;
+            ips_clear();
+            system_delay_ms(200); // 防止按键连续触发
+        }
+        else if (key == KEY_UP)
+        {
+            prof_dump();
+            system_delay_ms(200);
+        }
+        else if (key == KEY_DOWN)
+        {
+            prof_reset();
+            sched_stats_reset(control_tasks, control_task_num);
+            element_stats_reset();
+            ips_clear();
+            system_delay_ms(200);
+        }
+        else if (key == KEY_BACK)
+        {
+            ips_clear();
+            break;
+        }
+
+        system_delay_ms(50);
+    }
+}
+
+Page page_profiler = {
+    .name = "Profiler",
+    .data = NULL,
+    .len = 0,
+    .stage = Funtion,
+    .back = NULL, // 在 Menu_Config_Init() 中设置
+    .enter = {NULL},
+    .content = {.function = profiler_monitor_mode},
+    .order = 0,
+    .scroll_offset = 0,
+};
+
+// 7.4 逐帧结果输出（CSV经调试串口输出，用于上位机回放比对）
+uint32 frame_log_step[] = {1, 10};
+
+CustomData frame_log_data[] = {
+    {&frame_log_stream, data_uint32_show, "Log Every(0=off)", frame_log_step, 2, 0, 3, 0},
+};
+
+Page page_frame_log = {
+    .name = "Frame Log",
+    .data = frame_log_data,
+    .len = 1,
+    .stage = Menu,
+    .back = NULL, // 在 Menu_Config_Init() 中设置
+    .enter = {NULL},
+    .content = {NULL},
+    .order = 0,
+    .scroll_offset = 0,
+};
+
+// 7.5 调试主菜单
+Page page_debug = {
+    .name = "Debug",
+    .data = NULL,
+    .len = 4,
+    .stage = Menu,
+    .back = NULL, // 在 Menu_Config_Init() 中设置
+    .enter = {&page_debug_monitor, &page_latency, &page_profiler, &page_frame_log},
+    .content = {NULL},
+    .order = 0,
+    .scroll_offset = 0,
+};
+
 //============================================================
 // 8. 摄像头图像显示
 //============================================================
@@ -530,16 +742,17 @@ void camera_display_mode(void)
     {
         uint8 image_threshold = 0;
 
-        // 如果是二值化模式，使用大津法动态计算阈值
+        // 先处理最新一帧，显示的图像与边界使用同一帧
+        image_process();
+
+        // 如果是二值化模式，使用本帧大津法阈值
         if (display_mode == 1)
         {
-            image_threshold = (uint8)otsu_get_threshold(mt9v03x_image[0], MT9V03X_W, MT9V03X_H);
-            threshold = (int)image_threshold;  // 显式转换避免警告
+            image_threshold = (uint8)threshold;
         }
 
         // 每次循环都刷新图像（摄像头是实时采集的）
-        ips114_show_gray_image(0, 0, mt9v03x_image[0], MT9V03X_W, MT9V03X_H, MT9V03X_W, MT9V03X_H, image_threshold);
-        image_process();
+        ips114_show_gray_image(0, 0, image_gray[0], MT9V03X_W, MT9V03X_H, MT9V03X_W, MT9V03X_H, image_threshold);
 
     
 
@@ -600,6 +813,14 @@ void camera_display_mode(void)
             display_mode = !display_mode;  // 在0和1之间切换
             system_delay_ms(200);          // 防止按键连续触发
         }
+        // 检测UP键 - 抓拍当前帧（原始灰度图和处理结果）到调试串口，供上位机回放
+        else if (key == KEY_UP)
+        {
+            show_string(0, 0, "Dumping...");
+            frame_log_dump_frame(image_frame_id, image_gray[0]);
+            frame_log_csv_header();
+            frame_log_csv_line(image_frame_id, err_sum_average((uint8)steer_sample_start, (uint8)steer_sample_end), 0);
+        }
         // 检测返回键 - 退出
         else if (key == KEY_BACK)
         {
@@ -624,15 +845,41 @@ Page page_camera = {
 };
 
 //============================================================
-// 9. 主菜单
+// 9. 图像参数菜单 - Auto Exposure / Adaptive Threshold
+//============================================================
+uint32 ae_target_step[] = {1, 10};
+
+CustomData exposure_data[] = {
+    {&ae_enable, data_uint32_show, "Auto Exp(0/1)", enabled_step, 1, 0, 1, 0},
+    {&ae_target, data_uint32_show, "Target Gray", ae_target_step, 2, 0, 3, 0},
+    {&ae_deadband, data_uint32_show, "Deadband", ae_target_step, 2, 0, 3, 0},
+    {&adaptive_threshold_enable, data_uint32_show, "Adaptive(0/1)", enabled_step, 1, 0, 1, 0},
+    {&adaptive_threshold_offset, data_uint32_show, "Adapt Offset", ae_target_step, 2, 0, 3, 0},
+    {&adaptive_threshold_margin, data_uint32_show, "Adapt Margin", ae_target_step, 2, 0, 3, 0},
+};
+
+Page page_exposure = {
+    .name = "Image",
+    .data = exposure_data,
+    .len = 6,
+    .stage = Menu,
+    .back = NULL, // 在 Menu_Config_Init() 中设置
+    .enter = {NULL},
+    .content = {NULL},
+    .order = 0,
+    .scroll_offset = 0,
+};
+
+//============================================================
+// 10. 主菜单
 //============================================================
 Page main_page = {
     .name = "Main Menu",
     .data = NULL,
-    .len = 7, // 子菜单数量（增加了Camera View）
+    .len = 8, // 子菜单数量（增加了Camera View、Image）
     .stage = Menu,
     .back = NULL,
-    .enter = {&page_cargo, &page_delayed_stop, &page_servo, &page_pid, &page_imu, &page_debug, &page_camera},
+    .enter = {&page_cargo, &page_delayed_stop, &page_servo, &page_pid, &page_imu, &page_debug, &page_camera, &page_exposure},
     .content = {NULL},
     .order = 0,
     .scroll_offset = 0,
@@ -655,6 +902,7 @@ void Menu_Config_Init(void)
     page_imu.back = &main_page;
     page_debug.back = &main_page;
     page_camera.back = &main_page; // 摄像头显示页面
+    page_exposure.back = &main_page; // 图像参数页面（自动曝光、自适应阈值）
 
     // 设置PID子页面的父指针
     page_gyro_pid.back = &page_pid;
@@ -669,4 +917,10 @@ void Menu_Config_Init(void)
     // 设置IMU子页面的父指针
     page_imu_params.back = &page_imu;
     page_gyro_calibration.back = &page_imu;
+
+    // 设置调试子页面的父指针
+    page_debug_monitor.back = &page_debug;
+    page_latency.back = &page_debug;
+    page_profiler.back = &page_debug;
+    page_frame_log.back = &page_debug;
 }
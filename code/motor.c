@@ -294,9 +294,9 @@ static void check_angle_protection(void)
 
             // 清空所有PID积分项，避免积分饱和
             extern PID_Controller angle_pid, gyro_pid, speed_pid;
-            angle_pid.integral = 0;
-            gyro_pid.integral = 0;
-            speed_pid.integral = 0;
+            pid_clear_integral(&angle_pid);
+            pid_clear_integral(&gyro_pid);
+            pid_clear_integral(&speed_pid);
 
             // 重置输出滤波器状态
             extern float filtered_motor_output;
@@ -55,6 +55,7 @@ float steer_output_limit = 30.0f; // 转向输出限幅（舵机角度限制）
 uint32 steer_sample_start = 50;   // 图像采样起始行（从底部算起，越大越近）
 uint32 steer_sample_end = 60;     // 图像采样结束行
 uint32 steer_enable = 1;          // 转向环使能（0=禁用，1=启用）
+uint32 steer_lookahead = 0;       // 转向误差来源（0=采样行平均偏差，1=中线拟合前瞻点偏差）
 
 // 行进轮速度环控制参数
 uint32 drive_speed_enable = 1;        // 行进轮速度环使能（0=开环，1=闭环PID）
@@ -70,7 +71,6 @@ float target_drive_speed = 10.0f; // 行进轮目标速度
 volatile bool enable = false; // 使能标志，默认禁用（需在Cargo模式中启用）
 
 // 控制变量
-static uint32_t count = 0;                // 控制计数器
 static float desired_angle = 0.0f;        // 期望角度（速度环输出）
 static float angle_gyro_target = 0.0f;    // 目标角速度（角度环输出）
 static float current_servo_angle = 90.0f; // 当前实际舵机角度（由转向PID更新）
@@ -89,9 +89,53 @@ float angle_protection = 15.0f; // 角度保护阈值
 float angle_gain_scale = 1.0f; // 角度环死区增益缩放（0-1），越小越平滑
 float gyro_gain_scale = 1.0f;  // 角速度环死区增益缩放（0-1）
 
+// 计算模式切换时把积分和上次误差换算到新模式的状态中，切换前后输出连续，不会用到另一模式的旧状态
+static void pid_sync_mode(PID_Controller *pid)
+{
+    if (pid->fixed_point_active == pid->fixed_point)
+        return;
+
+    if (pid->fixed_point)
+    {
+        pid->q.integral = pid_q_from_float(pid->integral);
+        pid->q.last_error = pid_q_from_float(pid->last_error);
+    }
+    else
+    {
+        pid->integral = pid_q_to_float(pid->q.integral);
+        pid->last_error = pid_q_to_float(pid->q.last_error);
+    }
+    pid->fixed_point_active = pid->fixed_point;
+}
+
+// 定点PID计算：输入已换算为Q16.16，参数随浮点参数更新，误差和输出写回浮点字段供状态查询
+static float pid_calculate_fixed(PID_Controller *pid, int32 target, int32 current)
+{
+    pid_q_update_params(&pid->q, pid->kp, pid->ki, pid->kd, pid->max_integral, pid->max_output);
+    pid_q_calculate(&pid->q, target, current);
+
+    pid->error = pid_q_to_float(pid->q.error);
+    pid->output = pid_q_to_float(pid->q.output);
+    return pid->output;
+}
+
+// PID计算函数（整数输入）：定点模式下输入直接移位换算，浮点模式与pid_calculate()相同
+float pid_calculate_int(PID_Controller *pid, int32 target, int32 current)
+{
+    pid_sync_mode(pid);
+    if (pid->fixed_point)
+        return pid_calculate_fixed(pid, pid_q_from_int(target), pid_q_from_int(current));
+
+    return pid_calculate(pid, (float)target, (float)current);
+}
+
 // PID计算函数
 float pid_calculate(PID_Controller *pid, float target, float current)
 {
+    pid_sync_mode(pid);
+    if (pid->fixed_point)
+        return pid_calculate_fixed(pid, pid_q_from_float(target), pid_q_from_float(current));
+
     // 计算误差
     pid->error = target - current;
 
@@ -115,20 +159,24 @@ float pid_calculate(PID_Controller *pid, float target, float current)
 
     return pid->output;
 }
+// 清空积分项（浮点与定点状态都清空）
+void pid_clear_integral(PID_Controller *pid)
+{
+    pid->integral = 0.0f;
+    pid->q.integral = 0;
+}
+
 /**
  * @brief 角速度环控制（最内环）
  * @param angle_control 角度环的输出，作为角速度环的目标值
  */
 void gyro_loop_control(int angle_control)
 {
-    // 将角度环输出作为角速度目标值
-    float target_gyro = (float)angle_control;
-
-    // 使用IMU中已经滤波后的陀螺仪数据
-    float current_gyro_y = (float)imu_data.gyro_y;
+    uint32 prof_start = prof_begin();
 
-    // 角速度环PID计算（使用IMU中已滤波的陀螺仪数据）
-    float motor_output = pid_calculate(&gyro_pid, target_gyro, current_gyro_y);
+    // 角速度环PID计算：目标值为角度环输出，反馈为IMU中已经滤波后的陀螺仪数据
+    // 两者都是整数，定点模式下直接移位换算（饱和范围见pid_q.h）
+    float motor_output = pid_calculate_int(&gyro_pid, angle_control, imu_data.gyro_y);
 
     // 对PID输出进行一阶低通滤波，减少输出抖动
     // filtered_value = α * current_value + (1-α) * previous_filtered_value
@@ -136,6 +184,8 @@ void gyro_loop_control(int angle_control)
 
     // 控制电机（motor_control_with_protection内部会检查enable标志）
     momentum_wheel_control((int16_t)filtered_motor_output);
+
+    prof_end(PROF_GYRO_LOOP, prof_start);
 }
 
 /**
@@ -144,6 +194,8 @@ void gyro_loop_control(int angle_control)
  */
 void angle_loop_control(int speed_control)
 {
+    uint32 prof_start = prof_begin();
+
     // 计算转弯补偿角度（使用实际舵机角度和当前图像误差）
     float current_speed = (float)encoder[1];
     float turn_compensation = turn_compensation_calculate(current_servo_angle, current_speed, current_image_error);
@@ -156,6 +208,8 @@ void angle_loop_control(int speed_control)
 
     // 角度环PID计算
     angle_gyro_target = pid_calculate(&angle_pid, target_angle_with_comp, current_pitch);
+
+    prof_end(PROF_ANGLE_LOOP, prof_start);
 }
 
 /**
@@ -163,89 +217,75 @@ void angle_loop_control(int speed_control)
  */
 void speed_loop_control(void)
 {
+    uint32 prof_start = prof_begin();
+
     // 速度环PID计算，输出作为角度偏移
     float speed_angle_offset = pid_calculate(&speed_pid, target_speed, encoder[0]);
 
     // 更新期望角度
     desired_angle = target_angle + speed_angle_offset;
+
+    prof_end(PROF_SPEED_LOOP, prof_start);
+}
+
+// *************************** 1ms控制任务表 ***************************
+
+static void task_gyro_loop(void)
+{
+    gyro_loop_control((int)angle_gyro_target);
+}
+
+static void task_angle_loop(void)
+{
+    angle_loop_control(0); // 速度环输出通过desired_angle传递
 }
 
+// 同一节拍内按表中顺序执行：先做传感器采集，再按串级由外到内运行控制环（速度环 -> 角度环 -> 角速度环），
+// 外环在本节拍更新的目标值立即被同一节拍的内环使用（t%10==6时角度环与角速度环同拍，角速度环用的是刚算出的目标）
+// 相位：2ms任务落在偶数节拍，5ms任务落在 t%5==1，20ms任务落在 t%20==3 和 t%20==13（均为奇数且 t%5==3），
+// 单节拍最多运行4个任务（原取模调度在 t%20==0 时7个任务同时运行）
+// 只初始化配置字段，运行统计字段（countdown起）为0，由sched_init()设置
+Sched_Task control_tasks[] = {
+    {.name = "IMU",      .run = imu_update,                    .period_ms = 2,  .phase_ms = 0,  .budget_us = 150, .flags = SCHED_ALWAYS},
+    {.name = "DriveEnc", .run = motor_encoder_update_drive,    .period_ms = 5,  .phase_ms = 1,  .budget_us = 10,  .flags = SCHED_ALWAYS},      // 与转弯补偿同步
+    {.name = "MomEnc",   .run = motor_encoder_update_momentum, .period_ms = 20, .phase_ms = 3,  .budget_us = 10,  .flags = SCHED_ALWAYS},
+    {.name = "Speed",    .run = speed_loop_control,            .period_ms = 20, .phase_ms = 3,  .budget_us = 20,  .flags = SCHED_NEED_ENABLE},
+    {.name = "DriveSpd", .run = drive_speed_loop_control,      .period_ms = 20, .phase_ms = 13, .budget_us = 20,  .flags = SCHED_NEED_ENABLE},
+    {.name = "Angle",    .run = task_angle_loop,               .period_ms = 5,  .phase_ms = 1,  .budget_us = 40,  .flags = SCHED_NEED_ENABLE}, // 内部包含转弯补偿
+    {.name = "Gyro",     .run = task_gyro_loop,                .period_ms = 2,  .phase_ms = 0,  .budget_us = 20,  .flags = SCHED_NEED_ENABLE},
+};
+const uint8 control_task_num = sizeof(control_tasks) / sizeof(control_tasks[0]);
+
 /**
  * @brief 主控制函数
  */
 void control(void)
 {
-    count++;
-    // 传感器数据更新
-    if (count % 2 == 0)
-    {
-        imu_update();
-    }
-    // 动量轮速度环周期采集编码器数据（20ms周期）
-    if (count % 20 == 0)
-    {
-        motor_encoder_update_momentum();
-    }
-    // 行进轮编码器采集（5ms周期，与转弯补偿同步）
-    if (count % 5 == 0)
-    {
-        motor_encoder_update_drive();
-    }
-    // printf("%f,%d\r\n", imu_data.pitch, imu_data.gyro_y);
-    //  如果未启用控制，停止电机并返回
+    uint32 prof_control = prof_begin();
+
+    // 如果未启用控制，停止电机；传感器采集任务照常运行
     if (!enable)
     {
         momentum_wheel_control(0);
         drive_wheel_control(0);
-        return;
     }
-
-    // 延迟停车更新（只有enable为true时才计时）
-    delayed_stop_update();
-
-    motor_protection_update();
-
-    // 角度在±200范围内时清空积分项，重新开始积分
-    // if (imu_data.pitch >= -200.0f && imu_data.pitch <= 200.0f)
-    // {
-    //     gyro_pid.integral = 0.0f;
-    //     angle_pid.integral = 0.0f;
-    //     speed_pid.integral = 0.0f;
-    //     drive_speed_pid.integral = 0.0f;
-    // }
-
-    // 速度环控制（20ms周期，每20个1ms周期执行一次）
-    if (count % 20 == 0)
+    else
     {
-        speed_loop_control();
-    }
+        // 延迟停车更新（只有enable为true时才计时）
+        delayed_stop_update();
 
-    // 角度环控制（5ms周期，每5个1ms周期执行一次，内部包含转弯补偿）
-    if (count % 5 == 0)
-    {
-        angle_loop_control(0); // 速度环输出通过desired_angle传递
+        uint32 prof_protection = prof_begin();
+        motor_protection_update();
+        prof_end(PROF_PROTECTION, prof_protection);
     }
 
-    // 角速度环控制（2ms周期，每次都执行）
-    if (count % 2 == 0)
-    {
-        gyro_loop_control((int)angle_gyro_target);
-    }
-    // 行进轮速度环控制（20ms周期，每20个1ms周期执行一次）
-    if (count % 20 == 0)
-    {
+    // 按任务表运行到期的采集与控制任务
+    sched_tick(control_tasks, control_task_num, enable);
 
-        drive_speed_loop_control();
-    }
+    prof_end(PROF_CONTROL, prof_control);
 
     // 转向PID控制在主循环中调用（需要最新的图像数据）
     // 不在中断中调用，避免阻塞中断和重复调用
-
-    // 防止计数器溢出
-    if (count >= 1000)
-    {
-        count = 0;
-    }
 }
 
 /**
@@ -258,21 +298,25 @@ void pid_init(void)
     gyro_pid.last_error = 0;
     gyro_pid.integral = 0;
     gyro_pid.output = 0;
+    pid_q_reset(&gyro_pid.q);
 
     angle_pid.error = 0;
     angle_pid.last_error = 0;
     angle_pid.integral = 0;
     angle_pid.output = 0;
+    pid_q_reset(&angle_pid.q);
 
     speed_pid.error = 0;
     speed_pid.last_error = 0;
     speed_pid.integral = 0;
     speed_pid.output = 0;
+    pid_q_reset(&speed_pid.q);
 
     drive_speed_pid.error = 0;
     drive_speed_pid.last_error = 0;
     drive_speed_pid.integral = 0;
     drive_speed_pid.output = 0;
+    pid_q_reset(&drive_speed_pid.q);
 
     steer_pid.error = 0;
     steer_pid.last_error = 0;
@@ -281,6 +325,9 @@ void pid_init(void)
 
     // 初始化滤波器状态
     filtered_motor_output = 0.0f;
+
+    // 按相位初始化控制任务表
+    sched_init(control_tasks, control_task_num);
 }
 
 /**
@@ -400,6 +447,8 @@ void get_pid_status(float *gyro_error, float *angle_error, float *speed_error,
  */
 void drive_speed_loop_control(void)
 {
+    uint32 prof_start = prof_begin();
+
     // 根据使能开关选择控制模式
     if (drive_speed_enable)
     {
@@ -414,6 +463,8 @@ void drive_speed_loop_control(void)
 
     // 控制行进轮电机
     drive_wheel_control((int16)drive_pwm_output);
+
+    prof_end(PROF_DRIVE_LOOP, prof_start);
 }
 
 /**
@@ -450,10 +501,11 @@ float get_angle_protection(void)
 
 /**
  * @brief 转向PID控制
+ * @param image_error 图像中线偏差（由视觉任务通过邮箱给出，即err_sum_average的结果）
  * @note P环基于图像中线偏差，D环基于陀螺仪gz（Z轴角速度）
  *       输出控制舵机打角
  */
-void steer_pid_control(void)
+void steer_pid_control(float image_error)
 {
     // 检查转向环是否启用
     if (!steer_enable)
@@ -465,10 +517,7 @@ void steer_pid_control(void)
         return;
     }
 
-    // 1. 计算图像中线偏差（P环）
-    float image_error = err_sum_average((uint8)steer_sample_start, (uint8)steer_sample_end);
-
-    // 保存图像误差供转弯补偿使用
+    // 1. 保存图像误差供转弯补偿使用
     current_image_error = image_error;
 
     // 2. 获取陀螺仪gz（Z轴角速度，偏航角速度）作为D环
@@ -15,6 +15,8 @@
 #include "zf_common_headfile.h"
 #include "motor.h"
 #include "imu.h"
+#include "scheduler.h"
+#include "pid_q.h"
 
 #define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
 
@@ -31,6 +33,9 @@ typedef struct
     float output;       // 输出值
     float max_integral; // 积分限幅
     float max_output;   // 输出限幅
+    uint32 fixed_point; // 定点计算开关（0=浮点，1=Q16.16定点，见pid_q.h），菜单可调
+    uint32 fixed_point_active; // 上次计算实际使用的模式（与fixed_point不同时先同步积分和上次误差）
+    PID_Q q;            // 定点计算的参数与状态
 } PID_Controller;
 
 // 全局变量声明
@@ -79,10 +84,16 @@ extern float drive_open_loop_output; // 行进轮开环输出值（PWM值，-100
 // 输出平滑参数（导出到菜单）
 extern float output_filter_coeff; // 输出滤波系数
 
+// 1ms控制任务表（导出到菜单显示运行统计）
+extern Sched_Task control_tasks[];
+extern const uint8 control_task_num;
+
 // 函数声明
 void pid_init(void);
 void pid_reset(void);
 float pid_calculate(PID_Controller *pid, float target, float current);
+float pid_calculate_int(PID_Controller *pid, int32 target, int32 current);
+void pid_clear_integral(PID_Controller *pid);
 
 void data_acquisition(void);
 void gyro_loop_control(int angle_control);
@@ -113,7 +124,7 @@ float get_angle_deadzone(void);
 float get_angle_protection(void);
 
 // 转向PID控制函数
-void steer_pid_control(void);               // 转向PID控制（图像偏差P + 陀螺仪gz D）
+void steer_pid_control(float image_error);  // 转向PID控制（图像偏差P + 陀螺仪gz D）
 void set_steer_pid_params(float kp, float kd, float limit); // 设置转向PID参数
 
 #endif
@@ -0,0 +1,104 @@
+/*********************************************************************
+ * 文件: pid_q.c
+ * Q16.16定点PID实现文件
+ * 说明：计算步骤与pid.c中的pid_calculate()逐项对应，区别只在数值表示和饱和处理
+ ********************************************************************/
+
+#include "pid_q.h"
+
+//============================================================
+// 内部函数
+//============================================================
+
+/**
+ * @brief int64饱和到Q16.16范围
+ */
+static inline int32 pid_q_saturate(int64 value)
+{
+    if (value > PID_Q_MAX)
+        return PID_Q_MAX;
+    if (value < PID_Q_MIN)
+        return PID_Q_MIN;
+    return (int32)value;
+}
+
+/**
+ * @brief 限幅（limit为非负数）
+ */
+static inline int32 pid_q_clamp(int32 value, int32 limit)
+{
+    if (value > limit)
+        return limit;
+    if (value < -limit)
+        return -limit;
+    return value;
+}
+
+//============================================================
+// 函数实现
+//============================================================
+
+/**
+ * @brief 更新定点参数
+ */
+void pid_q_update_params(PID_Q *pid, float kp, float ki, float kd, float max_integral, float max_output)
+{
+    if (kp == pid->src_kp && ki == pid->src_ki && kd == pid->src_kd &&
+        max_integral == pid->src_max_integral && max_output == pid->src_max_output)
+        return;
+
+    pid->src_kp = kp;
+    pid->src_ki = ki;
+    pid->src_kd = kd;
+    pid->src_max_integral = max_integral;
+    pid->src_max_output = max_output;
+
+    pid->kp = pid_q_from_float(kp);
+    pid->ki = pid_q_from_float(ki);
+    pid->kd = pid_q_from_float(kd);
+    // 限幅值取绝对值，保证pid_q_clamp的上下限有序
+    pid->max_integral = pid_q_from_float(max_integral >= 0.0f ? max_integral : -max_integral);
+    pid->max_output = pid_q_from_float(max_output >= 0.0f ? max_output : -max_output);
+}
+
+/**
+ * @brief 清零定点PID状态
+ */
+void pid_q_reset(PID_Q *pid)
+{
+    pid->error = 0;
+    pid->last_error = 0;
+    pid->integral = 0;
+    pid->derivative = 0;
+    pid->output = 0;
+}
+
+/**
+ * @brief 定点PID计算
+ */
+int32 pid_q_calculate(PID_Q *pid, int32 target, int32 current)
+{
+    int64 sum;
+
+    // 计算误差
+    pid->error = pid_q_saturate((int64)target - current);
+
+    // 积分项计算（带积分限幅）
+    pid->integral = pid_q_clamp(pid_q_saturate((int64)pid->integral + pid->error), pid->max_integral);
+
+    // 微分项计算
+    pid->derivative = pid_q_saturate((int64)pid->error - pid->last_error);
+
+    // PID输出计算：每个乘积为Q32.32，右移回Q16.16后求和，三项之和不会超出int64
+    sum = (((int64)pid->kp * pid->error) >> PID_Q_SHIFT) +
+          (((int64)pid->ki * pid->integral) >> PID_Q_SHIFT) +
+          (((int64)pid->kd * pid->derivative) >> PID_Q_SHIFT);
+
+    // 输出限幅
+    pid->output = pid_q_clamp(pid_q_saturate(sum), pid->max_output);
+
+    // 保存当前误差供下次使用
+    pid->last_error = pid->error;
+
+    return pid->output;
+}
@@ -0,0 +1,124 @@
+/*********************************************************************
+ * 文件: pid_q.h
+ * Q16.16定点PID头文件
+ * 说明：与pid_calculate()相同的计算步骤（误差、积分累加并限幅、误差差分、三项加权后输出限幅），
+ *       状态和参数均为Q16.16定点数（int32，1.0 = 65536，范围约±32768），加减运算饱和，
+ *       乘积先右移再求和（中间值为int64），任何输入都不会溢出回绕
+ *       参数仍以PID_Controller中的浮点值为准，菜单修改后由pid_q_update_params()检测变化并重新换算
+ *       饱和范围与控制环输入的关系（以角速度环为例）：陀螺仪量程±2000dps、14.3LSB/(°/s)，
+ *       imu_data.gyro_y不超过±28600，目标值为角度环输出（限幅±3000），误差不超过±31600，
+ *       不会触发±32768饱和；kp*误差可能超出±32768而饱和，但输出限幅（8000）远小于饱和值，结果与浮点计算相同。
+ *       其余各环的输入（角度、编码器计数）远小于饱和范围；若改用±32768以上的输入或限幅，定点结果会与浮点不同
+ ********************************************************************/
+
+#ifndef _PID_Q_H
+#define _PID_Q_H
+
+#include "zf_common_typedef.h"
+
+//============================================================
+// 宏定义
+//============================================================
+
+#define PID_Q_SHIFT 16                 // 小数位数
+#define PID_Q_ONE (1L << PID_Q_SHIFT)  // 1.0
+#define PID_Q_MAX ((int32)0x7FFFFFFF)  // 最大值（约32768.0）
+#define PID_Q_MIN (-PID_Q_MAX)         // 最小值（取对称值，取反不溢出）
+
+//============================================================
+// 类型定义
+//============================================================
+
+typedef struct
+{
+    // 参数（Q16.16）
+    int32 kp;           // 比例系数
+    int32 ki;           // 积分系数
+    int32 kd;           // 微分系数
+    int32 max_integral; // 积分限幅
+    int32 max_output;   // 输出限幅
+
+    // 状态（Q16.16）
+    int32 error;      // 当前误差
+    int32 last_error; // 上次误差
+    int32 integral;   // 积分累积
+    int32 derivative; // 微分项
+    int32 output;     // 输出值
+
+    // 换算参数时使用的浮点值（用于检测参数变化）
+    float src_kp, src_ki, src_kd, src_max_integral, src_max_output;
+} PID_Q;
+
+//============================================================
+// 函数声明
+//============================================================
+
+/**
+ * @brief 浮点数转Q16.16（四舍五入，超出范围时饱和）
+ * @param value 浮点数
+ * @return Q16.16定点数
+ */
+static inline int32 pid_q_from_float(float value)
+{
+    float scaled = value * (float)PID_Q_ONE;
+
+    if (scaled >= 2147483520.0f) // 小于2^31的最大单精度浮点数
+        return PID_Q_MAX;
+    if (scaled <= -2147483520.0f)
+        return PID_Q_MIN;
+    return (int32)(scaled + (scaled >= 0.0f ? 0.5f : -0.5f));
+}
+
+/**
+ * @brief 整数转Q16.16（移位，超出范围时饱和）
+ * @param value 整数
+ * @return Q16.16定点数
+ * @note 输入本身是整数的控制环（如角速度环的陀螺仪原始数据）用此函数，省去浮点乘法和舍入
+ */
+static inline int32 pid_q_from_int(int32 value)
+{
+    if (value >= (PID_Q_MAX >> PID_Q_SHIFT) + 1)
+        return PID_Q_MAX;
+    if (value <= -((PID_Q_MAX >> PID_Q_SHIFT) + 1))
+        return PID_Q_MIN;
+    return value * PID_Q_ONE;
+}
+
+/**
+ * @brief Q16.16转浮点数
+ * @param value Q16.16定点数
+ * @return 浮点数
+ */
+static inline float pid_q_to_float(int32 value)
+{
+    return (float)value * (1.0f / (float)PID_Q_ONE);
+}
+
+/**
+ * @brief 更新定点参数
+ * @param pid 定点PID
+ * @param kp 比例系数
+ * @param ki 积分系数
+ * @param kd 微分系数
+ * @param max_integral 积分限幅
+ * @param max_output 输出限幅
+ * @note 每次计算前调用，参数与上次相同时只做比较，不做换算
+ */
+void pid_q_update_params(PID_Q *pid, float kp, float ki, float kd, float max_integral, float max_output);
+
+/**
+ * @brief 清零定点PID状态（参数保留）
+ * @param pid 定点PID
+ */
+void pid_q_reset(PID_Q *pid);
+
+/**
+ * @brief 定点PID计算
+ * @param pid 定点PID
+ * @param target 目标值（Q16.16）
+ * @param current 当前值（Q16.16）
+ * @return 输出值（Q16.16），同时保存在pid->output
+ */
+int32 pid_q_calculate(PID_Q *pid, int32 target, int32 current);
+
+#endif
@@ -0,0 +1,99 @@
+/*********************************************************************
+ * 文件: profiler.c
+ * 控制中断与主循环分段耗时统计实现文件
+ * 说明：打点函数在profiler.h中内联，这里只有显示用的换算、清零和串口输出；
+ *       串口输出的统计表后附调度器单节拍最长耗时和各元素检测器的运行统计
+ ********************************************************************/
+
+#include "profiler.h"
+#include "element.h"
+#include "pid.h"
+#include "scheduler.h"
+#include "zf_common_headfile.h"
+#include <stdio.h>
+#include <string.h>
+
+//============================================================
+// 全局变量定义
+//============================================================
+
+Stm_Stat prof_stats[PROF_SECTION_NUM];  // 各分段统计
+
+const char *const prof_section_name[PROF_SECTION_NUM] = {
+    "Control",
+    "ImuRead",
+    "Attitude",
+    "Kalman",
+    "Protect",
+    "GyroLoop",
+    "AngLoop",
+    "SpdLoop",
+    "DrvLoop",
+    "Steer",
+};
+
+//============================================================
+// 函数实现
+//============================================================
+
+/**
+ * @brief 计算分段平均耗时
+ */
+uint32 prof_mean_ticks(Prof_Section section)
+{
+    return stm_stat_mean(&prof_stats[section]);
+}
+
+/**
+ * @brief 清零全部统计
+ */
+void prof_reset(void)
+{
+    memset(prof_stats, 0, sizeof(prof_stats));
+}
+
+/**
+ * @brief 经调试串口输出统计表
+ */
+void prof_dump(void)
+{
+    uint8 i;
+
+    printf("section,count,min_us,mean_us,max_us\r\n");
+    for (i = 0; i < PROF_SECTION_NUM; i++)
+    {
+        uint32 mean = prof_mean_ticks((Prof_Section)i);
+
+        // STM计数为10ns，输出保留两位小数
+        printf("%s,%lu,%lu.%02lu,%lu.%02lu,%lu.%02lu\r\n", prof_section_name[i],
+               (unsigned long)prof_stats[i].count,
+               (unsigned long)(prof_stats[i].min / STM_TICKS_PER_US), (unsigned long)(prof_stats[i].min % STM_TICKS_PER_US),
+               (unsigned long)(mean / STM_TICKS_PER_US), (unsigned long)(mean % STM_TICKS_PER_US),
+               (unsigned long)(prof_stats[i].max / STM_TICKS_PER_US), (unsigned long)(prof_stats[i].max % STM_TICKS_PER_US));
+    }
+    printf("tick_max_us,%lu.%02lu\r\n", (unsigned long)(sched_tick_ticks_max / STM_TICKS_PER_US),
+           (unsigned long)(sched_tick_ticks_max % STM_TICKS_PER_US));
+    element_stats_dump();
+}
+
+/**
+ * @brief 查询调试串口命令并执行
+ */
+void prof_poll_command(void)
+{
+#if DEBUG_UART_USE_INTERRUPT // 调试串口接收中断开启时才有接收缓冲区
+    uint8 cmd;
+
+    while (debug_read_ring_buffer(&cmd, 1))
+    {
+        if (cmd == PROFILER_CMD_DUMP)
+            prof_dump();
+        else if (cmd == PROFILER_CMD_RESET)
+        {
+            prof_reset();
+            sched_stats_reset(control_tasks, control_task_num);
+            element_stats_reset();
+        }
+    }
+#endif
+}
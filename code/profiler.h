@@ -0,0 +1,103 @@
+/*********************************************************************
+ * 文件: profiler.h
+ * 控制中断与主循环分段耗时统计头文件
+ * 说明：在待测代码前后各读一次STM0计数（prof_begin / prof_end），按分段累计次数和最小/平均/最大耗时
+ *       统计表大小固定，记录一次只有两次定时器读取和几次比较、加法，不做除法，比赛程序中可以保持开启
+ *       每个分段只由一个执行上下文写入（1ms中断或主循环）；中断允许嵌套，被更高优先级中断打断时耗时包含打断时间
+ ********************************************************************/
+
+#ifndef _PROFILER_H
+#define _PROFILER_H
+
+#include "zf_common_typedef.h"
+#include "stm_stat.h"
+#include "IfxStm.h"
+
+//============================================================
+// 宏定义
+//============================================================
+
+#define PROFILER_ENABLE 1          // 分段耗时统计开关（0时打点函数为空）
+#define PROFILER_CMD_DUMP 'p'      // 调试串口命令：输出统计表
+#define PROFILER_CMD_RESET 'c'     // 调试串口命令：清零统计
+
+// 统计分段
+typedef enum
+{
+    PROF_CONTROL = 0,  // 1ms控制中断 control() 整体
+    PROF_IMU_READ,     // IMU原始数据读取 imu_get_data()
+    PROF_ATTITUDE,     // 姿态解算 imu_calculate_attitude()
+    PROF_KALMAN,       // EKF中的 Kalman_Filter_Update()（仅EKF算法）
+    PROF_PROTECTION,   // 电机保护 motor_protection_update()
+    PROF_GYRO_LOOP,    // 角速度环
+    PROF_ANGLE_LOOP,   // 角度环（含转弯补偿）
+    PROF_SPEED_LOOP,   // 动量轮速度环
+    PROF_DRIVE_LOOP,   // 行进轮速度环
+    PROF_STEER,        // 主循环转向控制 steer_pid_control()
+    PROF_SECTION_NUM
+} Prof_Section;
+
+//============================================================
+// 全局变量声明
+//============================================================
+
+extern Stm_Stat prof_stats[PROF_SECTION_NUM];                   // 各分段统计
+extern const char *const prof_section_name[PROF_SECTION_NUM];   // 分段名称（显示用，不超过8个字符）
+
+//============================================================
+// 函数声明
+//============================================================
+
+/**
+ * @brief 分段开始打点
+ * @return 开始时刻（STM0计数），传给prof_end
+ */
+static inline uint32 prof_begin(void)
+{
+#if PROFILER_ENABLE
+    return IfxStm_getLower(&MODULE_STM0);
+#else
+    return 0;
+#endif
+}
+
+/**
+ * @brief 分段结束打点并累计统计
+ * @param section 分段
+ * @param start prof_begin()的返回值
+ */
+static inline void prof_end(Prof_Section section, uint32 start)
+{
+#if PROFILER_ENABLE
+    stm_stat_record(&prof_stats[section], IfxStm_getLower(&MODULE_STM0) - start);
+#else
+    (void)section;
+    (void)start;
+#endif
+}
+
+/**
+ * @brief 计算分段平均耗时
+ * @param section 分段
+ * @return 平均耗时（STM计数），无样本时为0
+ */
+uint32 prof_mean_ticks(Prof_Section section);
+
+/**
+ * @brief 清零全部统计
+ */
+void prof_reset(void);
+
+/**
+ * @brief 经调试串口输出统计表（CSV，单位us）
+ * @note 分段统计表之后附调度器单节拍最长耗时和各元素检测器的运行统计（element_stats_dump()）
+ */
+void prof_dump(void);
+
+/**
+ * @brief 查询调试串口命令并执行
+ * @note 主循环中调用，收到PROFILER_CMD_DUMP输出统计表，收到PROFILER_CMD_RESET清零统计（含调度器和元素检测器统计），其他字符忽略
+ */
+void prof_poll_command(void);
+
+#endif
@@ -0,0 +1,91 @@
+/*********************************************************************
+ * 文件: scheduler.c
+ * 1ms控制中断的表驱动多速率调度器实现文件
+ * 说明：任务表由使用者定义（控制任务表见pid.c），这里只负责到期判断、执行与计时
+ ********************************************************************/
+
+#include "scheduler.h"
+#include "stm_stat.h"
+#include "zf_common_headfile.h"
+#include "IfxStm.h"
+
+//============================================================
+// 全局变量定义
+//============================================================
+
+uint32 sched_tick_ticks = 0;     // 最近一个节拍内任务的总执行时间
+uint32 sched_tick_ticks_max = 0; // 单节拍最长总执行时间
+
+//============================================================
+// 函数实现
+//============================================================
+
+/**
+ * @brief 按相位初始化任务表
+ */
+void sched_init(Sched_Task *tasks, uint8 num)
+{
+    uint8 i;
+
+    for (i = 0; i < num; i++)
+    {
+        tasks[i].countdown = tasks[i].phase_ms;
+    }
+    sched_stats_reset(tasks, num);
+}
+
+/**
+ * @brief 执行一个节拍
+ */
+void sched_tick(Sched_Task *tasks, uint8 num, uint8 enabled)
+{
+    Sched_Task *task;
+    uint32 tick_start = IfxStm_getLower(&MODULE_STM0);
+    uint32 start;
+
+    for (task = tasks; task < tasks + num; task++)
+    {
+        // 1. 到期判断：计数为0时到期并重装周期
+        if (task->countdown != 0)
+        {
+            task->countdown--;
+            continue;
+        }
+        task->countdown = task->period_ms - 1;
+
+        if ((task->flags & SCHED_NEED_ENABLE) && !enabled)
+            continue;
+
+        // 2. 运行并计时
+        start = IfxStm_getLower(&MODULE_STM0);
+        task->run();
+        task->last_ticks = IfxStm_getLower(&MODULE_STM0) - start;
+        if (task->last_ticks > task->max_ticks)
+            task->max_ticks = task->last_ticks;
+        if (task->last_ticks > (uint32)task->budget_us * STM_TICKS_PER_US)
+            task->overrun_count++;
+        task->run_count++;
+    }
+
+    sched_tick_ticks = IfxStm_getLower(&MODULE_STM0) - tick_start;
+    if (sched_tick_ticks > sched_tick_ticks_max)
+        sched_tick_ticks_max = sched_tick_ticks;
+}
+
+/**
+ * @brief 清零任务表的运行统计
+ */
+void sched_stats_reset(Sched_Task *tasks, uint8 num)
+{
+    uint8 i;
+
+    for (i = 0; i < num; i++)
+    {
+        tasks[i].run_count = 0;
+        tasks[i].overrun_count = 0;
+        tasks[i].last_ticks = 0;
+        tasks[i].max_ticks = 0;
+    }
+    sched_tick_ticks = 0;
+    sched_tick_ticks_max = 0;
+}
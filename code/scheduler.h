@@ -0,0 +1,77 @@
+/*********************************************************************
+ * 文件: scheduler.h
+ * 1ms控制中断的表驱动多速率调度器头文件
+ * 说明：同一节拍内按任务表顺序执行（串级控制环应由外到内排列，见pid.c的控制任务表），每个任务有固定的相位偏移，
+ *       相位错开后不同周期的任务不会每隔几毫秒同时落在一个节拍上，单节拍最坏耗时更平稳
+ *       每个任务用递减计数器判断是否到期，不做取模运算；记录每个任务和每个节拍的执行时间
+ ********************************************************************/
+
+#ifndef _SCHEDULER_H
+#define _SCHEDULER_H
+
+#include "zf_common_typedef.h"
+
+//============================================================
+// 宏定义
+//============================================================
+
+// 任务运行条件
+#define SCHED_ALWAYS 0        // 每个到期节拍都运行（传感器采集）
+#define SCHED_NEED_ENABLE 1   // 仅在控制使能（enable为真）时运行（控制环）
+
+//============================================================
+// 类型定义
+//============================================================
+
+typedef struct
+{
+    const char *name;           // 任务名称（显示用）
+    void (*run)(void);          // 任务函数
+    uint16 period_ms;           // 周期（节拍数）
+    uint16 phase_ms;            // 相位偏移（第一次运行的节拍，须小于周期）
+    uint16 budget_us;           // 单次执行预算（超出计入overrun_count）
+    uint8 flags;                // 运行条件（SCHED_ALWAYS / SCHED_NEED_ENABLE）
+
+    // 运行统计（由调度器维护）
+    uint16 countdown;           // 距下次运行的节拍数
+    uint32 run_count;           // 运行次数
+    uint32 overrun_count;       // 超出预算次数
+    uint32 last_ticks;          // 最近一次执行时间（STM计数）
+    uint32 max_ticks;           // 最长执行时间（STM计数）
+} Sched_Task;
+
+//============================================================
+// 全局变量声明
+//============================================================
+
+extern uint32 sched_tick_ticks;     // 最近一个节拍内任务的总执行时间（STM计数）
+extern uint32 sched_tick_ticks_max; // 单节拍最长总执行时间（STM计数）
+
+//============================================================
+// 函数声明
+//============================================================
+
+/**
+ * @brief 按相位初始化任务表
+ * @param tasks 任务表
+ * @param num 任务数
+ */
+void sched_init(Sched_Task *tasks, uint8 num);
+
+/**
+ * @brief 执行一个节拍（在1ms中断中调用）
+ * @param tasks 任务表
+ * @param num 任务数
+ * @param enabled 控制是否使能（决定SCHED_NEED_ENABLE任务是否运行）
+ * @note 未使能时需要使能的任务到期也不运行，但计数照常推进，相位保持不变
+ */
+void sched_tick(Sched_Task *tasks, uint8 num, uint8 enabled);
+
+/**
+ * @brief 清零任务表的运行统计
+ * @param tasks 任务表
+ * @param num 任务数
+ */
+void sched_stats_reset(Sched_Task *tasks, uint8 num);
+
+#endif
@@ -0,0 +1,64 @@
+/*********************************************************************
+ * 文件: stm_stat.h
+ * STM0计时统计公共头文件
+ * 说明：STM0计数与微秒的换算常量，以及分段耗时统计（profiler）和延迟统计（latency）共用的
+ *       最小/平均/最大统计类型和记录函数；调度器、元素检测和逐帧输出的耗时换算也使用这里的常量
+ *       STM0计数为10ns，两个核心读到的是同一个计数器，可以跨核相减
+ ********************************************************************/
+
+#ifndef _STM_STAT_H
+#define _STM_STAT_H
+
+#include "zf_common_typedef.h"
+
+//============================================================
+// 宏定义
+//============================================================
+
+#define STM_TICKS_PER_US 100  // STM0每微秒计数
+
+//============================================================
+// 类型定义
+//============================================================
+
+typedef struct
+{
+    uint32 count; // 样本数
+    uint32 min;   // 最小值（STM计数）
+    uint32 max;   // 最大值（STM计数）
+    uint64 sum;   // 累加值（STM计数）
+} Stm_Stat;
+
+//============================================================
+// 函数声明
+//============================================================
+
+/**
+ * @brief 记录一个耗时样本
+ * @param stat 统计
+ * @param ticks 耗时（STM计数）
+ * @note 只有几次比较和加法，不做除法，可以在中断和图像处理热路径上调用
+ */
+static inline void stm_stat_record(Stm_Stat *stat, uint32 ticks)
+{
+    if (stat->count == 0 || ticks < stat->min)
+        stat->min = ticks;
+    if (ticks > stat->max)
+        stat->max = ticks;
+    stat->sum += ticks;
+    stat->count++;
+}
+
+/**
+ * @brief 计算平均耗时
+ * @param stat 统计
+ * @return 平均耗时（STM计数），无样本时为0
+ */
+static inline uint32 stm_stat_mean(const Stm_Stat *stat)
+{
+    if (stat->count == 0)
+        return 0;
+    return (uint32)(stat->sum / stat->count);
+}
+
+#endif
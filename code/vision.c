@@ -0,0 +1,174 @@
+/*********************************************************************************************************************
+ * TC264 Opensourec Library 即（TC264 开源库）是一个基于官方 SDK 接口的第三方开源库
+ * Copyright (c) 2022 SEEKFREE 逐飞科技
+ *
+ * 文件名称          vision.c - 视觉任务与结果邮箱实现
+ * 功能说明          在CPU1上运行图像处理流水线，通过无锁单写者邮箱把每帧结果交给CPU0的控制路径
+ * 开发环境          ADS v1.9.4
+ * 适用平台          TC264D
+ ********************************************************************************************************************/
+
+#include "vision.h"
+#include "zf_common_headfile.h"
+#include "IfxStm.h"
+
+// *************************** 邮箱结构体 ***************************
+typedef struct
+{
+    volatile uint32 seq;  // 顺序号（奇数=写入中，0=尚未写入）
+    Vision_Result result; // 最新一帧结果
+} vision_mailbox_t;
+
+// *************************** 静态变量 ***************************
+static vision_mailbox_t mailbox = {0};
+static uint32 last_frame_id = 0;     // 上一次处理的帧号（仅处理核心访问，0表示重新开始计数）
+static uint32 last_sequence = 0;     // 上一次使用的结果序号（仅控制核心访问）
+
+Vision_Frame_Stats vision_frame_stats = {0};
+
+// *************************** 外部变量引用 ***************************
+extern volatile bool enable;      // PID使能标志(定义在pid.c中)
+extern uint32 steer_sample_start; // 转向采样起始行(定义在pid.c中)
+extern uint32 steer_sample_end;   // 转向采样结束行(定义在pid.c中)
+extern uint32 steer_lookahead;    // 转向误差使用中线拟合前瞻点(定义在pid.c中)
+
+// *************************** 函数实现 ***************************
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介     视觉任务单步执行
+// 参数说明     void
+// 返回参数     uint8: 1=处理了一帧新图像，0=无新帧或未使能
+// 使用示例     while (TRUE) { vision_task(); }
+// 备注信息     取得新帧时执行图像处理并把结果写入邮箱，帧号取自采集驱动随帧返回的image_frame_id
+//-------------------------------------------------------------------------------------------------------------------
+uint8 vision_task(void)
+{
+    Vision_Result result;
+    uint32 frame_id;
+    uint32 start;
+
+    if (!enable)
+    {
+        // 未运行时不获取帧（菜单页面在CPU0上获取），重新使能时从头计数，停止期间的帧不记为丢帧
+        last_frame_id = 0;
+        return 0;
+    }
+
+    // 图像处理（边界提取 + 元素识别），没有新帧时直接返回
+    start = IfxStm_getLower(&MODULE_STM0);
+    if (!image_process_latest(1))
+    {
+        return 0;
+    }
+    frame_id = image_frame_id;
+
+    // 两次处理之间被覆盖的帧记为丢帧
+    if (last_frame_id != 0)
+    {
+        vision_frame_stats.dropped += frame_id - last_frame_id - 1;
+    }
+    last_frame_id = frame_id;
+
+    // 打包本帧结果
+    vision_frame_stats.processed++;
+    result.frame_id = frame_id;
+    result.sequence = vision_frame_stats.processed;
+    if (steer_lookahead && centerline.valid)
+    {
+        // 前瞻点横向偏差（mm）按采样段中间行的横向比例折算为像素，沿用原转向PID参数量级
+        float scale = ipm_row_lateral[(steer_sample_start + steer_sample_end) >> 1];
+        result.steer_error = (scale > 0) ? -centerline.offset_mm / scale : 0;
+    }
+    else
+    {
+        result.steer_error = err_sum_average((uint8)steer_sample_start, (uint8)steer_sample_end);
+    }
+    result.heading = centerline.valid ? centerline.heading : 0;
+    result.curvature = centerline.valid ? centerline.curvature : 0;
+    result.search_stop_line = (int16)Search_Stop_Line;
+    result.cross_flag = (uint8)Cross_Flag;
+    result.ramp_flag = (uint8)Ramp_Flag;
+    result.island_state = (uint8)Island_State;
+    result.zebra_flag = (uint8)Zebra_Stripes_Flag;
+    result.vsync_stamp = image_frame_stamp;
+    result.timestamp = IfxStm_getLower(&MODULE_STM0);
+
+    vision_mailbox_publish(&result);
+
+    // 逐帧结果输出（供上位机回放比对），发布结果之后再输出，不增加控制延迟
+    if (frame_log_stream && (result.sequence % frame_log_stream) == 0)
+    {
+        frame_log_csv_line(frame_id, result.steer_error, result.timestamp - start);
+    }
+    return 1;
+}
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介     写入视觉结果邮箱（单写者）
+// 参数说明     result: 本帧结果
+// 返回参数     void
+// 使用示例     vision_mailbox_publish(&result);
+// 备注信息     序号先变奇数再写数据，写完变回偶数；__dsync保证另一个核心看到的写入顺序
+//-------------------------------------------------------------------------------------------------------------------
+void vision_mailbox_publish(const Vision_Result *result)
+{
+    mailbox.seq++;
+    __dsync();
+    mailbox.result = *result;
+    __dsync();
+    mailbox.seq++;
+}
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介     读取视觉结果邮箱（不阻塞）
+// 参数说明     result: 输出结果
+// 返回参数     uint8: 1=读取到完整结果，0=邮箱为空或与写入冲突
+// 使用示例     if (vision_mailbox_read(&result)) { ... }
+// 备注信息     读取期间若写者更新了邮箱（序号变化）则重试，最多VISION_MAILBOX_RETRY次
+//-------------------------------------------------------------------------------------------------------------------
+uint8 vision_mailbox_read(Vision_Result *result)
+{
+    for (uint8 retry = 0; retry < VISION_MAILBOX_RETRY; retry++)
+    {
+        uint32 seq = mailbox.seq;
+        if (seq == 0)
+        {
+            return 0; // 尚未有结果
+        }
+        if (seq & 1)
+        {
+            continue; // 正在写入
+        }
+        __dsync();
+        *result = mailbox.result;
+        __dsync();
+        if (mailbox.seq == seq)
+        {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介     获取尚未使用过的视觉结果（控制核心调用）
+// 参数说明     result: 输出结果
+// 返回参数     uint8: 1=有新结果，0=没有新结果
+// 使用示例     if (vision_result_poll(&result)) { steer_pid_control(result.steer_error); }
+// 备注信息     结果序号连续递增，序号跳变说明控制核心漏掉了中间的结果
+//-------------------------------------------------------------------------------------------------------------------
+uint8 vision_result_poll(Vision_Result *result)
+{
+    if (!vision_mailbox_read(result) || result->sequence == last_sequence)
+    {
+        return 0;
+    }
+
+    if (last_sequence != 0)
+    {
+        vision_frame_stats.steer_dropped += result->sequence - last_sequence - 1;
+    }
+    last_sequence = result->sequence;
+    vision_frame_stats.steer_used++;
+    return 1;
+}
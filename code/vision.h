@@ -0,0 +1,94 @@
+/*********************************************************************************************************************
+ * TC264 Opensourec Library 即（TC264 开源库）是一个基于官方 SDK 接口的第三方开源库
+ * Copyright (c) 2022 SEEKFREE 逐飞科技
+ *
+ * 文件名称          vision.h - 视觉任务与结果邮箱
+ * 功能说明          在CPU1上运行图像处理流水线，通过无锁单写者邮箱把每帧结果交给CPU0的控制路径
+ * 开发环境          ADS v1.9.4
+ * 适用平台          TC264D
+ ********************************************************************************************************************/
+
+#ifndef VISION_H
+#define VISION_H
+
+#include "zf_common_headfile.h"
+
+// *************************** 视觉任务说明 ***************************
+// 1. VISION_ON_CPU1为1时，CPU1循环调用vision_task()处理每一帧新图像；为0时由CPU0主循环调用
+// 2. 每帧处理完成后把结果（转向误差、元素标志、帧号、时间戳）写入邮箱
+// 3. 邮箱采用顺序锁：写者写入前后各把序号加1（奇数表示正在写入）
+//    读者读取前后序号一致且为偶数才认为读取有效，读取失败时直接返回，不会阻塞控制路径
+// 4. 只在enable为真（Cargo运行）时处理图像，菜单模式下的摄像头显示页面仍在CPU0上调用image_process()
+// 5. 帧计数：视觉核心统计处理帧数和未处理就被覆盖的摄像头帧数，
+//    控制核心通过vision_result_poll()统计用于转向的结果数和被新结果覆盖而未使用的结果数
+
+#define VISION_ON_CPU1 1         // 图像处理运行核心（1=CPU1，0=CPU0主循环）
+#define VISION_MAILBOX_RETRY 3   // 读取邮箱的最大尝试次数
+
+// *************************** 每帧视觉结果 ***************************
+typedef struct
+{
+    uint32 frame_id;         // 帧号（采集驱动随帧返回的image_frame_id）
+    uint32 sequence;         // 结果序号（视觉任务已处理的帧数，连续递增）
+    uint32 timestamp;        // 处理完成时刻（STM0计数值，两个核心可直接比较）
+    uint32 vsync_stamp;      // 本帧场同步时刻（STM0计数值，用于端到端延迟统计）
+    float steer_error;       // 转向误差（err_sum_average或前瞻偏差折算的像素值，正值偏右，负值偏左）
+    float heading;           // 前瞻点中线航向（dx/dy，中线拟合无效时为0）
+    float curvature;         // 前瞻点中线曲率（1/m，中线拟合无效时为0）
+    int16 search_stop_line;  // 边界搜索停止行
+    uint8 cross_flag;        // 十字路口标志
+    uint8 ramp_flag;         // 坡道标志
+    uint8 island_state;      // 环岛状态
+    uint8 zebra_flag;        // 斑马线标志
+} Vision_Result;
+
+// *************************** 帧统计 ***************************
+typedef struct
+{
+    volatile uint32 processed;      // 视觉任务已处理的帧数
+    volatile uint32 dropped;        // 视觉任务来不及处理、被新帧覆盖的摄像头帧数
+    volatile uint32 steer_used;     // 控制核心用于转向的结果数
+    volatile uint32 steer_dropped;  // 控制核心未读取、被新结果覆盖的结果数
+} Vision_Frame_Stats;
+
+extern Vision_Frame_Stats vision_frame_stats; // 帧统计（前两项由视觉核心写，后两项由控制核心写）
+
+// *************************** 函数声明 ***************************
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介     视觉任务单步执行
+// 参数说明     void
+// 返回参数     uint8: 1=处理了一帧新图像，0=无新帧或未使能
+// 使用示例     while (TRUE) { vision_task(); }
+// 备注信息     取得新帧时执行图像处理并把结果写入邮箱，应在VISION_ON_CPU1指定的核心循环调用
+//-------------------------------------------------------------------------------------------------------------------
+uint8 vision_task(void);
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介     写入视觉结果邮箱（单写者）
+// 参数说明     result: 本帧结果
+// 返回参数     void
+// 使用示例     vision_mailbox_publish(&result);
+// 备注信息     只允许一个核心调用
+//-------------------------------------------------------------------------------------------------------------------
+void vision_mailbox_publish(const Vision_Result *result);
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介     读取视觉结果邮箱（不阻塞）
+// 参数说明     result: 输出结果
+// 返回参数     uint8: 1=读取到完整结果，0=邮箱为空或连续VISION_MAILBOX_RETRY次与写入冲突
+// 使用示例     if (vision_mailbox_read(&result)) { ... }
+// 备注信息     读取失败时result内容未定义，调用者应继续使用上一次的结果
+//-------------------------------------------------------------------------------------------------------------------
+uint8 vision_mailbox_read(Vision_Result *result);
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介     获取尚未使用过的视觉结果（控制核心调用）
+// 参数说明     result: 输出结果
+// 返回参数     uint8: 1=有新结果，0=没有新结果
+// 使用示例     if (vision_result_poll(&result)) { steer_pid_control(result.steer_error); }
+// 备注信息     同一结果只返回一次，并更新steer_used/steer_dropped统计
+//-------------------------------------------------------------------------------------------------------------------
+uint8 vision_result_poll(Vision_Result *result);
+
+#endif
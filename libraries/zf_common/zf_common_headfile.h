@@ -118,18 +118,30 @@
 //====================================================Ӧ�������====================================================
 
 //=====================================================�û���======================================================
+#include "auto_exposure.h" // 直方图自动曝光
 #include "buzzer.h"     // 蜂鸣器控制库
+#include "centerline.h" // 中线拟合与前瞻
+#include "contour.h"    // 八邻域边界跟踪
 #include "delayed_stop.h" // 延迟停车功能
+#include "element.h"    // 赛道元素检测调度
+#include "frame_log.h"  // 图像录制与逐帧结果输出
 #include "Image Binarization.h" // 图像二值化
 #include "image.h"      // 图像处理
 #include "imu.h"        // IMU 传感器
+#include "island.h"     // 环岛识别状态机
+#include "ipm.h"        // 逆透视查找表
+#include "latency.h"    // 摄像头到舵机延迟统计
 #include "menu_config.h" // 用户菜单配置
 #include "menu.h"     // 菜单系统内核  
 #include "motor.h"  // 电机驱动与控制
 #include "param_save.h"  // 参数保存与读取
 #include "pid.h"    // PID 控制器
+#include "pid_q.h"  // Q16.16定点PID
+#include "profiler.h"  // 分段耗时统计
+#include "scheduler.h" // 1ms控制中断多速率调度
 #include "servo.h"      // 舵机控制
 #include "turn_compensation.h"  // 转弯补偿控制器
+#include "vision.h"     // 视觉任务与结果邮箱
 
 
 //=====================================================�û���======================================================
@@ -60,9 +60,38 @@
 #include "zf_device_camera.h"
 #include "zf_device_config.h"
 #include "zf_device_mt9v03x.h"
+#include "IfxStm.h"
 
 vuint8  mt9v03x_finish_flag = 0;                            // һͼɼɱ־λ
 IFX_ALIGN(4) uint8  mt9v03x_image[MT9V03X_H][MT9V03X_W];    // 4ֽڶ
+vuint32 mt9v03x_frame_id = 0;                               // Ѳɼɵ֡
+vuint32 mt9v03x_frame_vsync_stamp = 0;                      // ʹߵǰ֡ĳͬʱ (STM0 )
+vuint32 mt9v03x_frame_done_stamp = 0;                       // ʹߵǰ֡Ĳɼʱ (STM0 )
+static vuint32 mt9v03x_vsync_stamp = 0;                     // һγͬʱ жڷ
+vuint16 mt9v03x_exposure_time = MT9V03X_EXP_TIME_DEF;       // ǰعʱ (ͷһȷϵֵ)
+static uint8  mt9v03x_exposure_pending = 0;                 // 첽عѷ ȴͷӦ
+static uint32 mt9v03x_exposure_send_stamp = 0;              // 첽ع÷ʱ (STM0 )
+
+#if (MT9V03X_FRAME_BUFFER_NUM > 1)
+// Ȩ һʱ̷ֱ DMA(back)λ(middle)ʹ(front)
+// DMA һ֡ʱ swap ԭӵذ back  middle ֡־
+// ʹ߻ȡʱ֡ swap  front  middle 
+// ֻһԭӽ Ҫж Ҳɿʹ DMA Զдʹ߳еĻ
+#define MT9V03X_FRAME_INDEX_MASK    (0x03)
+#define MT9V03X_FRAME_FRESH         (0x80)
+IFX_ALIGN(4) uint8  mt9v03x_image_extra[MT9V03X_FRAME_BUFFER_NUM - 1][MT9V03X_H][MT9V03X_W];
+static uint8 *mt9v03x_frame_buffer[MT9V03X_FRAME_BUFFER_NUM] = {mt9v03x_image[0], mt9v03x_image_extra[0][0], mt9v03x_image_extra[1][0]};
+static uint32   mt9v03x_frame_back   = 0;                   // DMA дĻ жڷ
+static vuint32  mt9v03x_frame_middle = 1;                   // λ λΪ λΪ֡־
+static uint32   mt9v03x_frame_front  = 2;                   // ʹ߳еĻ ʹ߷
+static uint32   mt9v03x_buffer_vsync_stamp[MT9V03X_FRAME_BUFFER_NUM];   // ֡ĳͬʱ 滺һ𽻽
+static uint32   mt9v03x_buffer_done_stamp[MT9V03X_FRAME_BUFFER_NUM];    // ֡Ĳɼʱ
+static uint32   mt9v03x_buffer_frame_id[MT9V03X_FRAME_BUFFER_NUM];      // ֡֡ 滺һ𽻽
+#define MT9V03X_DMA_BUFFER          (mt9v03x_frame_buffer[mt9v03x_frame_back])
+#else
+#define MT9V03X_DMA_BUFFER          (mt9v03x_image[0])
+static uint32   mt9v03x_frame_front_id = 0;                 // ʹһλȡʱ֡ ʹ߷
+#endif
 
 static  m9v03x_type_enum mt9v03x_type;                      // ͷ
 static  uint16    mt9v03x_version = 0x00;                   // ͷ汾
@@ -240,6 +269,7 @@ static void mt9v03x_uart_handler (void)
 //-------------------------------------------------------------------------------------------------------------------
 static void mt9v03x_vsync_handler(void)
 {
+    mt9v03x_vsync_stamp = IfxStm_getLower(&MODULE_STM0);        // ӳͳ ¼֡ͬʱ
     exti_flag_clear(MT9V03X_VSYNC_PIN);
     mt9v03x_dma_int_num = 0;
     if(mt9v03x_dma_init_flag )
@@ -248,7 +278,7 @@ static void mt9v03x_vsync_handler(void)
         IfxDma_resetChannel(&MODULE_DMA, MT9V03X_DMA_CH);
         mt9v03x_link_list_num = dma_init(MT9V03X_DMA_CH,
                                          MT9V03X_DATA_ADD,
-                                         mt9v03x_image[0],
+                                         MT9V03X_DMA_BUFFER,
                                          MT9V03X_PCLK_PIN,
                                          EXTI_TRIGGER_RISING,
                                          MT9V03X_IMAGE_SIZE);           // Ƶ300M ڶΪFALLING
@@ -258,8 +288,14 @@ static void mt9v03x_vsync_handler(void)
     {
         if(1 == mt9v03x_link_list_num)
         {
-            dma_set_destination(MT9V03X_DMA_CH, mt9v03x_image[0]);      // ûвӴģʽ Ŀĵַ
+            dma_set_destination(MT9V03X_DMA_CH, MT9V03X_DMA_BUFFER);    // ûвӴģʽ Ŀĵַ
         }
+#if (MT9V03X_FRAME_BUFFER_NUM > 1)
+        else
+        {
+            dma_set_link_destination(MT9V03X_DMA_CH, MT9V03X_DMA_BUFFER, mt9v03x_link_list_num, MT9V03X_IMAGE_SIZE);  // ģʽ ÿ֡лĿ껺
+        }
+#endif
         dma_enable(MT9V03X_DMA_CH);
     }
     mt9v03x_lost_flag = 1;
@@ -291,6 +327,18 @@ static void mt9v03x_dma_handler(void)
             // һͼӲɼʼɼʱ3.8MS(50FPS188*120ֱ)
             mt9v03x_dma_int_num = 0;
             mt9v03x_lost_flag   = 0;
+            mt9v03x_frame_id ++;
+#if (MT9V03X_FRAME_BUFFER_NUM > 1)
+            // ֡ʱд뱾֡ڻ 滺һ𽻽Ӹʹ
+            mt9v03x_buffer_frame_id[mt9v03x_frame_back]    = mt9v03x_frame_id;
+            mt9v03x_buffer_vsync_stamp[mt9v03x_frame_back] = mt9v03x_vsync_stamp;
+            mt9v03x_buffer_done_stamp[mt9v03x_frame_back]  = IfxStm_getLower(&MODULE_STM0);
+            // ֡뽻λ һӻΪһ֡дĿ
+            mt9v03x_frame_back  = __swap((void *)&mt9v03x_frame_middle, mt9v03x_frame_back | MT9V03X_FRAME_FRESH) & MT9V03X_FRAME_INDEX_MASK;
+#else
+            mt9v03x_frame_vsync_stamp = mt9v03x_vsync_stamp;
+            mt9v03x_frame_done_stamp  = IfxStm_getLower(&MODULE_STM0);
+#endif
             mt9v03x_finish_flag = 1;
             dma_disable(MT9V03X_DMA_CH);
         }
@@ -375,11 +423,92 @@ uint8 mt9v03x_set_exposure_time (uint16 light)
         {
             return_state = 1;
         }
+        else
+        {
+            mt9v03x_exposure_time = temp;
+        }
         set_camera_type(CAMERA_GRAYSCALE, mt9v03x_vsync_handler, mt9v03x_dma_handler, NULL);
     }
     else
     {
         return_state = mt9v03x_set_exposure_time_sccb(light);
+        if(0 == return_state)
+        {
+            mt9v03x_exposure_time = light;
+        }
+    }
+    return return_state;
+}
+
+//-------------------------------------------------------------------------------------------------------------------
+//      ѯ첽عõӦ
+// ˵     void
+// ز     uint8           1-ڵȴӦ 0-
+// ʹʾ     mt9v03x_exposure_poll();
+// עϢ     յӦ mt9v03x_exposure_time (ͷ޷ʵֵ)
+//               MT9V03X_INIT_TIMEOUT δյӦ
+//              ȴ ͼѭÿ֡
+//-------------------------------------------------------------------------------------------------------------------
+uint8 mt9v03x_exposure_poll (void)
+{
+    if(mt9v03x_exposure_pending)
+    {
+        if(3 <= fifo_used(&camera_receiver_fifo))
+        {
+            uint8  uart_buffer[3];
+            uint32 uart_buffer_index = 3;
+            fifo_read_buffer(&camera_receiver_fifo, uart_buffer, &uart_buffer_index, FIFO_READ_AND_CLEAN);
+            mt9v03x_exposure_time = uart_buffer[1] << 8 | uart_buffer[2];
+            mt9v03x_exposure_pending = 0;
+        }
+        else if((IfxStm_getLower(&MODULE_STM0) - mt9v03x_exposure_send_stamp) > (uint32)MT9V03X_INIT_TIMEOUT * 100000)
+        {
+            mt9v03x_exposure_pending = 0;
+        }
+        if(!mt9v03x_exposure_pending)
+        {
+            set_camera_type(CAMERA_GRAYSCALE, mt9v03x_vsync_handler, mt9v03x_dma_handler, NULL);
+        }
+    }
+    return mt9v03x_exposure_pending;
+}
+
+//-------------------------------------------------------------------------------------------------------------------
+//      첽ͷعʱ
+// ˵     light           趨عʱ
+// ز     uint8           1-һδӦ δ 0-ѷ
+// ʹʾ     mt9v03x_set_exposure_time_async(300);
+// עϢ     ͨŵͷֻд4ֽ  mt9v03x_exposure_poll Ӧ
+//              SCCB ͨŵͷֱдĴ (ʱܶ)
+//              еԶع ͬһʱֻһ
+//-------------------------------------------------------------------------------------------------------------------
+uint8 mt9v03x_set_exposure_time_async (uint16 light)
+{
+    uint8 return_state = 0;
+    if(MT9V03X_UART == mt9v03x_type)
+    {
+        if(mt9v03x_exposure_poll())
+        {
+            return_state = 1;
+        }
+        else
+        {
+            uint8 uart_buffer[4];
+
+            set_camera_type(CAMERA_GRAYSCALE, mt9v03x_vsync_handler, mt9v03x_dma_handler, mt9v03x_uart_handler);
+            fifo_clear(&camera_receiver_fifo);
+            uart_buffer[0] = 0xA5;
+            uart_buffer[1] = MT9V03X_SET_EXP_TIME;
+            uart_buffer[2] = light >> 8;
+            uart_buffer[3] = (uint8)light;
+            mt9v03x_exposure_send_stamp = IfxStm_getLower(&MODULE_STM0);
+            mt9v03x_exposure_pending = 1;
+            uart_write_buffer(MT9V03X_COF_UART, uart_buffer, 4);
+        }
+    }
+    else if(0 == mt9v03x_set_exposure_time_sccb(light))
+    {
+        mt9v03x_exposure_time = light;
     }
     return return_state;
 }
@@ -442,6 +571,54 @@ uint8 mt9v03x_set_reg (uint8 addr, uint16 data)
     return return_state;
 }
 
+//-------------------------------------------------------------------------------------------------------------------
+//      ȡ֡Ȩ
+// ˵     frame_id         صĻ֡֡ (Ϊ NULL)
+// ˵     fresh            1-λȡ֡ 0-û֡ صһλȡ֡ (Ϊ NULL)
+// ز     uint8*          ͼ׵ַ (MT9V03X_H  MT9V03X_W )
+// ʹʾ     uint8 *image = mt9v03x_frame_acquire(&frame_id, &fresh);
+// עϢ     ģʽ ֡ʱ֡ û֡ʱһλȡ֡
+//              ֡֡־ȡͬһ swap Ļ  DMA жϸµ mt9v03x_frame_id λ
+//              صĻһεñǰһֱʹ DMA д ֱӴ踴
+//              ֻһʹߵ ģʽֱӷ mt9v03x_image ֡Ϊʱ mt9v03x_frame_id
+//-------------------------------------------------------------------------------------------------------------------
+uint8* mt9v03x_frame_acquire (uint32 *frame_id, uint8 *fresh)
+{
+#if (MT9V03X_FRAME_BUFFER_NUM > 1)
+    uint8 new_frame = 0;
+    if(mt9v03x_frame_middle & MT9V03X_FRAME_FRESH)
+    {
+        // ֻʹ߻֡־ ֮ DMA жֻٻµ֡ һ֡
+        uint32 middle = __swap((void *)&mt9v03x_frame_middle, mt9v03x_frame_front);
+        mt9v03x_frame_front = middle & MT9V03X_FRAME_INDEX_MASK;
+        new_frame = (middle & MT9V03X_FRAME_FRESH) ? 1 : 0;
+        mt9v03x_frame_vsync_stamp = mt9v03x_buffer_vsync_stamp[mt9v03x_frame_front];
+        mt9v03x_frame_done_stamp  = mt9v03x_buffer_done_stamp[mt9v03x_frame_front];
+    }
+    if(NULL != frame_id)
+    {
+        *frame_id = mt9v03x_buffer_frame_id[mt9v03x_frame_front];
+    }
+    if(NULL != fresh)
+    {
+        *fresh = new_frame;
+    }
+    return mt9v03x_frame_buffer[mt9v03x_frame_front];
+#else
+    uint32 id = mt9v03x_frame_id;
+    if(NULL != frame_id)
+    {
+        *frame_id = id;
+    }
+    if(NULL != fresh)
+    {
+        *fresh = (id != mt9v03x_frame_front_id) ? 1 : 0;
+    }
+    mt9v03x_frame_front_id = id;
+    return mt9v03x_image[0];
+#endif
+}
+
 //-------------------------------------------------------------------------------------------------------------------
 //      MT9V03X ͷʼ
 // ˵     void
@@ -511,7 +688,7 @@ uint8 mt9v03x_init (void)
                 break;
             }
         }
-        mt9v03x_link_list_num = camera_init(MT9V03X_DATA_ADD, mt9v03x_image[0], MT9V03X_IMAGE_SIZE);
+        mt9v03x_link_list_num = camera_init(MT9V03X_DATA_ADD, MT9V03X_DMA_BUFFER, MT9V03X_IMAGE_SIZE);
     }while(0);
     return return_state;
 }
@@ -83,6 +83,11 @@
 
 #define MT9V03X_IMAGE_SIZE      (MT9V03X_W * MT9V03X_H)                         // ͼСܳ 65535
 
+#define MT9V03X_FRAME_BUFFER_NUM    ( 3 )                                       // ͼ񻺳   ѡ 1  3
+                                                                                //                  1 DMA ʼд mt9v03x_image ڼܱһ֡
+                                                                                //                  3 DMA д롢֡ʹ߳е֡ռһ
+                                                                                //                     ʹͨ mt9v03x_frame_acquire ȡ֡ DMA Զд뱻е֡
+
 #define MT9V03X_AUTO_EXP_DEF    ( 0   )                                         // Զع     ĬϲԶع  Χ [0-63] 0Ϊر
                                                                                 //                  Զع⿪  EXP_TIMEԶعʱ
                                                                                 //                  һǲҪԶع ߷ǳȵԳԶع⣬ͼȶ
@@ -96,6 +101,9 @@
 #define MT9V03X_PCLK_MODE_DEF   ( 0   )                                         // ʱģʽ     Χ [0-1]    Ĭϣ0 ѡΪ[0ź,1ź]
                                                                                 //                  ͨΪ0ʹCH32V307DVPӿڻSTM32DCMIӿڲɼҪΪ1
                                                                                 //                   MT9V034 V1.5 Լϰ汾ָ֧
+#if (MT9V03X_FRAME_BUFFER_NUM != 1) && (MT9V03X_FRAME_BUFFER_NUM != 3)
+#error "MT9V03X_FRAME_BUFFER_NUM must be 1 or 3"
+#endif
 //================================================ MT9V03X ================================================
 
 
@@ -134,15 +142,22 @@ typedef enum
 
 //================================================ MT9V03X ȫֱ================================================
 extern vuint8    mt9v03x_finish_flag;                                           // һͼɼɱ־λ
-extern uint8    mt9v03x_image[MT9V03X_H][MT9V03X_W];                            // ͼݴ洢
+extern uint8    mt9v03x_image[MT9V03X_H][MT9V03X_W];                            // ͼݴ洢 ģʽΪ 0
+extern vuint32   mt9v03x_frame_id;                                              // Ѳɼɵ֡
+extern vuint32   mt9v03x_frame_vsync_stamp;                                     // ʹߵǰ֡ĳͬʱ (STM0  ģʽΪһ֡)
+extern vuint32   mt9v03x_frame_done_stamp;                                      // ʹߵǰ֡Ĳɼʱ (STM0 )
+extern vuint16   mt9v03x_exposure_time;                                         // ǰعʱ (ͷһȷϵֵ)
 //================================================ MT9V03X ȫֱ================================================
 
 
 //================================================ MT9V03X ================================================
 uint16      mt9v03x_get_version         (void);                                 // ȡͷ̼汾
 uint8       mt9v03x_set_exposure_time   (uint16 light);                         // ͷعʱ
+uint8       mt9v03x_set_exposure_time_async (uint16 light);                     // 첽عʱ ȴӦ
+uint8       mt9v03x_exposure_poll       (void);                                 // ѯ첽عõӦ
 uint8       mt9v03x_set_reg             (uint8 addr, uint16 data);              // ͷڲĴд
 uint8       mt9v03x_init                (void);                                 // MT9V03X ͷʼ
+uint8*      mt9v03x_frame_acquire       (uint32 *frame_id, uint8 *fresh);       // ȡ֡Ȩ ͬʱ֡֡־
 //================================================ MT9V03X ================================================
 
 #endif
@@ -172,6 +172,28 @@ uint8 dma_init (IfxDma_ChannelId dma_ch, uint8 *source_addr, uint8 *destination_
 }
 
 
+//-------------------------------------------------------------------------------------------------------------------
+//      dma Ŀĵַ
+// ˵     dma_ch              ѡDMAͨ
+// ˵     destination_addr    µĿĵַ
+// ˵     list_num            dma_init ص
+// ˵     dma_count           dma_init ʱõܰƴ
+// ز     void
+// ʹʾ     dma_set_link_destination(MT9V03X_DMA_CH, buffer, mt9v03x_link_list_num, MT9V03X_IMAGE_SIZE);
+// עϢ     ֹͨʱ ͨǰװصһ ֱӸͨĴ θ
+//-------------------------------------------------------------------------------------------------------------------
+void dma_set_link_destination (IfxDma_ChannelId dma_ch, uint8 *destination_addr, uint8 list_num, uint32 dma_count)
+{
+    uint8  i;
+    uint32 single_channel_dma_count = dma_count / list_num;
+
+    for(i = 0; i < list_num; i ++)
+    {
+        dma_link_list.linked_list[i].DADR.U = IFXCPU_GLB_ADDR_DSPR(IfxCpu_getCoreId(), destination_addr + single_channel_dma_count * i);
+    }
+    dma_set_destination(dma_ch, destination_addr);
+}
+
 //-------------------------------------------------------------------------------------------------------------------
 //      dma ֹ
 // ˵     ch              ѡ dma ͨ ( zf_driver_dma.h ö dma_channel_enum )
@@ -48,6 +48,7 @@
 uint8 dma_init      (IfxDma_ChannelId dma_ch, uint8 *source_addr, uint8 *destination_addr, exti_pin_enum eru_pin, exti_trigger_enum trigger, uint32 dma_count);
 void  dma_disable   (IfxDma_ChannelId dma_ch);
 void  dma_enable    (IfxDma_ChannelId dma_ch);
+void  dma_set_link_destination (IfxDma_ChannelId dma_ch, uint8 *destination_addr, uint8 list_num, uint32 dma_count);
 //====================================================DMA ====================================================
 
 #endif
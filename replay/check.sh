@@ -0,0 +1,128 @@
+#!/bin/sh
+# 文件: check.sh
+# 主机图像回放回归检查
+# 说明：按多种编译配置构建car_replay，逐序列回放replay/frames/*.frm并与replay/golden/中的参考CSV逐字节比对，
+#       最后输出各配置的处理帧率。
+#       逐位一致配置：只改变存储或计算方式、不改变结果的开关，输出必须与参考结果完全相同，否则检查失败；
+#       近似配置：有意改变边界结果的开关（帧间跟踪、轮廓引擎、金字塔、逆透视度量），只构建运行并统计与参考结果不同的行数。
+#       参考结果由默认配置（image.h中的开关全部为0）和固件默认参数生成：
+#         ./replay/check.sh --update
+#       带参数回放：VARIANTS中的序列用指定的--set参数再回放一遍，参考结果为replay/golden/<名称>.csv。
+#       环岛序列在默认参数下会被坡道检测抢先（Ramp_offset为0），带ramp_offset=1000回放才能走完环岛状态机，
+#       默认配置下还检查其环岛状态依次经过0→1→…→7→0；*_adaptive用自适应阈值二值化回放（固件默认关闭）
+# 用法（在仓库根目录执行）：
+#   ./replay/check.sh            构建、比对并测速
+#   ./replay/check.sh --update   用默认配置重新生成replay/golden/*.csv
+
+set -e
+
+CC=${CC:-gcc}
+OUT=${OUT:-_replay_build}
+CFLAGS="-O2 -std=gnu99 -Wall -DCAR_REPLAY -Ireplay -Isim -Icode"
+SRC="replay/replay_main.c replay/replay_hal.c replay/replay_io.c code/image.c code/Image?Binarization.c \
+     code/contour.c code/centerline.c code/element.c code/island.c code/ipm.c \
+     code/auto_exposure.c code/frame_log.c code/latency.c"
+
+# 名称:编译选项（逐位一致配置）
+EXACT="default:
+direct_dma:-DIMAGE_DIRECT_DMA_BUFFER=1
+packed:-DIMAGE_PACKED_BINARY=1
+lazy:-DIMAGE_LAZY_BINARY=1
+packed_lazy:-DIMAGE_PACKED_BINARY=1 -DIMAGE_LAZY_BINARY=1"
+
+# 名称:编译选项（近似配置）
+APPROX="tracking:-DIMAGE_BOUNDARY_TRACKING=1
+contour:-DIMAGE_CONTOUR_ENGINE=1
+pyramid:-DIMAGE_PYRAMID=1
+ipm_metric:-DIMAGE_IPM_METRIC=1"
+
+# 名称:序列:回放参数（带参数回放）
+VARIANTS="island_left_noramp:island_left:--set ramp_offset=1000
+island_right_noramp:island_right:--set ramp_offset=1000
+arc_adaptive:arc:--set adaptive=1
+cross_adaptive:cross:--set adaptive=1 --set ramp_offset=1000"
+
+mkdir -p "$OUT"
+
+build() {
+    # $1=配置名 $2=编译选项；源文件名含空格，用通配符传给编译器
+    $CC $CFLAGS $2 -o "$OUT/car_replay_$1" $SRC -lm
+}
+
+cases() {
+    # 输出全部回放用例，每行为 名称:序列文件:回放参数
+    for frm in replay/frames/*.frm; do
+        echo "$(basename "$frm" .frm):$frm:"
+    done
+    echo "$VARIANTS" | while IFS=: read name seq args; do
+        echo "$name:replay/frames/$seq.frm:$args"
+    done
+}
+
+island_walk() {
+    # $1=CSV；环岛状态（第6列）去掉连续重复后必须恰为 0 1 2 3 4 5 6 7 0
+    walk=$(tail -n +2 "$1" | cut -d, -f6 | uniq | tr '\n' ' ')
+    [ "$walk" = "0 1 2 3 4 5 6 7 0 " ]
+}
+
+if [ "$1" = "--update" ]; then
+    build default ""
+    cases > "$OUT/cases.list"
+    while IFS=: read name frm args; do
+        "$OUT/car_replay_default" $args "$frm" > "replay/golden/$name.csv" 2>/dev/null
+        echo "updated replay/golden/$name.csv"
+    done < "$OUT/cases.list"
+    exit 0
+fi
+
+fail=0
+speed=""
+
+run_config() {
+    # $1=配置名 $2=编译选项 $3=exact/approx
+    build "$1" "$2"
+    cases > "$OUT/cases.list"
+    while IFS=: read name frm args; do
+        "$OUT/car_replay_$1" $args "$frm" > "$OUT/$1_$name.csv" 2>/dev/null
+        if [ "$1" = default ] && [ "${name%_noramp}" != "$name" ]; then
+            if island_walk "$OUT/$1_$name.csv"; then
+                echo "  $1 $name: island states 0..7..0 ok"
+            else
+                echo "  $1 $name: island states do not walk 0..7..0: $walk"
+                fail=1
+            fi
+        fi
+        if [ "$3" = exact ]; then
+            if cmp -s "$OUT/$1_$name.csv" "replay/golden/$name.csv"; then
+                echo "  $1 $name: ok"
+            else
+                echo "  $1 $name: DIFFERS from golden"
+                diff "replay/golden/$name.csv" "$OUT/$1_$name.csv" | head -6
+                fail=1
+            fi
+        else
+            lines=$(diff "replay/golden/$name.csv" "$OUT/$1_$name.csv" | grep -c '^>' || true)
+            echo "  $1 $name: $lines frames differ (approximate config)"
+        fi
+    done < "$OUT/cases.list"
+    # 测速：全部序列重复50遍，只计图像处理时间
+    rate=$("$OUT/car_replay_$1" --quiet --repeat 50 replay/frames/*.frm 2>&1 | sed 's/.*ms, \([0-9]*\) frames\/s.*/\1/')
+    speed="$speed
+  $1: $rate frames/s"
+}
+
+echo "exact configs:"
+echo "$EXACT" > "$OUT/exact.list"
+while IFS=: read name flags; do run_config "$name" "$flags" exact; done < "$OUT/exact.list"
+
+echo "approximate configs:"
+echo "$APPROX" > "$OUT/approx.list"
+while IFS=: read name flags; do run_config "$name" "$flags" approx; done < "$OUT/approx.list"
+
+echo "host speed:$speed"
+
+if [ $fail -ne 0 ]; then
+    echo "replay check FAILED"
+    exit 1
+fi
+echo "replay check passed"
@@ -0,0 +1,237 @@
+/*********************************************************************
+ * 文件: replay_adaptive_test.c
+ * 自适应阈值二值化主机测试
+ * 说明：逐帧检查applyAdaptiveThreshold()和applyAdaptiveThresholdPacked()：
+ *       1. 与逐像素直接求窗口和、做除法的参考实现（局部阈值 = clamp(窗口均值 - offset, 全局阈值 ± margin)，
+ *          像素大于局部阈值为白）逐像素相同；窗口在图像边界处截断
+ *       2. 压缩版本展开后与字节版本相同，每行末尾补位为0
+ *       输入：50幅横向光照渐变的合成赛道帧（一侧亮一侧暗，赛道和背景的灰度随光照变化）、
+ *             以及命令行给出的回放帧；每帧在多组offset/margin下检查，全局阈值为大津法阈值
+ *       最后输出全局阈值与自适应阈值每帧的耗时（字节/压缩输出，轮流运行多遍取最小值，主机上的数值）
+ *
+ * 构建与运行（在仓库根目录执行，REPLAY_SRC见replay_main.c）：
+ *   eval gcc -O2 -std=gnu99 -DCAR_REPLAY -Ireplay -Isim -Icode -o adaptive_test replay/replay_adaptive_test.c $REPLAY_SRC -lm
+ *   ./adaptive_test replay/frames/[a-z]*.frm
+ *   任一像素不一致时返回1
+ ********************************************************************/
+
+#if defined(CAR_REPLAY) // 仅在主机回放构建中编译
+
+#include "zf_common_headfile.h"
+#include "replay_io.h"
+#include <time.h>
+
+//============================================================
+// 宏定义
+//============================================================
+
+#define ADAPTIVE_TEST_SYNTHETIC 50   // 合成光照渐变帧数
+#define ADAPTIVE_TEST_MAX_FRAMES 512 // 最多读入的帧数
+#define ADAPTIVE_TEST_REPEAT 20      // 测时重复遍数（取最小值）
+
+//============================================================
+// 全局变量
+//============================================================
+
+// 检查的offset/margin组合：固件默认值、无偏移、裕量为0（退化为全局阈值）、裕量覆盖全部灰度
+static const int test_param[][2] = {{8, 40}, {0, 40}, {8, 0}, {20, 100}, {8, 255}};
+
+static uint8 frames[ADAPTIVE_TEST_MAX_FRAMES][IMAGE_HEIGHT][IMAGE_WIDTH];
+static int frame_threshold[ADAPTIVE_TEST_MAX_FRAMES];
+static uint32 frame_num = 0;
+static uint8 out_byte[IMAGE_HEIGHT][IMAGE_WIDTH];
+static uint32 out_packed[IMAGE_HEIGHT][BINARY_PACKED_WORDS];
+static uint8 out_reference[IMAGE_HEIGHT][IMAGE_WIDTH];
+static uint32 adaptive_rng = 1;
+
+//============================================================
+// 参考实现
+//============================================================
+
+/**
+ * @brief 逐像素求窗口和并做除法的参考实现（255=白，0=黑）
+ * @note 均值sum/area用double计算：非整数的商与整数相差至少1/area，舍入误差不会越过整数比较的边界
+ */
+static void adaptive_reference(uint8 input[][IMAGE_WIDTH], uint8 output[][IMAGE_WIDTH], int threshold, int offset, int margin)
+{
+    int i, j, r, c;
+
+    for (i = 0; i < IMAGE_HEIGHT; i++)
+    {
+        for (j = 0; j < IMAGE_WIDTH; j++)
+        {
+            uint32 sum = 0, area = 0;
+            double local;
+
+            for (r = i - ADAPTIVE_RADIUS; r <= i + ADAPTIVE_RADIUS; r++)
+            {
+                for (c = j - ADAPTIVE_RADIUS; c <= j + ADAPTIVE_RADIUS; c++)
+                {
+                    if (r >= 0 && r < IMAGE_HEIGHT && c >= 0 && c < IMAGE_WIDTH)
+                    {
+                        sum += input[r][c];
+                        area++;
+                    }
+                }
+            }
+            local = (double)sum / (double)area - offset;
+            if (local < threshold - margin)
+                local = threshold - margin;
+            if (local > threshold + margin)
+                local = threshold + margin;
+            output[i][j] = (input[i][j] > local) ? 255 : 0;
+        }
+    }
+}
+
+//============================================================
+// 合成帧
+//============================================================
+
+static uint32 adaptive_rand(void)
+{
+    adaptive_rng = adaptive_rng * 1103515245u + 12345u;
+    return adaptive_rng >> 8;
+}
+
+/**
+ * @brief 渲染一帧横向光照渐变的赛道
+ * @note 赛道与背景的反射率之比固定，光照从一侧的gain_left线性变化到另一侧的gain_right，
+ *       暗侧赛道的灰度低于亮侧背景；叠加±8的随机噪声
+ */
+static void adaptive_render(uint8 frame[][IMAGE_WIDTH])
+{
+    float gain_left = 0.35f + 0.65f * (float)(adaptive_rand() % 1000) / 1000.0f;
+    float gain_right = 0.35f + 0.65f * (float)(adaptive_rand() % 1000) / 1000.0f;
+    float center = 60.0f + (float)(adaptive_rand() % 68);
+    float curve = ((float)(adaptive_rand() % 1000) / 1000.0f - 0.5f) * 0.02f;
+    int i, j;
+
+    for (i = 0; i < IMAGE_HEIGHT; i++)
+    {
+        int h = IMAGE_HEIGHT - 1 - i;
+        float half = 90.0f * (float)(i + 20) / (float)(IMAGE_HEIGHT + 20);
+        float c = center + curve * (float)(h * h);
+        for (j = 0; j < IMAGE_WIDTH; j++)
+        {
+            float gain = gain_left + (gain_right - gain_left) * (float)j / (float)(IMAGE_WIDTH - 1);
+            float reflect = (j >= c - half && j <= c + half) ? 240.0f : 70.0f;
+            int v = (int)(reflect * gain) + (int)(adaptive_rand() % 17) - 8;
+            frame[i][j] = (uint8)(v < 0 ? 0 : (v > 255 ? 255 : v));
+        }
+    }
+}
+
+//============================================================
+// 测时
+//============================================================
+
+static double now_s(void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double)now.tv_sec + (double)now.tv_nsec * 1e-9;
+}
+
+/**
+ * @brief 测量每帧平均耗时（us）
+ * @param best 输出：[0=全局阈值，1=自适应][0=字节，1=压缩]，多遍取最小值
+ */
+static void adaptive_time(double best[2][2])
+{
+    uint32 r, n;
+    int mode, packed;
+
+    for (mode = 0; mode < 2; mode++)
+        best[mode][0] = best[mode][1] = 1e30;
+    for (r = 0; r < ADAPTIVE_TEST_REPEAT; r++)
+    {
+        for (mode = 0; mode < 2; mode++)
+        {
+            for (packed = 0; packed < 2; packed++)
+            {
+                double start = now_s();
+                for (n = 0; n < frame_num; n++)
+                {
+                    if (mode == 0 && !packed)
+                        applyThreshold(frames[n], out_byte, frame_threshold[n]);
+                    else if (mode == 0)
+                        applyThresholdPacked(frames[n], out_packed, frame_threshold[n]);
+                    else if (!packed)
+                        applyAdaptiveThreshold(frames[n], out_byte, frame_threshold[n], 8, 40);
+                    else
+                        applyAdaptiveThresholdPacked(frames[n], out_packed, frame_threshold[n], 8, 40);
+                }
+                double t = (now_s() - start) * 1e6 / frame_num;
+                if (t < best[mode][packed])
+                    best[mode][packed] = t;
+            }
+        }
+    }
+}
+
+int main(int argc, char **argv)
+{
+    double best[2][2];
+    uint32 fail = 0, n, k;
+    int a, i, j;
+
+    for (n = 0; n < ADAPTIVE_TEST_SYNTHETIC; n++)
+        adaptive_render(frames[frame_num++]);
+    for (a = 1; a < argc; a++)
+    {
+        Replay_Source src;
+        uint32 frame_id = 0;
+
+        if (!replay_open(&src, argv[a]))
+            return 1;
+        while (frame_num < ADAPTIVE_TEST_MAX_FRAMES && replay_read(&src, frames[frame_num][0], &frame_id))
+            frame_num++;
+        replay_close(&src);
+    }
+
+    // 1. 逐像素比对
+    for (n = 0; n < frame_num; n++)
+    {
+        frame_threshold[n] = otsu_get_threshold(frames[n][0], IMAGE_WIDTH, IMAGE_HEIGHT);
+        for (k = 0; k < sizeof(test_param) / sizeof(test_param[0]); k++)
+        {
+            int offset = test_param[k][0], margin = test_param[k][1];
+            uint32 bad = 0;
+
+            adaptive_reference(frames[n], out_reference, frame_threshold[n], offset, margin);
+            applyAdaptiveThreshold(frames[n], out_byte, frame_threshold[n], offset, margin);
+            applyAdaptiveThresholdPacked(frames[n], out_packed, frame_threshold[n], offset, margin);
+            for (i = 0; i < IMAGE_HEIGHT; i++)
+            {
+                for (j = 0; j < IMAGE_WIDTH; j++)
+                {
+                    uint8 bit = (out_packed[i][j >> 5] & PACKED_COLUMN_BIT(j)) ? 255 : 0;
+                    bad += (out_byte[i][j] != out_reference[i][j]) + (bit != out_reference[i][j]);
+                }
+                bad += (out_packed[i][BINARY_PACKED_WORDS - 1] & ((1u << (BINARY_PACKED_WORDS * 32 - IMAGE_WIDTH)) - 1)) != 0;
+            }
+            if (bad)
+            {
+                if (fail < 10)
+                    printf("FAIL: frame %lu offset %d margin %d: %lu pixels differ\n", (unsigned long)n, offset, margin,
+                           (unsigned long)bad);
+                fail++;
+            }
+        }
+    }
+    printf("%lu frames x %lu parameter sets: %lu mismatches\n", (unsigned long)frame_num,
+           (unsigned long)(sizeof(test_param) / sizeof(test_param[0])), (unsigned long)fail);
+
+    // 2. 耗时
+    adaptive_time(best);
+    printf("%-24s %10s %10s\n", "per frame (us)", "byte", "packed");
+    printf("%-24s %10.2f %10.2f\n", "global threshold", best[0][0], best[0][1]);
+    printf("%-24s %10.2f %10.2f\n", "adaptive threshold", best[1][0], best[1][1]);
+
+    printf(fail ? "FAILED\n" : "PASSED\n");
+    return fail ? 1 : 0;
+}
+
+#endif
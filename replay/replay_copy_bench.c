@@ -0,0 +1,187 @@
+/*********************************************************************
+ * 文件: replay_copy_bench.c
+ * 图像复制+直方图融合的主机测速
+ * 说明：对命令行给出的帧逐帧比较三种二值化前处理流水线，检查结果相同并测量每帧耗时：
+ *       1. 原流水线：memcpy复制DMA缓冲区，otsu_get_threshold()再遍历一次统计直方图，applyThreshold()二值化（三遍）
+ *       2. 融合流水线：image_copy_histogram()复制的同时统计直方图，applyThreshold()二值化（两遍）
+ *       3. 不复制：image_copy_histogram(src, NULL, ...)只统计直方图，直接对采集缓冲区二值化
+ *          （三缓冲采集或IMAGE_DIRECT_DMA_BUFFER为1时的流水线）
+ *       三种流水线的阈值和二值图必须逐字节相同，否则返回1；
+ *       耗时为每帧平均值（多遍取最小值），分别给出复制+直方图阶段和含二值化的总耗时，为主机上的数值
+ *
+ * 构建与运行（在仓库根目录执行，REPLAY_SRC见replay_main.c）：
+ *   eval gcc -O2 -std=gnu99 -DCAR_REPLAY -Ireplay -Isim -Icode -o copy_bench replay/replay_copy_bench.c $REPLAY_SRC -lm
+ *   ./copy_bench replay/frames/[a-z]*.frm
+ ********************************************************************/
+
+#if defined(CAR_REPLAY) // 仅在主机回放构建中编译
+
+#include "zf_common_headfile.h"
+#include "replay_io.h"
+#include <time.h>
+
+//============================================================
+// 宏定义
+//============================================================
+
+#define COPY_BENCH_MAX_FRAMES 512 // 最多读入的帧数
+#define COPY_BENCH_REPEAT 50      // 测时重复遍数（取最小值）
+
+//============================================================
+// 全局变量
+//============================================================
+
+static uint8 frames[COPY_BENCH_MAX_FRAMES][MT9V03X_H][MT9V03X_W] IFX_ALIGN(4);
+static uint8 copy_buffer[MT9V03X_H][MT9V03X_W] IFX_ALIGN(4);
+static uint8 binary_result[3][MT9V03X_H][MT9V03X_W];
+static uint32 frame_num = 0;
+
+//============================================================
+// 流水线
+//============================================================
+
+/**
+ * @brief 原流水线的复制+直方图阶段
+ */
+static int stage_original(uint8 (*src)[MT9V03X_W])
+{
+    memcpy(copy_buffer, src, sizeof(copy_buffer));
+    return otsu_get_threshold(copy_buffer[0], MT9V03X_W, MT9V03X_H);
+}
+
+/**
+ * @brief 融合流水线的复制+直方图阶段
+ */
+static int stage_fused(uint8 (*src)[MT9V03X_W])
+{
+    uint16 hist[GRAY_LEVELS];
+    uint32 gray_sum = image_copy_histogram(src[0], copy_buffer[0], hist);
+
+    return otsu_threshold_from_histogram(hist, OTSU_SAMPLE_COUNT, gray_sum);
+}
+
+/**
+ * @brief 不复制流水线的直方图阶段
+ */
+static int stage_direct(uint8 (*src)[MT9V03X_W])
+{
+    uint16 hist[GRAY_LEVELS];
+    uint32 gray_sum = image_copy_histogram(src[0], NULL, hist);
+
+    return otsu_threshold_from_histogram(hist, OTSU_SAMPLE_COUNT, gray_sum);
+}
+
+/**
+ * @brief 运行一种流水线
+ * @param mode 0=原流水线，1=融合，2=不复制
+ * @param binarize 1=含二值化
+ * @param out 二值图输出
+ */
+static int pipeline_run(int mode, uint8 (*src)[MT9V03X_W], uint8 binarize, uint8 (*out)[MT9V03X_W])
+{
+    int threshold;
+
+    if (mode == 0)
+        threshold = stage_original(src);
+    else if (mode == 1)
+        threshold = stage_fused(src);
+    else
+        threshold = stage_direct(src);
+    if (binarize)
+        applyThreshold(mode == 2 ? src : copy_buffer, out, threshold);
+    return threshold;
+}
+
+static double now_s(void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double)now.tv_sec + (double)now.tv_nsec * 1e-9;
+}
+
+/**
+ * @brief 测量每种流水线每帧的平均耗时（us）
+ * @param best 输出：[流水线][0=复制+直方图，1=含二值化]，多遍取最小值
+ * @note 每遍轮流运行全部流水线，主机频率波动对各流水线的影响相同
+ */
+static void pipeline_time(double best[3][2])
+{
+    volatile int sink = 0;
+    uint32 r, n;
+    int mode, binarize;
+
+    for (mode = 0; mode < 3; mode++)
+        best[mode][0] = best[mode][1] = 1e30;
+    for (r = 0; r < COPY_BENCH_REPEAT; r++)
+    {
+        for (mode = 0; mode < 3; mode++)
+        {
+            for (binarize = 0; binarize < 2; binarize++)
+            {
+                double start = now_s();
+                for (n = 0; n < frame_num; n++)
+                    sink += pipeline_run(mode, frames[n], (uint8)binarize, binary_result[mode]);
+                double t = (now_s() - start) * 1e6 / frame_num;
+                if (t < best[mode][binarize])
+                    best[mode][binarize] = t;
+            }
+        }
+    }
+    (void)sink;
+}
+
+int main(int argc, char **argv)
+{
+    static const char *mode_name[3] = {"memcpy + otsu_get_threshold", "image_copy_histogram", "histogram only (no copy)"};
+    double best[3][2];
+    uint32 fail = 0, n;
+    int i, mode;
+
+    for (i = 1; i < argc; i++)
+    {
+        Replay_Source src;
+        uint32 frame_id = 0;
+
+        if (!replay_open(&src, argv[i]))
+            return 1;
+        while (frame_num < COPY_BENCH_MAX_FRAMES && replay_read(&src, frames[frame_num][0], &frame_id))
+            frame_num++;
+        replay_close(&src);
+    }
+    if (frame_num == 0)
+    {
+        fprintf(stderr, "usage: copy_bench frame files...\n");
+        return 1;
+    }
+
+    // 1. 结果比对
+    for (n = 0; n < frame_num; n++)
+    {
+        int threshold[3];
+
+        for (mode = 0; mode < 3; mode++)
+            threshold[mode] = pipeline_run(mode, frames[n], 1, binary_result[mode]);
+        if (threshold[1] != threshold[0] || threshold[2] != threshold[0] ||
+            memcmp(copy_buffer, frames[n], sizeof(copy_buffer)) != 0 ||
+            memcmp(binary_result[1], binary_result[0], sizeof(binary_result[0])) != 0 ||
+            memcmp(binary_result[2], binary_result[0], sizeof(binary_result[0])) != 0)
+        {
+            printf("FAIL: frame %lu: thresholds %d/%d/%d or binary images differ\n", (unsigned long)n,
+                   threshold[0], threshold[1], threshold[2]);
+            fail++;
+        }
+    }
+    printf("%lu frames: %lu mismatches\n", (unsigned long)frame_num, (unsigned long)fail);
+
+    // 2. 耗时
+    pipeline_time(best);
+    printf("%-30s %14s %20s\n", "per frame (us)", "copy+histogram", "incl. binarization");
+    for (mode = 0; mode < 3; mode++)
+        printf("%-30s %14.2f %20.2f\n", mode_name[mode], best[mode][0], best[mode][1]);
+
+    printf(fail ? "FAILED\n" : "PASSED\n");
+    return fail ? 1 : 0;
+}
+
+#endif
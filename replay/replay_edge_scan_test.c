@@ -0,0 +1,555 @@
+/*********************************************************************
+ * 文件: replay_edge_scan_test.c
+ * 边界扫描（已知白区前沿）主机回归测试
+ * 说明：直接包含image.c（White_Front_Build等为static函数），逐帧比对：
+ *       1. Longest_White_Column()的全部输出（左右边界、丢线标志、最长白列、搜索停止行、丢线计数、边界起始行、
+ *          赛道宽度，帧间跟踪开启时还有跟踪行数和跟踪状态）与原实现（edge_scan_model(0, ...)，
+ *          即76f82ac之前从最长白列开始逐点搜索"白-黑-黑"的版本）完全相同
+ *       2. edge_scan_model(1, ...)（按前沿起点和跳列方式搜索的计数副本）与Longest_White_Column()完全相同，
+ *          保证下面的读像素计数对应的就是实际代码的搜索过程
+ *       3. 输出全行搜索读取的二值像素数（原实现/前沿起点），压缩二值图按32位字搜索时不统计
+ *       两个模型与实际代码使用同一帧、同一跟踪状态（每次调用前恢复），按顺序处理，跟踪状态逐帧延续
+ *       输入：2000幅随机赛道帧（随机弯道、宽度、视野顶端、噪点和路面黑块）、400帧缓慢变化的连续序列，
+ *             以及命令行给出的回放帧（大津法阈值）；固定随机种子
+ *
+ * 构建与运行（在仓库根目录执行；image.c已被本文件包含，不再单独编译，LINE_SRC见replay_line_test.c）：
+ *   eval gcc -O2 -std=gnu99 -DCAR_REPLAY -Ireplay -Isim -Icode -o edge_scan_test replay/replay_edge_scan_test.c $LINE_SRC -lm
+ *   ./edge_scan_test replay/frames/[a-z]*.frm
+ *   分别加-DIMAGE_PACKED_BINARY=1、-DIMAGE_BOUNDARY_TRACKING=1构建可覆盖压缩二值图和帧间跟踪
+ *   任一帧不一致时返回1
+ ********************************************************************/
+
+#if defined(CAR_REPLAY) // 仅在主机回放构建中编译
+
+#include "../code/image.c"
+#include "replay_io.h"
+
+#if IMAGE_CONTOUR_ENGINE || IMAGE_PYRAMID
+#error "edge_scan_test只比对逐行扫描，需关闭IMAGE_CONTOUR_ENGINE和IMAGE_PYRAMID"
+#endif
+
+//============================================================
+// 宏定义
+//============================================================
+
+#define EDGE_TEST_RANDOM 2000     // 随机帧数
+#define EDGE_TEST_SEQUENCE 400    // 连续序列帧数
+#define EDGE_TEST_ROAD_GRAY 200   // 路面灰度
+#define EDGE_TEST_BACK_GRAY 40    // 背景灰度
+#define EDGE_TEST_THRESHOLD 128   // 合成帧的二值化阈值
+
+//============================================================
+// 类型定义
+//============================================================
+
+// Longest_White_Column()的输出
+typedef struct
+{
+    int left_line[MT9V03X_H];
+    int right_line[MT9V03X_H];
+    int left_lost[MT9V03X_H];
+    int right_lost[MT9V03X_H];
+    int road_wide[MT9V03X_H];
+    int column_left[2];
+    int column_right[2];
+    int stop_line;
+    int lost_time[3];
+    int start_row[2];
+#if IMAGE_BOUNDARY_TRACKING
+    int track_rows;
+    int track_valid;
+    int track_left[MT9V03X_H];
+    int track_right[MT9V03X_H];
+    int track_column[2];
+    int track_stop_line;
+#endif
+} Edge_Result;
+
+// 合成赛道参数
+typedef struct
+{
+    float center;     // 底行赛道中心列
+    float curve;      // 弯道系数（每行中心偏移随行高平方增长）
+    float width;      // 底行赛道宽度
+    int horizon;      // 视野顶端行，以上全黑
+    float noise;      // 噪点比例
+    int blobs;        // 路面黑块数
+} Road_Param;
+
+//============================================================
+// 全局变量
+//============================================================
+
+static uint8 gray_frame[MT9V03X_H][MT9V03X_W];
+static uint32 edge_rng = 1;
+static uint32 frame_count = 0;
+static uint32 fail_count = 0;
+static uint32 reads_legacy = 0, reads_front = 0;
+#if IMAGE_BOUNDARY_TRACKING
+static uint32 track_frames = 0; // 进入时跟踪状态有效的帧数
+#endif
+
+//============================================================
+// 原实现与计数模型
+//============================================================
+
+#if IMAGE_PACKED_BINARY
+#define EDGE_PIXEL_WHITE(i, j) ((binaryPacked[i][(j) >> 5] & PACKED_COLUMN_BIT(j)) != 0)
+#else
+#define EDGE_PIXEL_WHITE(i, j) (reads[0]++, binaryImage[i][j] == IMG_WHITE)
+#endif
+
+/**
+ * @brief Longest_White_Column()的模型
+ * @param frontier 0=原实现（从最长白列开始逐点搜索），1=从已知白区前沿开始跳列搜索（与当前实现相同）
+ * @param reads 输出：全行搜索读取的二值像素数累加到reads[0]
+ * @note 除全行搜索部分外与Longest_White_Column()逐句相同（轮廓引擎和金字塔分支已去掉）
+ */
+static void edge_scan_model(int frontier, uint32 *reads)
+{
+    int i;
+    int start_column = 35;
+    int end_column = MT9V03X_W - 35;
+    int left_border = 0, right_border = 0;
+    int right_front, left_front;
+    int right_start, left_start;
+#if !IMAGE_PACKED_BINARY
+    int j;
+#endif
+#if IMAGE_BOUNDARY_TRACKING
+    int tracking = track_valid && circle_flag == 0;
+#endif
+
+    Longest_White_Column_Left[0] = 0;
+    Longest_White_Column_Left[1] = 0;
+    Longest_White_Column_Right[0] = 0;
+    Longest_White_Column_Right[1] = 0;
+    Right_Lost_Time = 0;
+    Left_Lost_Time = 0;
+    Boundry_Start_Left = 0;
+    Boundry_Start_Right = 0;
+    Both_Lost_Time = 0;
+
+    for (i = 0; i <= MT9V03X_H - 1; i++)
+    {
+        Right_Lost_Flag[i] = 0;
+        Left_Lost_Flag[i] = 0;
+        Left_Line[i] = 0;
+        Right_Line[i] = MT9V03X_W - 1;
+    }
+    for (i = 0; i <= MT9V03X_W - 1; i++)
+    {
+        White_Column[i] = 0;
+    }
+
+    if (circle_flag)
+    {
+        if (right_circle_flag == 2)
+        {
+            start_column = 60;
+            end_column = MT9V03X_W - 20;
+        }
+        else if (left_circle_flag == 2)
+        {
+            start_column = 20;
+            end_column = MT9V03X_W - 60;
+        }
+    }
+
+#if IMAGE_BOUNDARY_TRACKING
+    if (tracking)
+        White_Column_Count_Track(start_column, end_column);
+    else
+        White_Column_Count(start_column, end_column);
+#else
+    White_Column_Count(start_column, end_column);
+#endif
+
+    Longest_White_Column_Left[0] = 0;
+    for (i = start_column; i <= end_column; i++)
+    {
+        if (Longest_White_Column_Left[0] < White_Column[i])
+        {
+            Longest_White_Column_Left[0] = White_Column[i];
+            Longest_White_Column_Left[1] = i;
+        }
+    }
+
+    Longest_White_Column_Right[0] = 0;
+    for (i = end_column; i >= Longest_White_Column_Left[1]; i--)
+    {
+        if (Longest_White_Column_Right[0] < White_Column[i])
+        {
+            Longest_White_Column_Right[0] = White_Column[i];
+            Longest_White_Column_Right[1] = i;
+        }
+    }
+
+    Search_Stop_Line = (Longest_White_Column_Left[0] > Longest_White_Column_Right[0]) ? Longest_White_Column_Left[0] : Longest_White_Column_Right[0];
+
+#if IMAGE_BOUNDARY_TRACKING
+    if (tracking && Search_Stop_Line < track_stop_line - IMAGE_TRACK_STOP_LINE_DROP)
+    {
+        tracking = 0;
+        track_valid = 0;
+        edge_scan_model(frontier, reads);
+        return;
+    }
+    Boundary_Track_Rows = 0;
+#endif
+
+    White_Front_Build(start_column, end_column);
+    right_front = end_column + 1;
+    left_front = start_column - 1;
+
+    for (i = MT9V03X_H - 1; i >= MT9V03X_H - Search_Stop_Line; i--)
+    {
+        right_border = -1;
+        left_border = -1;
+
+        while (right_front > Longest_White_Column_Right[1] && white_front_min[right_front - 1] < MT9V03X_H - i)
+            right_front--;
+        while (left_front < Longest_White_Column_Left[1] && white_front_min[left_front + 1] < MT9V03X_H - i)
+            left_front++;
+        right_start = (right_front - 1 > Longest_White_Column_Right[1]) ? right_front - 1 : Longest_White_Column_Right[1];
+        left_start = (left_front + 1 < Longest_White_Column_Left[1]) ? left_front + 1 : Longest_White_Column_Left[1];
+        if (!frontier)
+        {
+            right_start = Longest_White_Column_Right[1];
+            left_start = Longest_White_Column_Left[1];
+        }
+#if IMAGE_BOUNDARY_TRACKING
+        if (tracking)
+        {
+            right_border = Track_Right_Border(i, Longest_White_Column_Right[1]);
+            left_border = Track_Left_Border(i, Longest_White_Column_Left[1]);
+            if (right_border >= 0 && left_border >= 0)
+                Boundary_Track_Rows++;
+        }
+#endif
+#if IMAGE_PACKED_BINARY
+        (void)reads;
+        if (right_border < 0)
+            right_border = Packed_Find_Right_Border(binaryPacked[i], right_start, &Right_Lost_Flag[i]);
+        if (left_border < 0)
+            left_border = Packed_Find_Left_Border(binaryPacked[i], left_start, &Left_Lost_Flag[i]);
+#else
+        if (!frontier)
+        {
+            // 原实现（76f82ac之前）：逐列检查"白-黑-黑"
+            for (j = right_start; right_border < 0 && j <= MT9V03X_W - 1 - 2; j++)
+            {
+                if (EDGE_PIXEL_WHITE(i, j) && !EDGE_PIXEL_WHITE(i, j + 1) && !EDGE_PIXEL_WHITE(i, j + 2))
+                {
+                    right_border = j;
+                    Right_Lost_Flag[i] = 0;
+                    break;
+                }
+                else if (j >= MT9V03X_W - 1 - 2)
+                {
+                    right_border = j;
+                    Right_Lost_Flag[i] = 1;
+                    break;
+                }
+            }
+            for (j = left_start; left_border < 0 && j >= 0 + 2; j--)
+            {
+                if (EDGE_PIXEL_WHITE(i, j) && !EDGE_PIXEL_WHITE(i, j - 1) && !EDGE_PIXEL_WHITE(i, j - 2))
+                {
+                    left_border = j;
+                    Left_Lost_Flag[i] = 0;
+                    break;
+                }
+                else if (j <= 2)
+                {
+                    left_border = j;
+                    Left_Lost_Flag[i] = 1;
+                    break;
+                }
+            }
+        }
+        else
+        {
+            // 当前实现：先看最远的点，跳列搜索
+            j = right_start;
+            while (right_border < 0 && j <= MT9V03X_W - 1 - 2)
+            {
+                if (EDGE_PIXEL_WHITE(i, j + 2))
+                    j += 2;
+                else if (EDGE_PIXEL_WHITE(i, j + 1))
+                    j += 1;
+                else if (EDGE_PIXEL_WHITE(i, j))
+                {
+                    right_border = j;
+                    Right_Lost_Flag[i] = 0;
+                }
+                else
+                    j += 3;
+            }
+            if (right_border < 0)
+            {
+                right_border = MT9V03X_W - 1 - 2;
+                Right_Lost_Flag[i] = 1;
+            }
+            j = left_start;
+            while (left_border < 0 && j >= 0 + 2)
+            {
+                if (EDGE_PIXEL_WHITE(i, j - 2))
+                    j -= 2;
+                else if (EDGE_PIXEL_WHITE(i, j - 1))
+                    j -= 1;
+                else if (EDGE_PIXEL_WHITE(i, j))
+                {
+                    left_border = j;
+                    Left_Lost_Flag[i] = 0;
+                }
+                else
+                    j -= 3;
+            }
+            if (left_border < 0)
+            {
+                left_border = 2;
+                Left_Lost_Flag[i] = 1;
+            }
+        }
+#endif
+        Left_Line[i] = left_border;
+        Right_Line[i] = right_border;
+    }
+
+    for (i = MT9V03X_H - 1; i >= 0; i--)
+    {
+        if (Left_Lost_Flag[i] == 1)
+            Left_Lost_Time++;
+        if (Right_Lost_Flag[i] == 1)
+            Right_Lost_Time++;
+        if (Left_Lost_Flag[i] == 1 && Right_Lost_Flag[i] == 1)
+            Both_Lost_Time++;
+        if (Boundry_Start_Left == 0 && Left_Lost_Flag[i] != 1)
+            Boundry_Start_Left = i;
+        if (Boundry_Start_Right == 0 && Right_Lost_Flag[i] != 1)
+            Boundry_Start_Right = i;
+        Road_Wide[i] = Right_Line[i] - Left_Line[i];
+    }
+
+#if IMAGE_BOUNDARY_TRACKING
+    Boundary_Track_Update(tracking);
+#endif
+}
+
+//============================================================
+// 比对
+//============================================================
+
+static void edge_result_save(Edge_Result *r)
+{
+    memset(r, 0, sizeof(*r));
+    memcpy(r->left_line, (const void *)Left_Line, sizeof(r->left_line));
+    memcpy(r->right_line, (const void *)Right_Line, sizeof(r->right_line));
+    memcpy(r->left_lost, Left_Lost_Flag, sizeof(r->left_lost));
+    memcpy(r->right_lost, Right_Lost_Flag, sizeof(r->right_lost));
+    memcpy(r->road_wide, (const void *)Road_Wide, sizeof(r->road_wide));
+    r->column_left[0] = Longest_White_Column_Left[0];
+    r->column_left[1] = Longest_White_Column_Left[1];
+    r->column_right[0] = Longest_White_Column_Right[0];
+    r->column_right[1] = Longest_White_Column_Right[1];
+    r->stop_line = Search_Stop_Line;
+    r->lost_time[0] = Left_Lost_Time;
+    r->lost_time[1] = Right_Lost_Time;
+    r->lost_time[2] = Both_Lost_Time;
+    r->start_row[0] = Boundry_Start_Left;
+    r->start_row[1] = Boundry_Start_Right;
+#if IMAGE_BOUNDARY_TRACKING
+    r->track_rows = Boundary_Track_Rows;
+    r->track_valid = track_valid;
+    memcpy(r->track_left, track_left, sizeof(r->track_left));
+    memcpy(r->track_right, track_right, sizeof(r->track_right));
+    r->track_column[0] = track_column_left;
+    r->track_column[1] = track_column_right;
+    r->track_stop_line = track_stop_line;
+#endif
+}
+
+#if IMAGE_BOUNDARY_TRACKING
+static void track_state_restore(const Edge_Result *r)
+{
+    track_valid = r->track_valid;
+    memcpy(track_left, r->track_left, sizeof(track_left));
+    memcpy(track_right, r->track_right, sizeof(track_right));
+    track_column_left = r->track_column[0];
+    track_column_right = r->track_column[1];
+    track_stop_line = r->track_stop_line;
+}
+#endif
+
+/**
+ * @brief 二值化gray_frame并比对一帧
+ * @param name 输入名称（失败时输出）
+ */
+static void edge_check_frame(const char *name, int frame_threshold)
+{
+    Edge_Result before, legacy, front, actual;
+    uint32 count_legacy = 0, count_front = 0;
+    int i;
+
+    image_gray = gray_frame;
+    threshold = frame_threshold;
+    for (i = 0; i < MT9V03X_H; i++)
+        Binary_Row_Fill(i);
+
+    edge_result_save(&before);
+    edge_scan_model(0, &count_legacy);
+    edge_result_save(&legacy);
+#if IMAGE_BOUNDARY_TRACKING
+    track_frames += before.track_valid ? 1 : 0;
+    track_state_restore(&before);
+#endif
+    edge_scan_model(1, &count_front);
+    edge_result_save(&front);
+#if IMAGE_BOUNDARY_TRACKING
+    track_state_restore(&before);
+#endif
+    Longest_White_Column();
+    edge_result_save(&actual);
+
+    frame_count++;
+    reads_legacy += count_legacy;
+    reads_front += count_front;
+    if (memcmp(&legacy, &actual, sizeof(actual)) != 0 || memcmp(&front, &actual, sizeof(actual)) != 0)
+    {
+        if (fail_count < 10)
+        {
+            for (i = MT9V03X_H - 1; i >= 0; i--)
+            {
+                if (legacy.left_line[i] != actual.left_line[i] || legacy.right_line[i] != actual.right_line[i] ||
+                    legacy.left_lost[i] != actual.left_lost[i] || legacy.right_lost[i] != actual.right_lost[i])
+                    break;
+            }
+            printf("FAIL: %s frame %lu: row %d legacy %d/%d actual %d/%d model %d/%d\n", name, (unsigned long)frame_count, i,
+                   i >= 0 ? legacy.left_line[i] : -1, i >= 0 ? legacy.right_line[i] : -1,
+                   i >= 0 ? actual.left_line[i] : -1, i >= 0 ? actual.right_line[i] : -1,
+                   i >= 0 ? front.left_line[i] : -1, i >= 0 ? front.right_line[i] : -1);
+        }
+        fail_count++;
+    }
+}
+
+//============================================================
+// 合成赛道
+//============================================================
+
+static uint32 edge_rand(void)
+{
+    edge_rng = edge_rng * 1103515245u + 12345u;
+    return edge_rng >> 8;
+}
+
+static float edge_uniform(float lo, float hi)
+{
+    return lo + (hi - lo) * (float)(edge_rand() & 0xFFFF) / 65535.0f;
+}
+
+static void road_random(Road_Param *p)
+{
+    p->center = edge_uniform(40.0f, MT9V03X_W - 40.0f);
+    p->curve = edge_uniform(-0.03f, 0.03f);
+    p->width = edge_uniform(60.0f, 260.0f); // 宽度超过图像时两侧丢线
+    p->horizon = (int)edge_uniform(0.0f, 80.0f);
+    p->noise = edge_uniform(0.0f, 0.04f);
+    p->blobs = (int)edge_uniform(0.0f, 6.0f);
+}
+
+/**
+ * @brief 按参数渲染一帧灰度赛道
+ * @note 行越靠上赛道越窄、中心按弯道系数偏移；叠加椒盐噪点和路面黑块
+ */
+static void road_render(const Road_Param *p)
+{
+    int i, j, b;
+
+    for (i = 0; i < MT9V03X_H; i++)
+    {
+        int h = MT9V03X_H - 1 - i;
+        float scale = (float)(i + 20) / (float)(MT9V03X_H + 20);
+        float center = p->center + p->curve * (float)(h * h);
+        int left = (int)(center - p->width * scale / 2);
+        int right = (int)(center + p->width * scale / 2);
+
+        for (j = 0; j < MT9V03X_W; j++)
+        {
+            uint8 road = (i >= p->horizon && j >= left && j <= right);
+            if ((float)(edge_rand() & 0xFFFF) < p->noise * 65536.0f)
+                road = !road;
+            gray_frame[i][j] = road ? EDGE_TEST_ROAD_GRAY : EDGE_TEST_BACK_GRAY;
+        }
+    }
+    for (b = 0; b < p->blobs; b++)
+    {
+        int bi = (int)(edge_rand() % MT9V03X_H);
+        int bj = (int)(edge_rand() % MT9V03X_W);
+        int bh = 2 + (int)(edge_rand() % 6);
+        int bw = 2 + (int)(edge_rand() % 6);
+        for (i = bi; i < bi + bh && i < MT9V03X_H; i++)
+            for (j = bj; j < bj + bw && j < MT9V03X_W; j++)
+                gray_frame[i][j] = EDGE_TEST_BACK_GRAY;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    Road_Param p;
+    uint32 n;
+    int a;
+
+    // 1. 随机帧
+    for (n = 0; n < EDGE_TEST_RANDOM; n++)
+    {
+        road_random(&p);
+        road_render(&p);
+        edge_check_frame("random", EDGE_TEST_THRESHOLD);
+    }
+
+    // 2. 连续序列（参数缓慢变化，帧间跟踪可以持续生效）
+    road_random(&p);
+    p.width = 150.0f;
+    p.horizon = 30;
+    for (n = 0; n < EDGE_TEST_SEQUENCE; n++)
+    {
+        p.center += edge_uniform(-1.5f, 1.5f);
+        if (p.center < 50.0f || p.center > MT9V03X_W - 50.0f)
+            p.center = MT9V03X_W / 2;
+        p.curve = 0.02f * sinf((float)n * 0.03f);
+        p.noise = 0.005f;
+        p.blobs = (int)(edge_rand() % 3);
+        road_render(&p);
+        edge_check_frame("sequence", EDGE_TEST_THRESHOLD);
+    }
+
+    // 3. 回放帧
+    for (a = 1; a < argc; a++)
+    {
+        Replay_Source src;
+        uint32 frame_id = 0;
+
+        if (!replay_open(&src, argv[a]))
+            return 1;
+        while (replay_read(&src, gray_frame[0], &frame_id))
+            edge_check_frame(argv[a], otsu_get_threshold(gray_frame[0], MT9V03X_W, MT9V03X_H));
+        replay_close(&src);
+    }
+
+    printf("%lu frames (%s binary, tracking %s", (unsigned long)frame_count, IMAGE_PACKED_BINARY ? "packed" : "byte",
+           IMAGE_BOUNDARY_TRACKING ? "on" : "off");
+#if IMAGE_BOUNDARY_TRACKING
+    printf(", %lu frames entered with tracking", (unsigned long)track_frames);
+#endif
+    printf("): %lu mismatches\n", (unsigned long)fail_count);
+#if !IMAGE_PACKED_BINARY
+    printf("edge scan pixel reads: legacy %lu, frontier %lu (%.1f%%)\n", (unsigned long)reads_legacy,
+           (unsigned long)reads_front, reads_legacy ? 100.0 * reads_front / reads_legacy : 0.0);
+#endif
+    printf(fail_count ? "FAILED\n" : "PASSED\n");
+    return fail_count ? 1 : 0;
+}
+
+#endif
@@ -0,0 +1,245 @@
+/*********************************************************************
+ * 文件: replay_frame_buffer_test.c
+ * 摄像头三缓冲交接的主机并发测试
+ * 说明：zf_device_mt9v03x.c依赖DMA和中断，不能在主机上编译；本文件中的frame_dma_done()和frame_acquire()
+ *       与其中DMA完成中断的交接部分、mt9v03x_frame_acquire()的三缓冲分支逐句对应（__swap映射为原子交换），
+ *       修改驱动中的交接代码时需同步修改这里。
+ *       生产者线程模拟DMA：逐字把帧号写满back缓冲区（写入过程中不断被使用者读取的话即为撕裂），
+ *       写完后按中断中的顺序记录帧号并交换到交接位；使用者线程反复获取帧，在持有期间两次读全帧，检查：
+ *         1. 撕裂：持有期间帧内每个字都等于获取时返回的帧号（DMA从不写入使用者持有的缓冲区）
+ *         2. 帧号：有新帧时帧号严格递增，没有新帧时与上一次相同
+ *         3. 所有权：生产者开始写入时，目标缓冲区不是使用者持有的缓冲区
+ *       对照组为单缓冲（DMA始终写同一缓冲区，与MT9V03X_FRAME_BUFFER_NUM为1时相同），必须检测到撕裂，
+ *       以证明检查本身有效
+ *
+ * 构建与运行（在仓库根目录执行）：
+ *   gcc -O2 -std=gnu99 -pthread -DCAR_REPLAY -Ireplay -Isim -Icode -o frame_buffer_test replay/replay_frame_buffer_test.c
+ *   ./frame_buffer_test [帧数，默认200000]
+ *   三缓冲有任一错误或单缓冲对照组未检测到撕裂时返回1
+ ********************************************************************/
+
+#if defined(CAR_REPLAY) // 仅在主机回放构建中编译
+
+#include "zf_common_typedef.h"
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+//============================================================
+// 宏定义
+//============================================================
+
+#define FRAME_WORDS (188 * 120 / 4) // 一帧的32位字数（MT9V03X_W * MT9V03X_H / 4）
+#define FRAME_BUFFER_NUM 3
+#define MT9V03X_FRAME_INDEX_MASK (0x03)
+#define MT9V03X_FRAME_FRESH (0x80)
+#define __swap(p, v) __atomic_exchange_n((uint32 *)(p), (uint32)(v), __ATOMIC_SEQ_CST) // TriCore swap.w
+
+//============================================================
+// 交接状态（与zf_device_mt9v03x.c中的变量对应）
+//============================================================
+
+static uint32 frame_buffer[FRAME_BUFFER_NUM][FRAME_WORDS];
+static uint32 mt9v03x_frame_back = 0;            // DMA正在写入的缓冲区，仅生产者访问
+static volatile uint32 mt9v03x_frame_middle = 1; // 交接位，低两位为缓冲区序号，最高位为新帧标志
+static uint32 mt9v03x_frame_front = 2;           // 使用者持有的缓冲区，仅使用者访问
+static volatile uint32 mt9v03x_buffer_frame_id[FRAME_BUFFER_NUM]; // 各缓冲区所存帧的帧号
+static uint32 mt9v03x_frame_id = 0;              // 已采集完成的帧计数
+
+//============================================================
+// 测试状态
+//============================================================
+
+static uint8 single_buffer = 0;          // 1=单缓冲对照组
+static uint32 frame_total = 200000;      // 生产的帧数
+static volatile uint32 consumer_hold = 2; // 使用者当前持有的缓冲区（只用于检查所有权）
+static volatile uint8 producer_done = 0;
+static uint32 owner_errors = 0;          // 生产者写入了使用者持有的缓冲区
+
+typedef struct
+{
+    uint32 acquires;     // 获取次数
+    uint32 fresh;        // 获取到新帧的次数
+    uint32 torn;         // 撕裂的帧数
+    uint32 id_errors;    // 帧号或新帧标志错误
+    uint32 skipped;      // 生产了但未被获取的帧数（使用者较慢时正常）
+} Consumer_Result;
+
+//============================================================
+// 交接代码（与驱动逐句对应）
+//============================================================
+
+/**
+ * @brief DMA完成中断中的交接部分（mt9v03x_dma_handler）
+ */
+static void frame_dma_done(void)
+{
+    mt9v03x_frame_id++;
+    if (single_buffer)
+        return;
+    // 帧号先写入本帧所在缓冲区，随缓冲区一起交接给使用者
+    mt9v03x_buffer_frame_id[mt9v03x_frame_back] = mt9v03x_frame_id;
+    // 新帧放入交接位，换回上一个交接缓冲区作为下一帧的写入目标
+    mt9v03x_frame_back = __swap((void *)&mt9v03x_frame_middle, mt9v03x_frame_back | MT9V03X_FRAME_FRESH) & MT9V03X_FRAME_INDEX_MASK;
+}
+
+/**
+ * @brief mt9v03x_frame_acquire()的三缓冲分支
+ */
+static uint32 *frame_acquire(uint32 *frame_id, uint8 *fresh)
+{
+    uint8 new_frame = 0;
+
+    if (single_buffer)
+    {
+        // 单缓冲：直接返回DMA缓冲区，帧号为调用时的计数
+        uint32 id = __atomic_load_n(&mt9v03x_frame_id, __ATOMIC_SEQ_CST);
+        *fresh = (id != *frame_id);
+        *frame_id = id;
+        return frame_buffer[0];
+    }
+    if (mt9v03x_frame_middle & MT9V03X_FRAME_FRESH)
+    {
+        // 只有使用者会清除新帧标志，检查之后DMA中断只可能再换入更新的帧，交换到的一定是新帧
+        uint32 middle = __swap((void *)&mt9v03x_frame_middle, mt9v03x_frame_front);
+        mt9v03x_frame_front = middle & MT9V03X_FRAME_INDEX_MASK;
+        new_frame = (middle & MT9V03X_FRAME_FRESH) ? 1 : 0;
+    }
+    *frame_id = mt9v03x_buffer_frame_id[mt9v03x_frame_front];
+    *fresh = new_frame;
+    return frame_buffer[mt9v03x_frame_front];
+}
+
+//============================================================
+// 线程
+//============================================================
+
+static void *producer(void *arg)
+{
+    uint32 n, w;
+
+    (void)arg;
+    for (n = 1; n <= frame_total; n++)
+    {
+        uint32 back = single_buffer ? 0 : mt9v03x_frame_back;
+        volatile uint32 *dst = frame_buffer[back];
+
+        if (!single_buffer && back == consumer_hold)
+            owner_errors++;
+        // DMA逐字写入，写入过程中该缓冲区的内容是新旧帧混合；在帧中间的不同位置让出CPU，
+        // 单核主机上也能让使用者在写入过程中运行
+        for (w = 0; w < FRAME_WORDS; w++)
+        {
+            if (w == (n * 2311u) % FRAME_WORDS)
+                sched_yield();
+            dst[w] = n;
+        }
+        __atomic_thread_fence(__ATOMIC_SEQ_CST);
+        frame_dma_done();
+        if (n & 1)
+            sched_yield();
+    }
+    producer_done = 1;
+    return NULL;
+}
+
+static void *consumer(void *arg)
+{
+    Consumer_Result *result = (Consumer_Result *)arg;
+    uint32 last_id = 0, frame_id = 0, w, pass;
+    uint8 fresh;
+
+    while (!producer_done)
+    {
+        volatile const uint32 *frame = frame_acquire(&frame_id, &fresh);
+        uint8 torn = 0;
+
+        if (!single_buffer)
+            consumer_hold = mt9v03x_frame_front;
+        result->acquires++;
+        if (fresh)
+        {
+            result->fresh++;
+            if (frame_id <= last_id)
+                result->id_errors++;
+            result->skipped += frame_id - last_id - 1;
+        }
+        else if (frame_id != last_id)
+        {
+            result->id_errors++;
+        }
+        last_id = frame_id;
+        if (!fresh)
+            sched_yield(); // 没有新帧，让出CPU等待（持有的帧仍然检查）
+        if (frame_id == 0)
+            continue; // 还没有完整帧
+
+        // 持有期间读两遍（模拟图像处理的多遍遍历），两遍之间让出CPU，让DMA在持有期间继续写入
+        for (pass = 0; pass < 2 && !torn; pass++)
+        {
+            if (pass)
+                sched_yield();
+            for (w = 0; w < FRAME_WORDS; w++)
+            {
+                if (frame[w] != frame_id)
+                {
+                    torn = 1;
+                    break;
+                }
+            }
+        }
+        result->torn += torn;
+    }
+    return NULL;
+}
+
+/**
+ * @brief 运行一次生产者/使用者测试
+ */
+static void run(uint8 single, Consumer_Result *result)
+{
+    pthread_t p, c;
+
+    single_buffer = single;
+    memset(frame_buffer, 0, sizeof(frame_buffer));
+    memset(result, 0, sizeof(*result));
+    mt9v03x_frame_back = 0;
+    mt9v03x_frame_middle = 1;
+    mt9v03x_frame_front = 2;
+    memset((void *)mt9v03x_buffer_frame_id, 0, sizeof(mt9v03x_buffer_frame_id));
+    mt9v03x_frame_id = 0;
+    consumer_hold = 2;
+    producer_done = 0;
+    owner_errors = 0;
+
+    pthread_create(&c, NULL, consumer, result);
+    pthread_create(&p, NULL, producer, NULL);
+    pthread_join(p, NULL);
+    pthread_join(c, NULL);
+}
+
+int main(int argc, char **argv)
+{
+    Consumer_Result triple, single;
+    uint8 fail;
+
+    if (argc > 1)
+        frame_total = (uint32)strtoul(argv[1], NULL, 10);
+
+    run(0, &triple);
+    printf("triple buffer: %lu frames, %lu acquires, %lu fresh, %lu skipped, "
+           "%lu torn, %lu frame id errors, %lu writes into the held buffer\n",
+           (unsigned long)frame_total, (unsigned long)triple.acquires, (unsigned long)triple.fresh,
+           (unsigned long)triple.skipped, (unsigned long)triple.torn, (unsigned long)triple.id_errors,
+           (unsigned long)owner_errors);
+    run(1, &single);
+    printf("single buffer (control): %lu frames, %lu acquires, %lu torn\n", (unsigned long)frame_total,
+           (unsigned long)single.acquires, (unsigned long)single.torn);
+
+    fail = triple.torn != 0 || triple.id_errors != 0 || owner_errors != 0 || triple.fresh == 0 || single.torn == 0;
+    printf(fail ? "FAILED\n" : "PASSED\n");
+    return fail ? 1 : 0;
+}
+
+#endif
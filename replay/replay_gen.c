@@ -0,0 +1,329 @@
+/*********************************************************************
+ * 文件: replay_gen.c
+ * 主机回放用的合成帧生成程序
+ * 说明：仓库中没有实车录制的帧，replay/frames/中的帧由本程序按ipm.h的针孔模型
+ *       （光心高287mm、俯角40°、焦距112.2像素）渲染：赛道宽约430mm的白色路面（灰度约205）铺在深色地面（约55）上，
+ *       每像素2x2超采样后加左右渐暗和固定种子的随机噪声，车沿预设路径前进，每帧一个位姿；
+ *       生成结果只取决于本文件，重新运行得到逐字节相同的帧。实车录制的帧（frame_log_dump_frame()的输出）
+ *       可直接放入replay/frames/，用car_replay生成其参考结果
+ *
+ * 构建与运行（在仓库根目录执行）：
+ *   gcc -O2 -std=gnu99 -DCAR_REPLAY -Ireplay -Isim -Icode -o replay_gen replay/replay_gen.c replay/replay_io.c -lm
+ *   ./replay_gen replay/frames       生成全部序列（<序列名>.frm，FRM0帧流）
+ *   ./replay_gen replay/frames --pgm 同时把每帧另存为PGM（<序列名>_<帧号>.pgm）
+ ********************************************************************/
+
+#if defined(CAR_REPLAY) // 仅在主机回放构建中编译
+
+#include "zf_common_headfile.h"
+#include "replay_io.h"
+
+//============================================================
+// 宏定义
+//============================================================
+
+#define GEN_PI 3.14159265f
+// 路面半宽（mm）：比标准赛道窄4%。Road_Standard_Wide[]与针孔模型有±2像素的误差，
+// 而坡道检测（Ramp_offset为0）在10行宽出1像素时即触发，按标准宽度渲染会在直道上误判坡道
+#define GEN_ROAD_HALF_MM (IPM_TRACK_WIDTH_MM * 0.48f)
+#define GEN_ROAD_GRAY 205.0f                         // 路面灰度
+#define GEN_GROUND_GRAY 55.0f                        // 地面灰度
+#define GEN_VIGNETTE 0.18f                           // 图像左右边缘的亮度衰减比例
+#define GEN_NOISE 6                                  // 噪声幅度（±灰度）
+#define GEN_ZEBRA_STRIPE_MM 25.0f                    // 斑马线条纹宽度（mm）
+#define GEN_ZEBRA_DEPTH_MM 300.0f                    // 斑马线纵向长度（mm）
+#define GEN_MAX_PIECES 4                             // 每条路径的最大段数
+#define GEN_MAX_ROADS 3                              // 每个场景的最大路面条数
+
+//============================================================
+// 类型定义
+//============================================================
+
+// 路径段：长度和曲率（1/半径，>0左转，0为直线）
+typedef struct
+{
+    float length;
+    float curvature;
+} Gen_Piece;
+
+// 路径：起点位姿（世界坐标X向右、Y向前，航向为相对+Y轴的角度，左转为正）加若干段
+typedef struct
+{
+    float x, y, heading;
+    uint8 piece_num;
+    Gen_Piece piece[GEN_MAX_PIECES];
+} Gen_Path;
+
+// 场景：路面中线（路面为到中线距离不超过半宽的区域）、车的行驶路径和帧序列
+typedef struct
+{
+    const char *name;
+    uint8 road_num;
+    Gen_Path road[GEN_MAX_ROADS];
+    Gen_Path drive;      // 车（相机）的行驶路径
+    float start_mm;      // 第一帧在行驶路径上的位置（mm）
+    float step_mm;       // 每帧前进的距离（mm）
+    uint32 frame_num;    // 帧数
+    float wobble_mm;     // 横向摆动幅度（mm，模拟车在路面内偏移）
+    float wobble_deg;    // 航向摆动幅度（度）
+    float zebra_y;       // 斑马线起点Y坐标（mm，0=无斑马线）
+} Gen_Scene;
+
+// 位姿
+typedef struct
+{
+    float x, y, heading;
+} Gen_Pose;
+
+//============================================================
+// 场景表
+//============================================================
+
+#define GEN_RING_R 600.0f // 环岛中线半径（mm）
+
+static const Gen_Scene gen_scenes[] = {
+    // 直道：车在路面内左右摆动
+    {"straight", 1, {{0, -500, 0, 1, {{6000, 0}}}}, {0, -500, 0, 1, {{6000, 0}}}, 0, 120, 8, 60, 4, 0},
+    // 右弯：直道1m后接半径1m的90°右弯
+    {"arc", 1, {{0, -500, 0, 2, {{1500, 0}, {GEN_PI / 2 * 1000, -1.0f / 1000}}}},
+     {0, -500, 0, 2, {{1500, 0}, {GEN_PI / 2 * 1000, -1.0f / 1000}}}, 0, 160, 10, 0, 0, 0},
+    // 十字：Y=1500处与横向赛道相交，车直行通过
+    {"cross", 2, {{0, -500, 0, 1, {{6000, 0}}}, {-3000, 1500, -GEN_PI / 2, 1, {{6000, 0}}}},
+     {0, -500, 0, 1, {{6000, 0}}}, 0, 170, 10, 20, 2, 0},
+    // 斑马线：Y=1200处的起跑线，车直行通过
+    {"zebra", 1, {{0, -500, 0, 1, {{6000, 0}}}}, {0, -500, 0, 1, {{6000, 0}}}, 600, 150, 8, 0, 0, 1200},
+    // 左环岛：直道在Y=1500处与半径600mm的圆环相切，圆环与直道重叠的一段形成前后两个开口；
+    // 车经过第一个开口和圆环弧线后，在Y=1600处左转进环（行驶圆比圆环中线前移100mm），绕行一周后出环继续直行
+    {"island_left", 2, {{0, -500, 0, 1, {{6000, 0}}}, {0, 1500, 0, 1, {{2 * GEN_PI * GEN_RING_R, 1.0f / GEN_RING_R}}}},
+     {0, -500, 0, 3, {{2100, 0}, {2 * GEN_PI * GEN_RING_R, 1.0f / GEN_RING_R}, {2000, 0}}}, 600, 80, 75, 0, 0, 0},
+    // 右环岛：与左环岛镜像
+    {"island_right", 2, {{0, -500, 0, 1, {{6000, 0}}}, {0, 1500, 0, 1, {{2 * GEN_PI * GEN_RING_R, -1.0f / GEN_RING_R}}}},
+     {0, -500, 0, 3, {{2100, 0}, {2 * GEN_PI * GEN_RING_R, -1.0f / GEN_RING_R}, {2000, 0}}}, 600, 80, 75, 0, 0, 0},
+};
+
+//============================================================
+// 内部函数
+//============================================================
+
+static uint32 gen_rng = 1;
+
+static int32 gen_noise(void)
+{
+    gen_rng = gen_rng * 1664525u + 1013904223u;
+    return (int32)((gen_rng >> 16) % (2 * GEN_NOISE + 1)) - GEN_NOISE;
+}
+
+/**
+ * @brief 计算路径段起点之后s处的位姿
+ */
+static Gen_Pose gen_piece_pose(Gen_Pose start, const Gen_Piece *piece, float s)
+{
+    Gen_Pose pose;
+
+    if (piece->curvature == 0.0f)
+    {
+        pose.x = start.x - s * sinf(start.heading);
+        pose.y = start.y + s * cosf(start.heading);
+        pose.heading = start.heading;
+    }
+    else
+    {
+        float r = 1.0f / piece->curvature;
+
+        pose.heading = start.heading + piece->curvature * s;
+        pose.x = start.x + r * (cosf(pose.heading) - cosf(start.heading));
+        pose.y = start.y + r * (sinf(pose.heading) - sinf(start.heading));
+    }
+    return pose;
+}
+
+/**
+ * @brief 计算路径上s处的位姿（超出路径长度时沿最后一段延伸）
+ */
+static Gen_Pose gen_path_pose(const Gen_Path *path, float s)
+{
+    Gen_Pose pose = {path->x, path->y, path->heading};
+    uint8 k;
+
+    for (k = 0; k < path->piece_num; k++)
+    {
+        if (s <= path->piece[k].length || k == path->piece_num - 1)
+            return gen_piece_pose(pose, &path->piece[k], s);
+        pose = gen_piece_pose(pose, &path->piece[k], path->piece[k].length);
+        s -= path->piece[k].length;
+    }
+    return pose;
+}
+
+/**
+ * @brief 点到路径中线的最短距离
+ */
+static float gen_path_distance(const Gen_Path *path, float qx, float qy)
+{
+    Gen_Pose start = {path->x, path->y, path->heading};
+    float best = 1e9f, d;
+    uint8 k;
+
+    for (k = 0; k < path->piece_num; k++)
+    {
+        const Gen_Piece *piece = &path->piece[k];
+        Gen_Pose end = gen_piece_pose(start, piece, piece->length);
+
+        if (piece->curvature == 0.0f)
+        {
+            float dx = -sinf(start.heading), dy = cosf(start.heading);
+            float t = (qx - start.x) * dx + (qy - start.y) * dy;
+
+            if (t < 0.0f)
+                t = 0.0f;
+            if (t > piece->length)
+                t = piece->length;
+            d = hypotf(qx - (start.x + t * dx), qy - (start.y + t * dy));
+        }
+        else
+        {
+            float r = 1.0f / piece->curvature;
+            float cx = start.x - r * cosf(start.heading), cy = start.y - r * sinf(start.heading);
+            float sweep = piece->curvature * piece->length; // 有向转角
+            float phi0 = atan2f(start.y - cy, start.x - cx);
+            float phiq = atan2f(qy - cy, qx - cx);
+            float t = (sweep > 0.0f) ? (phiq - phi0) : (phi0 - phiq);
+
+            while (t < 0.0f)
+                t += 2 * GEN_PI;
+            while (t >= 2 * GEN_PI)
+                t -= 2 * GEN_PI;
+            if (t <= fabsf(sweep))
+                d = fabsf(hypotf(qx - cx, qy - cy) - fabsf(r));
+            else
+                d = fminf(hypotf(qx - start.x, qy - start.y), hypotf(qx - end.x, qy - end.y));
+        }
+        if (d < best)
+            best = d;
+        start = end;
+    }
+    return best;
+}
+
+/**
+ * @brief 世界坐标处的地面灰度（未加光照和噪声）
+ */
+static float gen_ground_gray(const Gen_Scene *scene, float qx, float qy)
+{
+    uint8 k;
+
+    for (k = 0; k < scene->road_num; k++)
+    {
+        if (gen_path_distance(&scene->road[k], qx, qy) <= GEN_ROAD_HALF_MM)
+        {
+            // 斑马线：沿行驶方向的黑白条纹，只画在第一条（直行）路面上
+            if (k == 0 && scene->zebra_y != 0.0f && qy >= scene->zebra_y && qy < scene->zebra_y + GEN_ZEBRA_DEPTH_MM &&
+                ((int32)floorf((qx + GEN_ROAD_HALF_MM) / GEN_ZEBRA_STRIPE_MM) & 1))
+                return GEN_GROUND_GRAY;
+            return GEN_ROAD_GRAY;
+        }
+    }
+    return GEN_GROUND_GRAY;
+}
+
+/**
+ * @brief 按相机位姿渲染一帧
+ */
+static void gen_render(const Gen_Scene *scene, Gen_Pose pose, uint8 *frame)
+{
+    float pitch = IPM_CAMERA_PITCH_DEG * GEN_PI / 180.0f;
+    float fx = -sinf(pose.heading), fy = cosf(pose.heading); // 前向单位向量
+    float rx = cosf(pose.heading), ry = sinf(pose.heading);  // 右向单位向量
+    int i, j, si, sj;
+
+    for (i = 0; i < MT9V03X_H; i++)
+    {
+        for (j = 0; j < MT9V03X_W; j++)
+        {
+            float sum = 0.0f, col = (j - IPM_CENTER_COL) / (float)IPM_CENTER_COL;
+            int32 gray;
+
+            for (si = 0; si < 2; si++)
+            {
+                float row = i - 0.25f + 0.5f * si;
+                float alpha = atanf((row - IPM_CENTER_ROW) / IPM_FOCAL_PX);
+                float angle = pitch + alpha;
+                float forward = IPM_CAMERA_HEIGHT_MM / tanf(angle);
+                float scale = IPM_CAMERA_HEIGHT_MM * cosf(alpha) / sinf(angle) / IPM_FOCAL_PX;
+
+                for (sj = 0; sj < 2; sj++)
+                {
+                    float lateral = (j - 0.25f + 0.5f * sj - IPM_CENTER_COL) * scale;
+                    sum += gen_ground_gray(scene, pose.x + forward * fx + lateral * rx, pose.y + forward * fy + lateral * ry);
+                }
+            }
+
+            gray = (int32)(sum * 0.25f * (1.0f - GEN_VIGNETTE * col * col) + 0.5f) + gen_noise();
+            frame[i * MT9V03X_W + j] = (uint8)(gray < 0 ? 0 : (gray > 255 ? 255 : gray));
+        }
+    }
+}
+
+int main(int argc, char **argv)
+{
+    static uint8 frame[REPLAY_FRAME_SIZE];
+    char path[512];
+    uint32 s, n;
+    uint8 pgm = (argc > 2 && strcmp(argv[2], "--pgm") == 0);
+
+    if (argc < 2)
+    {
+        fprintf(stderr, "usage: replay_gen output_dir [--pgm]\n");
+        return 1;
+    }
+
+    for (s = 0; s < sizeof(gen_scenes) / sizeof(gen_scenes[0]); s++)
+    {
+        const Gen_Scene *scene = &gen_scenes[s];
+        FILE *fp;
+
+        snprintf(path, sizeof(path), "%s/%s.frm", argv[1], scene->name);
+        fp = fopen(path, "wb");
+        if (fp == NULL)
+        {
+            fprintf(stderr, "%s: cannot write\n", path);
+            return 1;
+        }
+
+        gen_rng = s + 1;
+        for (n = 0; n < scene->frame_num; n++)
+        {
+            float along = scene->start_mm + scene->step_mm * n;
+            float phase = 2 * GEN_PI * n / scene->frame_num;
+            Gen_Pose pose = gen_path_pose(&scene->drive, along);
+
+            // 横向摆动沿车的右向偏移，航向摆动与之错开90°
+            pose.x += scene->wobble_mm * sinf(phase) * cosf(pose.heading);
+            pose.y += scene->wobble_mm * sinf(phase) * sinf(pose.heading);
+            pose.heading += scene->wobble_deg * GEN_PI / 180.0f * cosf(phase);
+
+            gen_render(scene, pose, frame);
+            if (!replay_write_frame(fp, n, frame))
+            {
+                fprintf(stderr, "%s: write failed\n", path);
+                fclose(fp);
+                return 1;
+            }
+            if (pgm)
+            {
+                snprintf(path, sizeof(path), "%s/%s_%lu.pgm", argv[1], scene->name, (unsigned long)n);
+                if (!replay_write_pgm(path, frame))
+                {
+                    fprintf(stderr, "%s: cannot write\n", path);
+                    fclose(fp);
+                    return 1;
+                }
+            }
+        }
+        fclose(fp);
+        printf("%s: %lu frames\n", scene->name, (unsigned long)scene->frame_num);
+    }
+    return 0;
+}
+
+#endif
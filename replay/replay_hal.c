@@ -0,0 +1,82 @@
+/*********************************************************************
+ * 文件: replay_hal.c
+ * 主机图像回放外设层实现文件
+ * 说明：接口与逐飞库一致，图像处理代码不做任何修改即可链接；
+ *       回放程序把录制的帧写入mt9v03x_image后调用image_process_frame()，
+ *       STM0计数取主机单调时钟（10ns/计数），元素检测耗时统计与车上含义一致
+ ********************************************************************/
+
+#if defined(CAR_REPLAY) // 仅在主机回放构建中编译
+
+#include "zf_common_headfile.h"
+#include "IfxStm.h"
+#include <time.h>
+
+//============================================================
+// 全局变量定义
+//============================================================
+
+Ifx_STM MODULE_STM0;
+
+vuint8 mt9v03x_finish_flag = 0;
+uint8 mt9v03x_image[MT9V03X_H][MT9V03X_W] IFX_ALIGN(4);
+vuint32 mt9v03x_frame_id = 0;
+vuint32 mt9v03x_frame_vsync_stamp = 0;
+vuint32 mt9v03x_frame_done_stamp = 0;
+vuint16 mt9v03x_exposure_time = 512;
+
+int16 encoder[2] = {0};
+
+static uint32 frame_front_id = 0; // 上一次获取时的帧号
+
+//============================================================
+// 系统定时器
+//============================================================
+
+uint32 IfxStm_getLower(Ifx_STM *stm)
+{
+    struct timespec now;
+
+    (void)stm;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint32)((uint64)now.tv_sec * 100000000u + (uint64)now.tv_nsec / 10u);
+}
+
+//============================================================
+// 摄像头
+//============================================================
+
+uint8 mt9v03x_set_exposure_time_async(uint16 light)
+{
+    mt9v03x_exposure_time = light;
+    return 0;
+}
+
+uint8 mt9v03x_exposure_poll(void)
+{
+    return 0;
+}
+
+uint8 *mt9v03x_frame_acquire(uint32 *frame_id, uint8 *fresh)
+{
+    uint32 id = mt9v03x_frame_id;
+
+    if (frame_id != NULL)
+        *frame_id = id;
+    if (fresh != NULL)
+        *fresh = (id != frame_front_id) ? 1 : 0;
+    frame_front_id = id;
+    return mt9v03x_image[0];
+}
+
+//============================================================
+// 串口
+//============================================================
+
+void uart_write_buffer(uint32 uart_n, const uint8 *buff, uint32 len)
+{
+    (void)uart_n;
+    fwrite(buff, 1, len, stdout);
+}
+
+#endif
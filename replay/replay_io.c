@@ -0,0 +1,186 @@
+/*********************************************************************
+ * 文件: replay_io.c
+ * 主机图像回放帧文件读写实现文件
+ ********************************************************************/
+
+#if defined(CAR_REPLAY) // 仅在主机回放构建中编译
+
+#include "zf_common_headfile.h"
+#include "replay_io.h"
+
+//============================================================
+// 内部函数
+//============================================================
+
+/**
+ * @brief 读取PGM文件头中的一个十进制数（跳过空白和#注释）
+ * @return 读到的数，格式错误时返回-1
+ */
+static int32 replay_pgm_number(FILE *fp)
+{
+    int c = fgetc(fp);
+    int32 value = 0;
+
+    while (c == ' ' || c == '\t' || c == '\r' || c == '\n' || c == '#')
+    {
+        if (c == '#')
+        {
+            while (c != '\n' && c != EOF)
+                c = fgetc(fp);
+        }
+        c = fgetc(fp);
+    }
+    if (c < '0' || c > '9')
+        return -1;
+    while (c >= '0' && c <= '9')
+    {
+        value = value * 10 + (c - '0');
+        if (value > 65535)
+            return -1;
+        c = fgetc(fp);
+    }
+    // 数字后的一个空白字符属于文件头（最大灰度值之后紧跟像素数据）
+    return (c == ' ' || c == '\t' || c == '\r' || c == '\n') ? value : -1;
+}
+
+//============================================================
+// 函数实现
+//============================================================
+
+/**
+ * @brief 打开帧文件
+ */
+uint8 replay_open(Replay_Source *src, const char *path)
+{
+    uint8 magic[2];
+
+    src->fp = fopen(path, "rb");
+    src->pgm = 0;
+    src->read_num = 0;
+    if (src->fp == NULL)
+    {
+        fprintf(stderr, "%s: cannot open\n", path);
+        return 0;
+    }
+    if (fread(magic, 1, 2, src->fp) != 2)
+    {
+        fprintf(stderr, "%s: empty file\n", path);
+        replay_close(src);
+        return 0;
+    }
+
+    if (magic[0] == 'P' && magic[1] == '5')
+    {
+        int32 width = replay_pgm_number(src->fp);
+        int32 height = replay_pgm_number(src->fp);
+        int32 max_gray = replay_pgm_number(src->fp);
+
+        if (width != MT9V03X_W || height != MT9V03X_H || max_gray != 255)
+        {
+            fprintf(stderr, "%s: need a %dx%d 8-bit PGM\n", path, MT9V03X_W, MT9V03X_H);
+            replay_close(src);
+            return 0;
+        }
+        src->pgm = 1;
+        return 1;
+    }
+    if (magic[0] == 'F' && magic[1] == 'R')
+    {
+        rewind(src->fp);
+        return 1;
+    }
+
+    fprintf(stderr, "%s: neither a PGM (P5) nor a FRM0 frame stream\n", path);
+    replay_close(src);
+    return 0;
+}
+
+/**
+ * @brief 读取下一帧
+ */
+uint8 replay_read(Replay_Source *src, uint8 *frame, uint32 *frame_id)
+{
+    uint8 header[12];
+    size_t got;
+
+    if (src->fp == NULL)
+        return 0;
+
+    if (src->pgm)
+    {
+        if (src->read_num > 0)
+            return 0;
+    }
+    else
+    {
+        got = fread(header, 1, sizeof(header), src->fp);
+        if (got == 0)
+            return 0;
+        if (got != sizeof(header) || memcmp(header, "FRM0", 4) != 0)
+        {
+            fprintf(stderr, "frame %lu: bad FRM0 header\n", (unsigned long)src->read_num);
+            return 0;
+        }
+        if ((header[8] | (header[9] << 8)) != MT9V03X_W || (header[10] | (header[11] << 8)) != MT9V03X_H)
+        {
+            fprintf(stderr, "frame %lu: size is not %dx%d\n", (unsigned long)src->read_num, MT9V03X_W, MT9V03X_H);
+            return 0;
+        }
+        *frame_id = (uint32)header[4] | ((uint32)header[5] << 8) | ((uint32)header[6] << 16) | ((uint32)header[7] << 24);
+    }
+
+    if (fread(frame, 1, REPLAY_FRAME_SIZE, src->fp) != REPLAY_FRAME_SIZE)
+    {
+        fprintf(stderr, "frame %lu: truncated\n", (unsigned long)src->read_num);
+        return 0;
+    }
+    src->read_num++;
+    return 1;
+}
+
+/**
+ * @brief 关闭帧文件
+ */
+void replay_close(Replay_Source *src)
+{
+    if (src->fp != NULL)
+        fclose(src->fp);
+    src->fp = NULL;
+}
+
+/**
+ * @brief 写一帧原始帧流
+ */
+uint8 replay_write_frame(FILE *fp, uint32 frame_id, const uint8 *frame)
+{
+    uint8 header[12] = {'F', 'R', 'M', '0'};
+
+    header[4] = (uint8)(frame_id);
+    header[5] = (uint8)(frame_id >> 8);
+    header[6] = (uint8)(frame_id >> 16);
+    header[7] = (uint8)(frame_id >> 24);
+    header[8] = (uint8)(MT9V03X_W);
+    header[9] = (uint8)(MT9V03X_W >> 8);
+    header[10] = (uint8)(MT9V03X_H);
+    header[11] = (uint8)(MT9V03X_H >> 8);
+
+    return fwrite(header, 1, sizeof(header), fp) == sizeof(header) &&
+           fwrite(frame, 1, REPLAY_FRAME_SIZE, fp) == REPLAY_FRAME_SIZE;
+}
+
+/**
+ * @brief 写一帧PGM文件
+ */
+uint8 replay_write_pgm(const char *path, const uint8 *frame)
+{
+    FILE *fp = fopen(path, "wb");
+    uint8 ok;
+
+    if (fp == NULL)
+        return 0;
+    fprintf(fp, "P5\n%d %d\n255\n", MT9V03X_W, MT9V03X_H);
+    ok = fwrite(frame, 1, REPLAY_FRAME_SIZE, fp) == REPLAY_FRAME_SIZE;
+    return (fclose(fp) == 0) && ok;
+}
+
+#endif
@@ -0,0 +1,72 @@
+/*********************************************************************
+ * 文件: replay_io.h
+ * 主机图像回放帧文件读写头文件
+ * 说明：支持两种帧文件：
+ *       1. 车上录制的原始帧流：frame_log_dump_frame()经调试串口输出的内容原样保存，
+ *          每帧为 "FRM0" + 帧号(uint32小端) + 宽(uint16) + 高(uint16) + 宽*高字节灰度，一个文件可含多帧
+ *       2. 二进制PGM（P5，188x120，最大灰度255），一个文件一帧，帧号取文件在命令行中的序号
+ ********************************************************************/
+
+#ifndef _REPLAY_IO_H
+#define _REPLAY_IO_H
+
+#include "zf_common_typedef.h"
+#include "zf_common_headfile.h"
+
+//============================================================
+// 宏定义
+//============================================================
+
+#define REPLAY_FRAME_SIZE (MT9V03X_W * MT9V03X_H) // 一帧灰度图字节数
+
+//============================================================
+// 类型定义
+//============================================================
+
+// 帧文件读取状态
+typedef struct
+{
+    FILE *fp;
+    uint8 pgm;       // 1=PGM文件（只有一帧），0=原始帧流
+    uint32 read_num; // 已读取的帧数
+} Replay_Source;
+
+//============================================================
+// 函数声明
+//============================================================
+
+/**
+ * @brief 打开帧文件（按文件头判断格式）
+ * @param src 读取状态
+ * @param path 文件路径
+ * @return 1=成功，0=无法打开或格式不支持
+ */
+uint8 replay_open(Replay_Source *src, const char *path);
+
+/**
+ * @brief 读取下一帧
+ * @param src 读取状态
+ * @param frame 输出：灰度图（REPLAY_FRAME_SIZE字节）
+ * @param frame_id 输出：帧号（PGM文件不含帧号，保持调用方传入的值）
+ * @return 1=读到一帧，0=文件结束或帧头错误（错误时在stderr输出原因）
+ */
+uint8 replay_read(Replay_Source *src, uint8 *frame, uint32 *frame_id);
+
+/**
+ * @brief 关闭帧文件
+ */
+void replay_close(Replay_Source *src);
+
+/**
+ * @brief 写一帧原始帧流（格式与frame_log_dump_frame()相同）
+ * @return 1=成功，0=写入失败
+ */
+uint8 replay_write_frame(FILE *fp, uint32 frame_id, const uint8 *frame);
+
+/**
+ * @brief 写一帧PGM文件
+ * @return 1=成功，0=写入失败
+ */
+uint8 replay_write_pgm(const char *path, const uint8 *frame);
+
+#endif
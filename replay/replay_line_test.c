@@ -0,0 +1,653 @@
+/*********************************************************************
+ * 文件: replay_line_test.c
+ * 补线/延长/画线主机等价性测试
+ * 说明：直接包含image.c（其中的Line_DDA_*为static函数），逐项比对：
+ *       1. Line_DDA_Trunc/Line_DDA_Floor：与逐点公式 v1 + (t - t1) * (v2 - v1) / (t2 - t1)
+ *          （向零取整/向下取整，64位计算）完全相同，t1 == t2时为常量v1
+ *       2. Left/Right_Add_Line：与原逐行乘除实现（legacy_*，取自c7eb64d之前的image.c）写出的边界数组完全相同；
+ *          限幅后两点在同一行时原实现除零，新实现只写该行（限幅后的x1）
+ *       3. Lengthen_Left/Right_Boundry：与精确有理数结果 floor(x + n*t/5)（限幅后）完全相同；
+ *          与原浮点实现比较时，只允许在 n*t 为5的整数倍（结果为整数）的行上比原实现大1
+ *          （原实现的斜率t/5.0存为float不能精确表示，乘回整数时略小于真值被截断），其余行必须相同
+ *       4. Draw_Line：斜线与原实现画出的图像完全相同；竖直线和水平线在起点不大于终点时画满整个范围
+ *          （原实现只画第0、1行/列），结果等于原实现交换起终点后的图像，单点时画该点及其上一行
+ *       输入包括超出图像范围的坐标，固定随机种子
+ *
+ * 构建与运行（在仓库根目录执行；image.c已被本文件包含，不再单独编译）：
+ *   LINE_SRC="replay/replay_hal.c replay/replay_io.c \"code/Image Binarization.c\" code/contour.c code/centerline.c \
+ *       code/element.c code/island.c code/ipm.c code/auto_exposure.c code/frame_log.c code/latency.c"
+ *   eval gcc -O2 -std=gnu99 -DCAR_REPLAY -Ireplay -Isim -Icode -o line_test replay/replay_line_test.c $LINE_SRC -lm
+ *   ./line_test
+ *   任一检查失败时返回1
+ ********************************************************************/
+
+#if defined(CAR_REPLAY) // 仅在主机回放构建中编译
+
+#include "../code/image.c"
+
+//============================================================
+// 宏定义
+//============================================================
+
+#define LINE_TEST_DDA 200000     // Line_DDA随机直线数
+#define LINE_TEST_ADD 1000000    // 补线随机输入数
+#define LINE_TEST_DRAW 200000    // 画线随机输入数
+#define LINE_TEST_MARGIN 30      // 随机坐标超出图像范围的最大像素数
+
+#if IMAGE_PACKED_BINARY
+#define LINE_TEST_IMAGE binaryPacked
+#else
+#define LINE_TEST_IMAGE binaryImage
+#endif
+
+//============================================================
+// 全局变量
+//============================================================
+
+static uint32 line_rng = 1;
+static uint32 line_fail = 0;
+static int saved_left[MT9V03X_H], saved_right[MT9V03X_H];
+static int legacy_left[MT9V03X_H], legacy_right[MT9V03X_H];
+static uint8 legacy_image[sizeof(LINE_TEST_IMAGE)];
+static uint8 swapped_image[sizeof(LINE_TEST_IMAGE)];
+
+//============================================================
+// 原实现（c7eb64d之前的image.c，仅函数名加legacy_前缀、画点改用BINARY_SET_BLACK）
+//============================================================
+
+static void legacy_Left_Add_Line(int x1, int y1, int x2, int y2)
+{
+    int i, max, a1, a2;
+    int hx;
+
+    if (x1 >= MT9V03X_W - 1)
+        x1 = MT9V03X_W - 1;
+    else if (x1 <= 0)
+        x1 = 0;
+    if (y1 >= MT9V03X_H - 1)
+        y1 = MT9V03X_H - 1;
+    else if (y1 <= 0)
+        y1 = 0;
+    if (x2 >= MT9V03X_W - 1)
+        x2 = MT9V03X_W - 1;
+    else if (x2 <= 0)
+        x2 = 0;
+    if (y2 >= MT9V03X_H - 1)
+        y2 = MT9V03X_H - 1;
+    else if (y2 <= 0)
+        y2 = 0;
+
+    a1 = y1;
+    a2 = y2;
+    if (a1 > a2)
+    {
+        max = a1;
+        a1 = a2;
+        a2 = max;
+    }
+
+    for (i = a1; i <= a2; i++)
+    {
+        hx = (i - y1) * (x2 - x1) / (y2 - y1) + x1;
+        if (hx >= MT9V03X_W)
+            hx = MT9V03X_W;
+        else if (hx <= 0)
+            hx = 0;
+        Left_Line[i] = hx;
+    }
+}
+
+static void legacy_Right_Add_Line(int x1, int y1, int x2, int y2)
+{
+    int i, max, a1, a2;
+    int hx;
+
+    if (x1 >= MT9V03X_W - 1)
+        x1 = MT9V03X_W - 1;
+    else if (x1 <= 0)
+        x1 = 0;
+    if (y1 >= MT9V03X_H - 1)
+        y1 = MT9V03X_H - 1;
+    else if (y1 <= 0)
+        y1 = 0;
+    if (x2 >= MT9V03X_W - 1)
+        x2 = MT9V03X_W - 1;
+    else if (x2 <= 0)
+        x2 = 0;
+    if (y2 >= MT9V03X_H - 1)
+        y2 = MT9V03X_H - 1;
+    else if (y2 <= 0)
+        y2 = 0;
+
+    a1 = y1;
+    a2 = y2;
+    if (a1 > a2)
+    {
+        max = a1;
+        a1 = a2;
+        a2 = max;
+    }
+
+    for (i = a1; i <= a2; i++)
+    {
+        hx = (i - y1) * (x2 - x1) / (y2 - y1) + x1;
+        if (hx >= MT9V03X_W)
+            hx = MT9V03X_W;
+        else if (hx <= 0)
+            hx = 0;
+        Right_Line[i] = hx;
+    }
+}
+
+static void legacy_Lengthen_Left_Boundry(int start, int end)
+{
+    int i, t;
+    float k = 0;
+
+    if (start >= MT9V03X_H - 1)
+        start = MT9V03X_H - 1;
+    else if (start <= 0)
+        start = 0;
+    if (end >= MT9V03X_H - 1)
+        end = MT9V03X_H - 1;
+    else if (end <= 0)
+        end = 0;
+
+    if (end < start)
+    {
+        t = end;
+        end = start;
+        start = t;
+    }
+
+    if (start <= 5)
+    {
+        legacy_Left_Add_Line(Left_Line[start], start, Left_Line[end], end);
+    }
+    else
+    {
+        k = (float)(Left_Line[start] - Left_Line[start - 4]) / 5.0;
+        for (i = start; i <= end; i++)
+        {
+            Left_Line[i] = (int)(i - start) * k + Left_Line[start];
+            if (Left_Line[i] >= MT9V03X_W - 1)
+            {
+                Left_Line[i] = MT9V03X_W - 1;
+            }
+            else if (Left_Line[i] <= 0)
+            {
+                Left_Line[i] = 0;
+            }
+        }
+    }
+}
+
+static void legacy_Lengthen_Right_Boundry(int start, int end)
+{
+    int i, t;
+    float k = 0;
+
+    if (start >= MT9V03X_H - 1)
+        start = MT9V03X_H - 1;
+    else if (start <= 0)
+        start = 0;
+    if (end >= MT9V03X_H - 1)
+        end = MT9V03X_H - 1;
+    else if (end <= 0)
+        end = 0;
+
+    if (end < start)
+    {
+        t = end;
+        end = start;
+        start = t;
+    }
+
+    if (start <= 5)
+    {
+        legacy_Right_Add_Line(Right_Line[start], start, Right_Line[end], end);
+    }
+    else
+    {
+        k = (float)(Right_Line[start] - Right_Line[start - 4]) / 5.0;
+        for (i = start; i <= end; i++)
+        {
+            Right_Line[i] = (int)(i - start) * k + Right_Line[start];
+            if (Right_Line[i] >= MT9V03X_W - 1)
+            {
+                Right_Line[i] = MT9V03X_W - 1;
+            }
+            else if (Right_Line[i] <= 0)
+            {
+                Right_Line[i] = 0;
+            }
+        }
+    }
+}
+
+static void legacy_Draw_Line(int startX, int startY, int endX, int endY)
+{
+    int i, x, y;
+    int start = 0, end = 0;
+
+    if (startX >= MT9V03X_W - 1)
+        startX = MT9V03X_W - 1;
+    else if (startX <= 0)
+        startX = 0;
+    if (startY >= MT9V03X_H - 1)
+        startY = MT9V03X_H - 1;
+    else if (startY <= 0)
+        startY = 0;
+    if (endX >= MT9V03X_W - 1)
+        endX = MT9V03X_W - 1;
+    else if (endX <= 0)
+        endX = 0;
+    if (endY >= MT9V03X_H - 1)
+        endY = MT9V03X_H - 1;
+    else if (endY <= 0)
+        endY = 0;
+
+    if (startX == endX)
+    {
+        if (startY > endY)
+        {
+            start = endY;
+            end = startY;
+        }
+        for (i = start; i <= end; i++)
+        {
+            if (i <= 1)
+                i = 1;
+            BINARY_SET_BLACK(i, startX);
+            BINARY_SET_BLACK(i - 1, startX);
+        }
+    }
+    else if (startY == endY)
+    {
+        if (startX > endX)
+        {
+            start = endX;
+            end = startX;
+        }
+        for (i = start; i <= end; i++)
+        {
+            if (startY <= 1)
+                startY = 1;
+            BINARY_SET_BLACK(startY, i);
+            BINARY_SET_BLACK(startY - 1, i);
+        }
+    }
+    else
+    {
+        if (startY > endY)
+        {
+            start = endY;
+            end = startY;
+        }
+        else
+        {
+            start = startY;
+            end = endY;
+        }
+        for (i = start; i <= end; i++)
+        {
+            x = (int)(startX + (endX - startX) * (i - startY) / (endY - startY));
+            if (x >= MT9V03X_W - 1)
+                x = MT9V03X_W - 1;
+            else if (x <= 1)
+                x = 1;
+            BINARY_SET_BLACK(i, x);
+            BINARY_SET_BLACK(i, x - 1);
+        }
+
+        if (startX > endX)
+        {
+            start = endX;
+            end = startX;
+        }
+        else
+        {
+            start = startX;
+            end = endX;
+        }
+        for (i = start; i <= end; i++)
+        {
+            y = (int)(startY + (endY - startY) * (i - startX) / (endX - startX));
+            if (y >= MT9V03X_H - 1)
+                y = MT9V03X_H - 1;
+            else if (y <= 0)
+                y = 0;
+            BINARY_SET_BLACK(y, i);
+        }
+    }
+}
+
+//============================================================
+// 辅助函数
+//============================================================
+
+static int line_rand(int lo, int hi)
+{
+    line_rng = line_rng * 1103515245u + 12345u;
+    return lo + (int)((line_rng >> 8) % (uint32)(hi - lo + 1));
+}
+
+static int line_clamp(int v, int lo, int hi)
+{
+    return v < lo ? lo : (v > hi ? hi : v);
+}
+
+static int64 line_floor_div(int64 a, int64 b)
+{
+    int64 q = a / b;
+    if (a % b != 0 && ((a < 0) != (b < 0)))
+        q--;
+    return q;
+}
+
+static void line_report(const char *what, int a, int b, int c, int d, int row, int got, int expect)
+{
+    if (line_fail < 10)
+        printf("FAIL %s(%d, %d, %d, %d) row %d: got %d, expected %d\n", what, a, b, c, d, row, got, expect);
+    line_fail++;
+}
+
+static void lines_snapshot(void)
+{
+    int i;
+
+    for (i = 0; i < MT9V03X_H; i++)
+    {
+        saved_left[i] = Left_Line[i];
+        saved_right[i] = Right_Line[i];
+    }
+}
+
+static void lines_randomize(void)
+{
+    int i;
+
+    for (i = 0; i < MT9V03X_H; i++)
+    {
+        Left_Line[i] = line_rand(0, MT9V03X_W - 1);
+        Right_Line[i] = line_rand(0, MT9V03X_W - 1);
+    }
+    lines_snapshot();
+}
+
+static void lines_restore(void)
+{
+    int i;
+
+    for (i = 0; i < MT9V03X_H; i++)
+    {
+        Left_Line[i] = saved_left[i];
+        Right_Line[i] = saved_right[i];
+    }
+}
+
+static void lines_save_legacy(void)
+{
+    int i;
+
+    for (i = 0; i < MT9V03X_H; i++)
+    {
+        legacy_left[i] = Left_Line[i];
+        legacy_right[i] = Right_Line[i];
+    }
+}
+
+static void image_clear(void)
+{
+    memset(LINE_TEST_IMAGE, 0xFF, sizeof(LINE_TEST_IMAGE)); // 全白（非压缩图IMG_WHITE为255）
+}
+
+//============================================================
+// 测试
+//============================================================
+
+/**
+ * @brief 1. Line_DDA与逐点公式
+ */
+static void test_dda(void)
+{
+    uint32 k, checks = 0;
+
+    for (k = 0; k < LINE_TEST_DDA; k++)
+    {
+        int v1 = line_rand(-400, 400), v2 = line_rand(-400, 400);
+        int t1 = line_rand(-50, 200), t2 = (k % 50 == 0) ? t1 : line_rand(-50, 200);
+        int t = line_rand(-50, 200), n;
+        Line_DDA dda;
+
+        Line_DDA_Init(&dda, v1, t1, v2, t2, t);
+        for (n = 0; n < 250; n++, t++)
+        {
+            int trunc_expect, floor_expect;
+
+            if (t1 == t2)
+            {
+                trunc_expect = floor_expect = v1;
+            }
+            else
+            {
+                trunc_expect = v1 + (t - t1) * (v2 - v1) / (t2 - t1);
+                floor_expect = v1 + (int)line_floor_div((int64)(t - t1) * (v2 - v1), t2 - t1);
+            }
+            if (Line_DDA_Trunc(&dda) != trunc_expect)
+                line_report("Line_DDA_Trunc", v1, t1, v2, t2, t, Line_DDA_Trunc(&dda), trunc_expect);
+            if (Line_DDA_Floor(&dda) != floor_expect)
+                line_report("Line_DDA_Floor", v1, t1, v2, t2, t, Line_DDA_Floor(&dda), floor_expect);
+            Line_DDA_Step(&dda);
+            checks++;
+        }
+    }
+    printf("Line_DDA: %lu points checked\n", (unsigned long)checks);
+}
+
+/**
+ * @brief 2. 补线与原实现
+ */
+static void test_add_line(void)
+{
+    uint32 k, degenerate = 0;
+    int i;
+
+    for (k = 0; k < LINE_TEST_ADD; k++)
+    {
+        int x1 = line_rand(-LINE_TEST_MARGIN, MT9V03X_W + LINE_TEST_MARGIN);
+        int y1 = line_rand(-LINE_TEST_MARGIN, MT9V03X_H + LINE_TEST_MARGIN);
+        int x2 = line_rand(-LINE_TEST_MARGIN, MT9V03X_W + LINE_TEST_MARGIN);
+        int y2 = (k % 20 == 0) ? y1 : line_rand(-LINE_TEST_MARGIN, MT9V03X_H + LINE_TEST_MARGIN);
+        int row1 = line_clamp(y1, 0, MT9V03X_H - 1), row2 = line_clamp(y2, 0, MT9V03X_H - 1);
+
+        lines_randomize();
+        if (row1 == row2)
+        {
+            // 原实现除零：只检查新实现写且只写该行
+            Left_Add_Line(x1, y1, x2, y2);
+            Right_Add_Line(x1, y1, x2, y2);
+            for (i = 0; i < MT9V03X_H; i++)
+            {
+                int expect_left = (i == row1) ? line_clamp(x1, 0, MT9V03X_W - 1) : saved_left[i];
+                int expect_right = (i == row1) ? line_clamp(x1, 0, MT9V03X_W - 1) : saved_right[i];
+                if (Left_Line[i] != expect_left)
+                    line_report("Left_Add_Line", x1, y1, x2, y2, i, Left_Line[i], expect_left);
+                if (Right_Line[i] != expect_right)
+                    line_report("Right_Add_Line", x1, y1, x2, y2, i, Right_Line[i], expect_right);
+            }
+            degenerate++;
+            continue;
+        }
+
+        legacy_Left_Add_Line(x1, y1, x2, y2);
+        legacy_Right_Add_Line(x1, y1, x2, y2);
+        lines_save_legacy();
+        lines_restore();
+        Left_Add_Line(x1, y1, x2, y2);
+        Right_Add_Line(x1, y1, x2, y2);
+        for (i = 0; i < MT9V03X_H; i++)
+        {
+            if (Left_Line[i] != legacy_left[i])
+                line_report("Left_Add_Line", x1, y1, x2, y2, i, Left_Line[i], legacy_left[i]);
+            if (Right_Line[i] != legacy_right[i])
+                line_report("Right_Add_Line", x1, y1, x2, y2, i, Right_Line[i], legacy_right[i]);
+        }
+    }
+    printf("Left/Right_Add_Line: %lu inputs, %lu on a single row\n", (unsigned long)LINE_TEST_ADD,
+           (unsigned long)degenerate);
+}
+
+/**
+ * @brief 3. 延长边界：精确结果与原实现（全部起点值、斜率和若干起止行）
+ */
+static void test_lengthen(void)
+{
+    static const int rows[][2] = {{6, 119}, {6, 7}, {30, 119}, {60, 40}, {100, 119}, {119, 119}, {3, 90}, {119, 0}};
+    uint32 calls = 0, rows_checked = 0, rounding_fixed = 0;
+    int r, base, prev, side, i;
+
+    for (r = 0; r < (int)(sizeof(rows) / sizeof(rows[0])); r++)
+    {
+        int start = rows[r][0] < rows[r][1] ? rows[r][0] : rows[r][1];
+        int end = rows[r][0] < rows[r][1] ? rows[r][1] : rows[r][0];
+
+        for (base = -5; base <= MT9V03X_W + 5; base++)
+        {
+            for (prev = -5; prev <= MT9V03X_W + 5; prev++)
+            {
+                for (side = 0; side < 2; side++)
+                {
+                    volatile int *line = side ? Right_Line : Left_Line;
+                    const int *legacy = side ? legacy_right : legacy_left;
+                    const char *name = side ? "Lengthen_Right_Boundry" : "Lengthen_Left_Boundry";
+
+                    lines_randomize();
+                    line[start] = base;
+                    if (start >= 4)
+                        line[start - 4] = prev;
+                    else
+                        line[end] = prev;
+                    lines_snapshot();
+
+                    if (start <= 5 && start == end)
+                        continue; // 走补线分支且两点同行，原实现除零（补线单行情况已在test_add_line中检查）
+
+                    if (side)
+                        legacy_Lengthen_Right_Boundry(rows[r][0], rows[r][1]);
+                    else
+                        legacy_Lengthen_Left_Boundry(rows[r][0], rows[r][1]);
+                    lines_save_legacy();
+                    lines_restore();
+                    if (side)
+                        Lengthen_Right_Boundry(rows[r][0], rows[r][1]);
+                    else
+                        Lengthen_Left_Boundry(rows[r][0], rows[r][1]);
+                    calls++;
+
+                    for (i = 0; i < MT9V03X_H; i++)
+                    {
+                        int got = line[i];
+                        int old = legacy[i];
+
+                        if (start > 5 && i >= start && i <= end)
+                        {
+                            // 精确结果：x + floor((i - start) * t / 5)，x为限幅后的起点
+                            int x = line_clamp(base, 0, MT9V03X_W - 1);
+                            int64 num = (int64)(i - start) * (base - prev);
+                            int exact = line_clamp(x + (int)line_floor_div(num, 5), 0, MT9V03X_W - 1);
+
+                            if (got != exact)
+                                line_report(name, base, prev, start, end, i, got, exact);
+                            if (got != old)
+                            {
+                                // 只允许原实现在精确整数处因float斜率少1
+                                if (num % 5 == 0 && old == got - 1)
+                                    rounding_fixed++;
+                                else
+                                    line_report(name, base, prev, start, end, i, got, old);
+                            }
+                            rows_checked++;
+                        }
+                        else if (got != old)
+                        {
+                            line_report(name, base, prev, start, end, i, got, old);
+                        }
+                    }
+                }
+            }
+        }
+    }
+    printf("Lengthen_Left/Right_Boundry: %lu calls, %lu extended rows, %lu rows one pixel higher than the "
+           "float original (all at exact integer results)\n",
+           (unsigned long)calls, (unsigned long)rows_checked, (unsigned long)rounding_fixed);
+}
+
+/**
+ * @brief 4. 画线与原实现
+ */
+static void test_draw_line(void)
+{
+    uint32 k, diagonal = 0, straight = 0, point = 0;
+
+    for (k = 0; k < LINE_TEST_DRAW; k++)
+    {
+        int sx = line_rand(-LINE_TEST_MARGIN, MT9V03X_W + LINE_TEST_MARGIN);
+        int sy = line_rand(-LINE_TEST_MARGIN, MT9V03X_H + LINE_TEST_MARGIN);
+        int ex = (k % 7 == 0) ? sx : line_rand(-LINE_TEST_MARGIN, MT9V03X_W + LINE_TEST_MARGIN);
+        int ey = (k % 5 == 0) ? sy : line_rand(-LINE_TEST_MARGIN, MT9V03X_H + LINE_TEST_MARGIN);
+        int csx = line_clamp(sx, 0, MT9V03X_W - 1), csy = line_clamp(sy, 0, MT9V03X_H - 1);
+        int cex = line_clamp(ex, 0, MT9V03X_W - 1), cey = line_clamp(ey, 0, MT9V03X_H - 1);
+        const uint8 *expect;
+
+        image_clear();
+        legacy_Draw_Line(sx, sy, ex, ey);
+        memcpy(legacy_image, LINE_TEST_IMAGE, sizeof(legacy_image));
+        image_clear();
+        legacy_Draw_Line(ex, ey, sx, sy);
+        memcpy(swapped_image, LINE_TEST_IMAGE, sizeof(swapped_image));
+        image_clear();
+        Draw_Line(sx, sy, ex, ey);
+
+        if (csx == cex && csy == cey)
+        {
+            // 单点：画该点及其上一行（第0行时画第0、1行）
+            int row = csy <= 1 ? 1 : csy;
+            image_clear();
+            BINARY_SET_BLACK(row, csx);
+            BINARY_SET_BLACK(row - 1, csx);
+            memcpy(swapped_image, LINE_TEST_IMAGE, sizeof(swapped_image));
+            image_clear();
+            Draw_Line(sx, sy, ex, ey);
+            expect = swapped_image;
+            point++;
+        }
+        else if (csx == cex || csy == cey)
+        {
+            // 竖直/水平线：画满范围，等于原实现按从大到小的顺序给出端点时的结果
+            expect = (csx == cex ? csy > cey : csx > cex) ? legacy_image : swapped_image;
+            straight++;
+        }
+        else
+        {
+            expect = legacy_image;
+            diagonal++;
+        }
+        if (memcmp(LINE_TEST_IMAGE, expect, sizeof(legacy_image)) != 0)
+            line_report("Draw_Line", sx, sy, ex, ey, -1, 0, 0);
+    }
+    printf("Draw_Line: %lu diagonal, %lu vertical/horizontal, %lu single-point inputs\n", (unsigned long)diagonal,
+           (unsigned long)straight, (unsigned long)point);
+}
+
+int main(void)
+{
+    test_dda();
+    test_add_line();
+    test_lengthen();
+    test_draw_line();
+    printf(line_fail ? "FAILED (%lu)\n" : "PASSED\n", (unsigned long)line_fail);
+    return line_fail ? 1 : 0;
+}
+
+#endif
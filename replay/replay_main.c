@@ -0,0 +1,226 @@
+/*********************************************************************
+ * 文件: replay_main.c
+ * 主机图像回放主程序
+ * 说明：链接未经修改的图像处理代码（image.c、Image Binarization.c、元素检测、逆透视、中线拟合等），
+ *       摄像头与串口接口由replay_hal.c实现；按顺序读入录制的帧，逐帧调用image_process_frame()，
+ *       用frame_log_csv_line()输出与车上格式相同的CSV（耗时列固定为0，便于与参考结果逐行比对），
+ *       结束时在stderr输出处理帧率（只计image_process_frame()和转向误差计算，不含读文件）
+ *       元素状态机跨帧保持状态，同一序列的帧应放在一次运行中按顺序处理，不同序列分别运行
+ *
+ * 构建（在仓库根目录执行）：
+ *   REPLAY_SRC="replay/replay_hal.c replay/replay_io.c code/image.c \"code/Image Binarization.c\" \
+ *       code/contour.c code/centerline.c code/element.c code/island.c code/ipm.c \
+ *       code/auto_exposure.c code/frame_log.c code/latency.c"
+ *   eval gcc -O2 -std=gnu99 -DCAR_REPLAY -Ireplay -Isim -Icode -o car_replay replay/replay_main.c $REPLAY_SRC -lm
+ *   图像处理的编译开关（IMAGE_PACKED_BINARY等，见image.h）可用 -D名称=1 按配置构建
+ *
+ * 用法：
+ *   ./car_replay [选项] 帧文件...
+ *     帧文件                          车上录制的FRM0帧流（可含多帧）或188x120的PGM（P5），按顺序处理
+ *     --repeat N                      把全部帧重复处理N遍用于测速（只输出第一遍的CSV，默认1）
+ *     --quiet                         不输出CSV
+ *     --pgm 前缀                      把读入的每帧另存为 前缀<帧号>.pgm（查看录制的帧）
+ *     --set 名称=值                   修改图像处理参数（可重复，名称见replay_params[]）
+ *   参考结果比对与多配置回归见replay/check.sh
+ ********************************************************************/
+
+#if defined(CAR_REPLAY) // 仅在主机回放构建中编译
+
+#include "zf_common_headfile.h"
+#include "replay_io.h"
+#include <time.h>
+
+//============================================================
+// 宏定义
+//============================================================
+
+#define REPLAY_STEER_START 50 // 转向误差采样起始行（与pid.c中steer_sample_start默认值一致）
+#define REPLAY_STEER_END 60   // 转向误差采样结束行（与pid.c中steer_sample_end默认值一致）
+
+//============================================================
+// 可修改参数表（车上为菜单参数或固定值，回放时默认与固件相同）
+//============================================================
+
+typedef struct
+{
+    const char *name;
+    int *i;    // 有符号参数
+    uint32 *u; // 无符号参数
+} Replay_Param;
+
+static const Replay_Param replay_params[] = {
+    {"ramp_offset", &Ramp_offset, NULL},
+    {"adaptive", NULL, &adaptive_threshold_enable},
+    {"adaptive_offset", NULL, &adaptive_threshold_offset},
+    {"adaptive_margin", NULL, &adaptive_threshold_margin},
+};
+
+//============================================================
+// 内部函数
+//============================================================
+
+/**
+ * @brief 按 名称=值 修改一个参数
+ * @return 1=成功，0=名称不存在或格式错误
+ */
+static uint8 replay_set_param(const char *assignment)
+{
+    const char *eq = strchr(assignment, '=');
+    uint32 k;
+
+    if (eq == NULL)
+        return 0;
+    for (k = 0; k < sizeof(replay_params) / sizeof(replay_params[0]); k++)
+    {
+        if (strlen(replay_params[k].name) == (size_t)(eq - assignment) &&
+            strncmp(replay_params[k].name, assignment, eq - assignment) == 0)
+        {
+            if (replay_params[k].i != NULL)
+                *replay_params[k].i = atoi(eq + 1);
+            else
+                *replay_params[k].u = (uint32)strtoul(eq + 1, NULL, 10);
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static double replay_now_s(void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double)now.tv_sec + (double)now.tv_nsec * 1e-9;
+}
+
+int main(int argc, char **argv)
+{
+    uint8 *frames = NULL;
+    uint32 *frame_ids = NULL;
+    uint32 frame_num = 0, frame_cap = 0;
+    uint32 repeat = 1, quiet = 0, pass, n;
+    const char *pgm_prefix = NULL;
+    double process_s = 0.0;
+    int i;
+
+    // 1. 命令行与读帧
+    for (i = 1; i < argc; i++)
+    {
+        Replay_Source src;
+        uint32 frame_id;
+
+        if (strcmp(argv[i], "--repeat") == 0 && i + 1 < argc)
+        {
+            repeat = (uint32)atoi(argv[++i]);
+            if (repeat == 0)
+                repeat = 1;
+            continue;
+        }
+        if (strcmp(argv[i], "--quiet") == 0)
+        {
+            quiet = 1;
+            continue;
+        }
+        if (strcmp(argv[i], "--pgm") == 0 && i + 1 < argc)
+        {
+            pgm_prefix = argv[++i];
+            continue;
+        }
+        if (strcmp(argv[i], "--set") == 0 && i + 1 < argc)
+        {
+            if (!replay_set_param(argv[++i]))
+            {
+                fprintf(stderr, "unknown parameter %s\n", argv[i]);
+                return 1;
+            }
+            continue;
+        }
+        if (argv[i][0] == '-')
+        {
+            fprintf(stderr, "unknown option %s\n", argv[i]);
+            return 1;
+        }
+
+        if (!replay_open(&src, argv[i]))
+            return 1;
+        for (;;)
+        {
+            if (frame_num == frame_cap)
+            {
+                frame_cap = frame_cap ? frame_cap * 2 : 64;
+                frames = (uint8 *)realloc(frames, (size_t)frame_cap * REPLAY_FRAME_SIZE);
+                frame_ids = (uint32 *)realloc(frame_ids, (size_t)frame_cap * sizeof(uint32));
+                if (frames == NULL || frame_ids == NULL)
+                {
+                    fprintf(stderr, "out of memory\n");
+                    return 1;
+                }
+            }
+            frame_id = frame_num;
+            if (!replay_read(&src, frames + (size_t)frame_num * REPLAY_FRAME_SIZE, &frame_id))
+                break;
+            frame_ids[frame_num++] = frame_id;
+        }
+        replay_close(&src);
+    }
+    if (frame_num == 0)
+    {
+        fprintf(stderr, "usage: car_replay [--repeat N] [--quiet] [--pgm prefix] [--set name=value] frame files...\n");
+        return 1;
+    }
+
+    if (pgm_prefix != NULL)
+    {
+        char path[512];
+
+        for (n = 0; n < frame_num; n++)
+        {
+            snprintf(path, sizeof(path), "%s%lu.pgm", pgm_prefix, (unsigned long)frame_ids[n]);
+            if (!replay_write_pgm(path, frames + (size_t)n * REPLAY_FRAME_SIZE))
+            {
+                fprintf(stderr, "%s: cannot write\n", path);
+                return 1;
+            }
+        }
+    }
+
+    // 2. 初始化（与cpu0_main.c中的顺序一致）
+    ipm_init();
+    centerline_init();
+
+    // 3. 逐帧处理：帧写入采集缓冲区后按三缓冲采集的方式直接处理（不复制）
+    if (!quiet)
+        frame_log_csv_header();
+    for (pass = 0; pass < repeat; pass++)
+    {
+        for (n = 0; n < frame_num; n++)
+        {
+            double start;
+            float steer_error;
+
+            memcpy(mt9v03x_image[0], frames + (size_t)n * REPLAY_FRAME_SIZE, REPLAY_FRAME_SIZE);
+            mt9v03x_frame_id = frame_ids[n];
+            image_frame_id = frame_ids[n];
+
+            start = replay_now_s();
+            image_process_frame(mt9v03x_image[0], NULL);
+            steer_error = err_sum_average(REPLAY_STEER_START, REPLAY_STEER_END);
+            process_s += replay_now_s() - start;
+
+            if (!quiet && pass == 0)
+                frame_log_csv_line(image_frame_id, steer_error, 0);
+        }
+    }
+    fflush(stdout);
+
+    // 4. 帧率
+    fprintf(stderr, "%lu frames x %lu, %.3f ms, %.0f frames/s, %.1f us/frame\n",
+            (unsigned long)frame_num, (unsigned long)repeat, process_s * 1e3,
+            (double)frame_num * repeat / process_s, process_s * 1e6 / ((double)frame_num * repeat));
+
+    free(frames);
+    free(frame_ids);
+    return 0;
+}
+
+#endif
@@ -0,0 +1,483 @@
+/*********************************************************************
+ * 文件: replay_otsu_test.c
+ * 大津法阈值主机测试
+ * 说明：把otsu_threshold_from_histogram()（Image Binarization.c）与本文件中的参考实现逐直方图比对，并测量耗时。
+ *       参考实现直接按定义计算每个分割点的类间方差 num^2/(wB*wF)，用128位整数交叉相乘精确比较，
+ *       多个分割点方差相同时取最小的阈值（与固件约定一致）；它不使用固件中的带余除法拆分，两者互相独立。
+ *       OTSU_COARSE_STEP为1时要求与全局最大值逐个相同；
+ *       OTSU_COARSE_STEP>1时按粗搜+细搜的约定（粗搜取步长网格上的最大值，再在其两侧各一个步长内取最大值；
+ *       网格上没有可分割的点时取全局最大值）比对，
+ *       并统计与全局最大值不同的直方图数（多峰直方图上粗搜可能错过全局最大值，只输出不判失败）。
+ *       测试直方图：
+ *         1. 平局：三个等高等距的峰，两个分割点方差完全相等，必须返回较小的阈值
+ *         2. 单步长：全部像素落在一个粗搜步长内（饱和帧、相邻灰度的窄双峰），任何步长下都必须返回全局最大值
+ *         3. 边界：单一灰度、两个灰度、相邻两个灰度、全部像素在0或255
+ *         4. 随机直方图（固定种子，多峰、稀疏、噪声），像素数与隔行隔列采样相同
+ *         5. 命令行给出的帧文件（如replay/frames/下的.frm帧流），用image_copy_histogram()统计
+ *       耗时为固件实现、参考实现和原浮点实现（逐级pow()计算、方差首次下降即退出，仅用于对比）每个直方图的平均耗时，
+ *       取多遍中的最小值，为主机上的数值
+ *
+ * 构建与运行（在仓库根目录执行，REPLAY_SRC见replay_main.c）：
+ *   eval gcc -O2 -std=gnu99 -DCAR_REPLAY -Ireplay -Isim -Icode -o otsu_test replay/replay_otsu_test.c $REPLAY_SRC -lm
+ *   ./otsu_test replay/frames/[a-z]*.frm
+ *   eval gcc -O2 -std=gnu99 -DCAR_REPLAY -DOTSU_COARSE_STEP=4 -Ireplay -Isim -Icode -o otsu_test_coarse replay/replay_otsu_test.c $REPLAY_SRC -lm
+ *   ./otsu_test_coarse replay/frames/[a-z]*.frm
+ *   任一直方图结果不符时返回1
+ ********************************************************************/
+
+#if defined(CAR_REPLAY) // 仅在主机回放构建中编译
+
+#include "zf_common_headfile.h"
+#include "replay_io.h"
+#include <math.h>
+#include <time.h>
+
+//============================================================
+// 宏定义
+//============================================================
+
+#define OTSU_TEST_RANDOM 20000  // 随机直方图个数
+#define OTSU_TEST_MAX_HIST 30000 // 最多测试的直方图个数
+#define OTSU_TEST_REPEAT 7      // 测时重复遍数（取最小值）
+
+//============================================================
+// 类型定义
+//============================================================
+
+typedef struct
+{
+    uint16 hist[GRAY_LEVELS];
+    uint32 pixel_sum;
+    uint32 gray_sum;
+} Otsu_Case;
+
+typedef unsigned __int128 otsu_u128;
+
+//============================================================
+// 全局变量
+//============================================================
+
+static Otsu_Case cases[OTSU_TEST_MAX_HIST];
+static uint32 case_num = 0;
+static uint32 rng = 12345;
+
+//============================================================
+// 参考实现
+//============================================================
+
+/**
+ * @brief 按定义计算分割点t（灰度<=t为背景）的类间方差 num2/den
+ * @return 1=有效分割，0=背景或前景为空
+ */
+static uint8 otsu_reference_variance(const Otsu_Case *c, int t, otsu_u128 *num2, uint64 *den)
+{
+    uint64 wB = 0, sumB = 0, wF;
+    uint64 abs_num;
+    int64 num;
+    int j;
+
+    for (j = 0; j <= t; j++)
+    {
+        wB += c->hist[j];
+        sumB += (uint64)j * c->hist[j];
+    }
+    wF = c->pixel_sum - wB;
+    if (wB == 0 || wF == 0)
+        return 0;
+    num = (int64)c->pixel_sum * (int64)sumB - (int64)c->gray_sum * (int64)wB;
+    abs_num = (uint64)(num < 0 ? -num : num);
+    *num2 = (otsu_u128)abs_num * abs_num;
+    *den = wB * wF;
+    return 1;
+}
+
+/**
+ * @brief 在阈值集合 {lo, lo+step, ...} ∩ [lo, hi] 中找类间方差严格最大的第一个阈值
+ * @param fallback 集合中没有方差大于0的分割点时的返回值
+ */
+static int otsu_reference_range(const Otsu_Case *c, int lo, int hi, int step, int fallback)
+{
+    otsu_u128 best_num2 = 0, num2;
+    uint64 best_den = 1, den;
+    int threshold = fallback;
+    int t;
+
+    for (t = lo; t <= hi; t += step)
+    {
+        if (!otsu_reference_variance(c, t, &num2, &den))
+            continue;
+        // num2/den > best_num2/best_den
+        if (num2 * best_den > best_num2 * den)
+        {
+            best_num2 = num2;
+            best_den = den;
+            threshold = t;
+        }
+    }
+    return threshold;
+}
+
+/**
+ * @brief 全局最大值（OTSU_COARSE_STEP为1时的约定）
+ */
+static int otsu_reference(const Otsu_Case *c)
+{
+    return otsu_reference_range(c, 0, GRAY_LEVELS - 1, 1, 0);
+}
+
+#if OTSU_COARSE_STEP > 1
+/**
+ * @brief 粗搜+细搜的约定（OTSU_COARSE_STEP>1）
+ * @note 粗搜点都无法分割（全部像素落在同一个步长内）时与全局最大值相同
+ */
+static int otsu_reference_coarse(const Otsu_Case *c, int step)
+{
+    int coarse = otsu_reference_range(c, step - 1, GRAY_LEVELS - 1, step, -1);
+    int lo, hi;
+
+    if (coarse < 0)
+        return otsu_reference(c);
+    lo = coarse - step + 1;
+    hi = coarse + step - 1;
+
+    if (lo < 0)
+        lo = 0;
+    if (hi > GRAY_LEVELS - 1)
+        hi = GRAY_LEVELS - 1;
+    return otsu_reference_range(c, lo, hi, 1, coarse);
+}
+#endif
+
+/**
+ * @brief 原浮点实现（cb31f0f之前的otsu_threshold_from_histogram()，仅用于耗时和结果对比）
+ */
+static int otsu_float_original(const uint16 *hist, uint32 pixel_sum, uint32 gray_sum)
+{
+    float pixelPro[GRAY_LEVELS];
+    int j;
+    int threshold = 0;
+
+    for (j = 0; j < GRAY_LEVELS; j++)
+    {
+        pixelPro[j] = (float)hist[j] / pixel_sum;
+    }
+    float w0, w1, u0tmp, u1tmp, u0, u1, u, deltaTmp, deltaMax = 0;
+    w0 = w1 = u0tmp = u1tmp = u0 = u1 = u = deltaTmp = 0;
+    for (j = 0; j < GRAY_LEVELS; j++)
+    {
+        w0 += pixelPro[j];
+        u0tmp += j * pixelPro[j];
+        w1 = 1 - w0;
+        u1tmp = gray_sum / pixel_sum - u0tmp;
+        u0 = u0tmp / w0;
+        u1 = u1tmp / w1;
+        u = u0tmp + u1tmp;
+        deltaTmp = w0 * pow((u0 - u), 2) + w1 * pow((u1 - u), 2);
+        if (deltaTmp > deltaMax)
+        {
+            deltaMax = deltaTmp;
+            threshold = j;
+        }
+        if (deltaTmp < deltaMax)
+        {
+            break;
+        }
+    }
+    return threshold;
+}
+
+//============================================================
+// 测试直方图
+//============================================================
+
+static uint32 test_rand(void)
+{
+    rng = rng * 1103515245u + 12345u;
+    return (rng >> 8) & 0xFFFFFF;
+}
+
+static Otsu_Case *case_begin(void)
+{
+    Otsu_Case *c = &cases[case_num++];
+
+    memset(c, 0, sizeof(*c));
+    return c;
+}
+
+static void case_finish(Otsu_Case *c)
+{
+    int j;
+
+    c->pixel_sum = 0;
+    c->gray_sum = 0;
+    for (j = 0; j < GRAY_LEVELS; j++)
+    {
+        c->pixel_sum += c->hist[j];
+        c->gray_sum += (uint32)j * c->hist[j];
+    }
+}
+
+/**
+ * @brief 加一个以center为中心、半宽width的三角形峰，共count个像素
+ */
+static void case_add_peak(Otsu_Case *c, int center, int width, uint32 count)
+{
+    uint32 placed = 0;
+
+    while (placed < count)
+    {
+        int level = center + (int)(test_rand() % (2 * width + 1)) - width + (int)(test_rand() % (2 * width + 1)) - width;
+        level /= 2;
+        level = level < 0 ? 0 : (level > GRAY_LEVELS - 1 ? GRAY_LEVELS - 1 : level);
+        c->hist[level]++;
+        placed++;
+    }
+}
+
+/**
+ * @brief 平局直方图：三个等高的单灰度峰，中间峰居中，以中间峰左侧和右侧分割的方差相等
+ * @return 平局中较小的阈值
+ */
+static int case_tie(Otsu_Case *c, int low, int gap, uint16 count)
+{
+    c->hist[low] = count;
+    c->hist[low + gap] = count;
+    c->hist[low + 2 * gap] = count;
+    case_finish(c);
+    return low;
+}
+
+static void cases_build(void)
+{
+    Otsu_Case *c;
+    uint32 k;
+
+    // 1. 边界
+    c = case_begin(); // 单一灰度：没有可分割的点
+    c->hist[128] = OTSU_SAMPLE_COUNT;
+    case_finish(c);
+    c = case_begin(); // 全部为0
+    c->hist[0] = OTSU_SAMPLE_COUNT;
+    case_finish(c);
+    c = case_begin(); // 全部为255
+    c->hist[255] = OTSU_SAMPLE_COUNT;
+    case_finish(c);
+    c = case_begin(); // 两个灰度：分割点为较低的灰度
+    c->hist[40] = 1000;
+    c->hist[220] = OTSU_SAMPLE_COUNT - 1000;
+    case_finish(c);
+    c = case_begin(); // 相邻两个灰度
+    c->hist[99] = 3000;
+    c->hist[100] = OTSU_SAMPLE_COUNT - 3000;
+    case_finish(c);
+    c = case_begin(); // 0和255各占一半
+    c->hist[0] = OTSU_SAMPLE_COUNT / 2;
+    c->hist[255] = OTSU_SAMPLE_COUNT / 2;
+    case_finish(c);
+
+    // 2. 随机直方图
+    for (k = 0; k < OTSU_TEST_RANDOM; k++)
+    {
+        uint32 peaks = 1 + test_rand() % 4;
+        uint32 left = OTSU_SAMPLE_COUNT;
+        uint32 p;
+
+        c = case_begin();
+        switch (k % 3)
+        {
+        case 0: // 多峰
+            for (p = 0; p < peaks; p++)
+            {
+                uint32 count = (p == peaks - 1) ? left : test_rand() % (left + 1);
+                case_add_peak(c, (int)(test_rand() % GRAY_LEVELS), 1 + (int)(test_rand() % 40), count);
+                left -= count;
+            }
+            break;
+        case 1: // 稀疏：少数几个灰度级
+            for (p = 0; p < 2 + peaks * 2; p++)
+                c->hist[test_rand() % GRAY_LEVELS] += (uint16)(1 + test_rand() % (OTSU_SAMPLE_COUNT / 8));
+            break;
+        default: // 噪声：均匀分布叠加一个峰
+            for (p = 0; p < OTSU_SAMPLE_COUNT / 2; p++)
+                c->hist[test_rand() % GRAY_LEVELS]++;
+            case_add_peak(c, (int)(test_rand() % GRAY_LEVELS), 1 + (int)(test_rand() % 20), OTSU_SAMPLE_COUNT / 2);
+            break;
+        }
+        case_finish(c);
+    }
+}
+
+static double now_s(void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double)now.tv_sec + (double)now.tv_nsec * 1e-9;
+}
+
+/**
+ * @brief 测量一种实现每个直方图的平均耗时（ns，多遍取最小值）
+ */
+static double time_otsu(int (*fn)(const uint16 *, uint32, uint32), volatile int *sink)
+{
+    double best = 1e30;
+    int r;
+    uint32 k;
+
+    for (r = 0; r < OTSU_TEST_REPEAT; r++)
+    {
+        double start = now_s();
+        for (k = 0; k < case_num; k++)
+            *sink += fn(cases[k].hist, cases[k].pixel_sum, cases[k].gray_sum);
+        double t = (now_s() - start) * 1e9 / case_num;
+        if (t < best)
+            best = t;
+    }
+    return best;
+}
+
+static int otsu_reference_adapter(const uint16 *hist, uint32 pixel_sum, uint32 gray_sum)
+{
+    Otsu_Case c;
+
+    memcpy(c.hist, hist, sizeof(c.hist));
+    c.pixel_sum = pixel_sum;
+    c.gray_sum = gray_sum;
+    return otsu_reference(&c);
+}
+
+int main(int argc, char **argv)
+{
+    static uint8 frame[REPLAY_FRAME_SIZE] IFX_ALIGN(4);
+    uint32 fail = 0, coarse_miss = 0, float_diff = 0, frame_first, frame_num = 0;
+    volatile int sink = 0;
+    int i, tie_low, got;
+    uint32 k;
+
+    // 1. 平局（最先检查，失败时输出详细信息）
+    printf("OTSU_COARSE_STEP = %d\n", OTSU_COARSE_STEP);
+    {
+        static const int tie_cases[][2] = {{50, 78}, {10, 100}, {100, 1}, {0, 127}};
+        for (k = 0; k < sizeof(tie_cases) / sizeof(tie_cases[0]); k++)
+        {
+            Otsu_Case *c = case_begin();
+            tie_low = case_tie(c, tie_cases[k][0], tie_cases[k][1], OTSU_SAMPLE_COUNT / 3);
+            // 参考实现在两个分割点上的方差必须相等，且最大值取在较小的阈值
+            int high = tie_low + tie_cases[k][1];
+            int ref = otsu_reference(c);
+            otsu_u128 num2_low = 0, num2_high = 0;
+            uint64 den_low = 1, den_high = 1;
+            otsu_reference_variance(c, tie_low, &num2_low, &den_low);
+            otsu_reference_variance(c, high, &num2_high, &den_high);
+            got = otsu_threshold_from_histogram(c->hist, c->pixel_sum, c->gray_sum);
+            printf("tie %d|%d: firmware %d, reference %d, float original %d\n", tie_low, high, got, ref,
+                   otsu_float_original(c->hist, c->pixel_sum, c->gray_sum));
+            if (ref != tie_low || num2_low * den_high != num2_high * den_low)
+            {
+                printf("  test histogram is not a tie\n");
+                fail++;
+            }
+#if OTSU_COARSE_STEP > 1
+            if (got != otsu_reference_coarse(c, OTSU_COARSE_STEP))
+#else
+            if (got != tie_low)
+#endif
+            {
+                printf("  FAIL: lower threshold of the tie expected\n");
+                fail++;
+            }
+        }
+    }
+
+    // 2. 单步长：粗搜网格上没有可分割的点，必须退回全局最大值（否则返回0，整幅图判为白）
+    {
+        // {起始灰度, 灰度数}：饱和帧、窄双峰100/101、最低和最高的一个步长
+        static const int narrow_cases[][2] = {{250, 6}, {252, 4}, {100, 2}, {101, 2}, {0, 2}, {254, 2}};
+        for (k = 0; k < sizeof(narrow_cases) / sizeof(narrow_cases[0]); k++)
+        {
+            Otsu_Case *c = case_begin();
+            int low = narrow_cases[k][0], width = narrow_cases[k][1], ref;
+            uint32 left = OTSU_SAMPLE_COUNT;
+
+            for (i = 0; i < width; i++)
+            {
+                uint16 count = (i == width - 1) ? (uint16)left : (uint16)(left / (width - i) + (uint32)i * 37);
+                c->hist[low + i] = count;
+                left -= count;
+            }
+            case_finish(c);
+            ref = otsu_reference(c);
+            got = otsu_threshold_from_histogram(c->hist, c->pixel_sum, c->gray_sum);
+            printf("narrow %d..%d: firmware %d, reference %d\n", low, low + width - 1, got, ref);
+            if (got != ref || ref < low)
+            {
+                printf("  FAIL: global maximum expected\n");
+                fail++;
+            }
+        }
+    }
+
+    // 3. 边界与随机直方图
+    cases_build();
+
+    // 4. 帧文件
+    frame_first = case_num;
+    for (i = 1; i < argc; i++)
+    {
+        Replay_Source src;
+        uint32 frame_id = 0;
+
+        if (!replay_open(&src, argv[i]))
+            return 1;
+        while (case_num < OTSU_TEST_MAX_HIST && replay_read(&src, frame, &frame_id))
+        {
+            Otsu_Case *c = case_begin();
+            c->gray_sum = image_copy_histogram(frame, NULL, c->hist);
+            c->pixel_sum = OTSU_SAMPLE_COUNT;
+            frame_num++;
+        }
+        replay_close(&src);
+    }
+
+    // 5. 逐个比对
+    for (k = 0; k < case_num; k++)
+    {
+        const Otsu_Case *c = &cases[k];
+        int exact = otsu_reference(c);
+#if OTSU_COARSE_STEP > 1
+        int expect = otsu_reference_coarse(c, OTSU_COARSE_STEP);
+#else
+        int expect = exact;
+#endif
+        got = otsu_threshold_from_histogram(c->hist, c->pixel_sum, c->gray_sum);
+        if (got != expect)
+        {
+            if (fail < 10)
+                printf("FAIL: histogram %lu: firmware %d, expected %d\n", (unsigned long)k, got, expect);
+            fail++;
+        }
+        if (got != exact)
+        {
+            coarse_miss++;
+            if (k >= frame_first)
+                printf("frame histogram %lu: coarse search %d, global maximum %d\n",
+                       (unsigned long)(k - frame_first), got, exact);
+        }
+        if (otsu_float_original(c->hist, c->pixel_sum, c->gray_sum) != exact)
+            float_diff++;
+    }
+    printf("%lu histograms (%lu from frames): %lu mismatches, %lu differ from the global maximum, "
+           "float original differs on %lu\n",
+           (unsigned long)case_num, (unsigned long)frame_num, (unsigned long)fail, (unsigned long)coarse_miss,
+           (unsigned long)float_diff);
+
+    // 6. 耗时
+    printf("time per histogram: firmware %.1f ns, reference %.1f ns, float original %.1f ns\n",
+           time_otsu(otsu_threshold_from_histogram, &sink), time_otsu(otsu_reference_adapter, &sink),
+           time_otsu(otsu_float_original, &sink));
+
+    printf(fail ? "FAILED\n" : "PASSED\n");
+    return fail ? 1 : 0;
+}
+
+#endif
@@ -0,0 +1,60 @@
+/*********************************************************************
+ * 文件: zf_common_headfile.h（主机回放）
+ * 主机图像回放用的公共头文件，替代逐飞库的同名文件
+ * 说明：只声明图像处理代码（image/二值化/元素/中线等）用到的摄像头与串口接口，实现在replay_hal.c中；
+ *       类型定义与STM0定时器沿用sim/中的替代头文件（构建时 -Ireplay -Isim -Icode，本目录优先）
+ ********************************************************************/
+
+#ifndef _zf_common_headfile_h_
+#define _zf_common_headfile_h_
+
+#include "zf_common_typedef.h"
+
+//============================================================
+// 摄像头（与zf_device_mt9v03x.h一致）
+//============================================================
+
+#define MT9V03X_W (188)
+#define MT9V03X_H (120)
+#define MT9V03X_IMAGE_SIZE (MT9V03X_W * MT9V03X_H)
+#define MT9V03X_FRAME_BUFFER_NUM (3)
+
+#define IFX_ALIGN(n) __attribute__((aligned(n)))
+
+extern vuint8 mt9v03x_finish_flag;
+extern uint8 mt9v03x_image[MT9V03X_H][MT9V03X_W];
+extern vuint32 mt9v03x_frame_id;
+extern vuint32 mt9v03x_frame_vsync_stamp;
+extern vuint32 mt9v03x_frame_done_stamp;
+extern vuint16 mt9v03x_exposure_time;
+
+uint8 mt9v03x_set_exposure_time_async(uint16 light);
+uint8 mt9v03x_exposure_poll(void);
+uint8 *mt9v03x_frame_acquire(uint32 *frame_id, uint8 *fresh);
+
+//============================================================
+// 串口与编码器
+//============================================================
+
+#define DEBUG_UART_INDEX (0)
+
+void uart_write_buffer(uint32 uart_n, const uint8 *buff, uint32 len);
+
+extern int16 encoder[2]; // 编码器值（回放时为0，中线拟合按静止处理）
+
+//============================================================
+// 参与回放的用户模块
+//============================================================
+
+#include "auto_exposure.h"
+#include "centerline.h"
+#include "contour.h"
+#include "element.h"
+#include "frame_log.h"
+#include "Image Binarization.h"
+#include "image.h"
+#include "island.h"
+#include "ipm.h"
+#include "latency.h"
+
+#endif
@@ -0,0 +1,20 @@
+/*********************************************************************
+ * 文件: IfxStm.h（主机仿真）
+ * 系统定时器STM0的仿真替代，计数随仿真时间推进（10ns/计数）
+ ********************************************************************/
+
+#ifndef _IFXSTM_H
+#define _IFXSTM_H
+
+#include "zf_common_typedef.h"
+
+typedef struct
+{
+    uint32 reserved;
+} Ifx_STM;
+
+extern Ifx_STM MODULE_STM0;
+
+uint32 IfxStm_getLower(Ifx_STM *stm);
+
+#endif
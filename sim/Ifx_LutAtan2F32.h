@@ -0,0 +1,13 @@
+/*********************************************************************
+ * 文件: Ifx_LutAtan2F32.h（主机仿真）
+ * 英飞凌查表反正切的仿真替代，直接使用C库函数
+ ********************************************************************/
+
+#ifndef _IFX_LUTATAN2F32_H
+#define _IFX_LUTATAN2F32_H
+
+#include <math.h>
+
+#define Ifx_LutAtan2F32_float32(y, x) atan2f(y, x)
+
+#endif
@@ -0,0 +1,14 @@
+/*********************************************************************
+ * 文件: Ifx_LutLSincosF32.h（主机仿真）
+ * 英飞凌查表三角函数的仿真替代，直接使用C库函数
+ ********************************************************************/
+
+#ifndef _IFX_LUTLSINCOSF32_H
+#define _IFX_LUTLSINCOSF32_H
+
+#include <math.h>
+
+#define Ifx_LutLSincosF32_cos(x) cosf(x)
+#define Ifx_LutLSincosF32_sin(x) sinf(x)
+
+#endif
@@ -0,0 +1,211 @@
+/*********************************************************************
+ * 文件: sim_hal.c
+ * 主机仿真外设层实现文件
+ * 说明：接口与逐飞库一致，控制代码（motor.c、servo.c、imu.c等）不做任何修改即可链接
+ ********************************************************************/
+
+#if defined(CAR_SIM) // 仅在主机仿真构建中编译
+
+#include "sim_hal.h"
+#include "zf_common_headfile.h"
+#include "zf_device_imu660rb.h"
+#include "IfxStm.h"
+
+//============================================================
+// 宏定义
+//============================================================
+
+#define SIM_G 9.81f
+#define SIM_RAD_TO_DEG 57.2957795f
+
+//============================================================
+// 全局变量定义
+//============================================================
+
+Sim_Params sim_params;
+Sim_State sim_state;
+uint64 sim_time_ticks = 0;
+
+Ifx_STM MODULE_STM0;
+
+int16 imu660rb_acc_x, imu660rb_acc_y, imu660rb_acc_z;
+int16 imu660rb_gyro_x, imu660rb_gyro_y, imu660rb_gyro_z;
+float imu660rb_transition_factor[2] = {4098, 14.3};
+
+static uint32 pwm_duty[SIM_PWM_NUM];  // 各PWM通道占空比
+static uint8 wheel_dir = 1;           // 动量轮方向引脚电平
+static uint8 drive_dir = 1;           // 行进轮方向引脚电平
+static int32 wheel_count_base = 0;    // 动量轮编码器上次清零时的累计计数
+static int32 drive_count_base = 0;    // 行进轮编码器上次清零时的累计计数
+static uint32 noise_seed = 1;         // 噪声随机数状态
+
+//============================================================
+// 内部函数
+//============================================================
+
+/**
+ * @brief 均匀分布噪声（-amplitude~amplitude）
+ */
+static float sim_noise(float amplitude)
+{
+    noise_seed = noise_seed * 1664525u + 1013904223u;
+    return amplitude * ((float)(noise_seed >> 8) / (float)(1u << 24) * 2.0f - 1.0f);
+}
+
+/**
+ * @brief 浮点数转int16（四舍五入并饱和，模拟传感器量程）
+ */
+static int16 sim_to_int16(float value)
+{
+    if (value > 32767.0f)
+        return 32767;
+    if (value < -32768.0f)
+        return -32768;
+    return (int16)lroundf(value);
+}
+
+//============================================================
+// 仿真接口
+//============================================================
+
+/**
+ * @brief 复位外设状态
+ */
+void sim_hal_reset(uint32 seed)
+{
+    memset(pwm_duty, 0, sizeof(pwm_duty));
+    wheel_dir = 1;
+    drive_dir = 1;
+    wheel_count_base = 0;
+    drive_count_base = 0;
+    noise_seed = seed ? seed : 1;
+    sim_time_ticks = 0;
+}
+
+/**
+ * @brief 读取控制代码当前输出的执行器指令
+ */
+void sim_hal_get_input(Sim_Input *input)
+{
+    float wheel = (float)pwm_duty[ATOM0_CH5_P02_5] / PWM_DUTY_MAX;
+    float drive = (float)pwm_duty[ATOM0_CH7_P02_7] / PWM_DUTY_MAX;
+
+    input->wheel_duty = wheel_dir ? wheel : -wheel;
+    input->drive_duty = drive_dir ? drive : -drive;
+    // 舵机：高电平时间0.5ms~2.5ms对应0~180度（与servo.c中SERVO_MOTOR_DUTY互逆）
+    input->servo_deg = ((float)pwm_duty[ATOM1_CH1_P33_9] / ((float)PWM_DUTY_MAX / (1000.0f / SERVO_MOTOR_FREQ)) - 0.5f) * 90.0f;
+}
+
+//============================================================
+// 外设接口
+//============================================================
+
+void pwm_init(uint32 pin, uint32 freq, uint32 duty)
+{
+    (void)freq;
+    pwm_set_duty(pin, duty);
+}
+
+void pwm_set_duty(uint32 pin, uint32 duty)
+{
+    if (pin < SIM_PWM_NUM)
+        pwm_duty[pin] = duty;
+}
+
+void gpio_init(uint32 pin, gpio_dir_enum dir, uint8 dat, gpio_mode_enum mode)
+{
+    (void)dir;
+    (void)mode;
+    gpio_set_level(pin, dat);
+}
+
+void gpio_set_level(uint32 pin, uint8 dat)
+{
+    if (pin == MOMENTUM_WHEEL_DIR)
+        wheel_dir = dat;
+    else if (pin == DRIVE_WHEEL_DIR)
+        drive_dir = dat;
+}
+
+void gpio_toggle_level(uint32 pin)
+{
+    (void)pin;
+}
+
+void encoder_dir_init(uint32 encoder_n, uint32 count_pin, uint32 dir_pin)
+{
+    (void)count_pin;
+    (void)dir_pin;
+    encoder_clear_count(encoder_n);
+}
+
+int16 encoder_get_count(uint32 encoder_n)
+{
+    if (encoder_n == MOMENTUM_WHEEL_ENCODER_TIM)
+        return (int16)((int32)floor(sim_state.wheel_count) - wheel_count_base);
+    return (int16)((int32)floor(sim_state.drive_count) - drive_count_base);
+}
+
+void encoder_clear_count(uint32 encoder_n)
+{
+    // 计数器清零时未走完的一个计数周期保留在模型的累计值中
+    if (encoder_n == MOMENTUM_WHEEL_ENCODER_TIM)
+        wheel_count_base = (int32)floor(sim_state.wheel_count);
+    else
+        drive_count_base = (int32)floor(sim_state.drive_count);
+}
+
+void system_delay_ms(uint32 time)
+{
+    (void)time;
+}
+
+uint32 IfxStm_getLower(Ifx_STM *stm)
+{
+    (void)stm;
+    return (uint32)sim_time_ticks;
+}
+
+//============================================================
+// IMU660RB
+//============================================================
+
+uint8 imu660rb_init(void)
+{
+    return 0;
+}
+
+void imu660rb_get_acc(void)
+{
+    // 比力 = 加速度 - 重力，投影到车体坐标系（X为倾倒方向，Y为前进方向）
+    float s = sinf(sim_state.lean), c = cosf(sim_state.lean);
+    float scale = imu660rb_transition_factor[0] / SIM_G;
+
+    imu660rb_acc_x = sim_to_int16((SIM_G * s + sim_state.lateral_acc * c) * scale + sim_noise(sim_params.acc_noise));
+    imu660rb_acc_y = sim_to_int16(sim_state.accel * scale + sim_noise(sim_params.acc_noise));
+    imu660rb_acc_z = sim_to_int16((SIM_G * c - sim_state.lateral_acc * s) * scale + sim_noise(sim_params.acc_noise));
+}
+
+void imu660rb_get_gyro(void)
+{
+    float scale = imu660rb_transition_factor[1] * SIM_RAD_TO_DEG;
+
+    imu660rb_gyro_x = sim_to_int16(sim_noise(sim_params.gyro_noise));
+    imu660rb_gyro_y = sim_to_int16(-sim_state.lean_rate * scale + sim_params.gyro_bias + sim_noise(sim_params.gyro_noise));
+    // IMU正面朝上安装，绕Z轴逆时针（左转）为正：舵机大于中点时左转（图像偏差为正表示赛道在左侧），偏航角速度为正
+    imu660rb_gyro_z = sim_to_int16(sim_state.yaw_rate * scale + sim_noise(sim_params.gyro_noise));
+}
+
+//============================================================
+// 元素检测统计（仿真不含图像处理，profiler.c输出和清零统计时调用）
+//============================================================
+
+void element_stats_reset(void)
+{
+}
+
+void element_stats_dump(void)
+{
+}
+
+#endif
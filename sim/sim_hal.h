@@ -0,0 +1,38 @@
+/*********************************************************************
+ * 文件: sim_hal.h
+ * 主机仿真外设层头文件
+ * 说明：PWM、方向引脚、编码器、IMU660RB和STM定时器的仿真实现，
+ *       控制代码写入的占空比转换为模型输入，模型状态转换为传感器原始值
+ ********************************************************************/
+
+#ifndef _SIM_HAL_H
+#define _SIM_HAL_H
+
+#include "zf_common_typedef.h"
+#include "sim_plant.h"
+
+//============================================================
+// 全局变量声明
+//============================================================
+
+extern Sim_Params sim_params; // 模型参数
+extern Sim_State sim_state;   // 模型状态
+extern uint64 sim_time_ticks; // 仿真时间（STM计数，10ns）
+
+//============================================================
+// 函数声明
+//============================================================
+
+/**
+ * @brief 复位外设状态（占空比、方向、编码器计数、噪声种子）
+ * @param seed 传感器噪声随机种子
+ */
+void sim_hal_reset(uint32 seed);
+
+/**
+ * @brief 读取控制代码当前输出的执行器指令
+ * @param input 输出：模型输入
+ */
+void sim_hal_get_input(Sim_Input *input);
+
+#endif
@@ -0,0 +1,134 @@
+/*********************************************************************
+ * 文件: sim_main.c
+ * 动量轮自行车闭环仿真主程序（单次仿真）
+ * 说明：链接未经修改的控制代码（pid.c、motor.c、turn_compensation.c、imu.c及EKF等），
+ *       外设接口由sim_hal.c实现，被控对象见sim_plant.c，场景与评价指标见sim_run.c；
+ *       仿真时间与实际时间无关，通常比实时快数百倍
+ *
+ * 构建（在仓库根目录执行）：
+ *   SIM_SRC="sim/sim_hal.c sim/sim_plant.c sim/sim_run.c code/pid.c code/pid_q.c code/motor.c \
+ *       code/turn_compensation.c code/imu.c code/servo.c code/buzzer.c code/delayed_stop.c \
+ *       code/scheduler.c code/profiler.c code/EKF/Attitude.c code/EKF/QuaternionEKF.c \
+ *       code/EKF/kalman_filter.c code/EKF/matrix.c"
+ *   gcc -O2 -std=gnu99 -DCAR_SIM -Isim -Icode -o car_sim sim/sim_main.c $SIM_SRC -lm
+ *
+ * 用法：
+ *   ./car_sim [选项]
+ *     --scenario balance|drive|turn|track  场景：原地平衡 / 直行 / 开环转弯 / 沿赛道闭环行驶（默认turn）
+ *     --time 秒                       释放后的仿真时长（默认8）
+ *     --hold 秒                       释放前扶住车体的时长，姿态解算在此期间收敛（默认2）
+ *     --lean 度                       扶住时的倾角（默认0），EKF的观测噪声很大，此偏差相当于机械中值误差
+ *     --kick 度每秒                   释放时车体的初始倾角速度（默认5，模拟释放时的扰动）
+ *     --turn-error 值                 turn场景中的图像偏差（默认20）
+ *     --seed 值                       传感器噪声种子
+ *     --set 名称=值                   修改参数（可重复，名称见--list）
+ *     --params 文件                   从文件读取参数，每行一个 名称=值，#开头为注释
+ *     --csv 文件                      输出逐毫秒曲线（--csv-every指定间隔毫秒数）
+ *     --list                          列出可修改的参数
+ *   释放后未倒车且未触发保护时返回0，否则返回1，可直接用于调参回归
+ ********************************************************************/
+
+#if defined(CAR_SIM) // 仅在主机仿真构建中编译
+
+#include "zf_common_headfile.h"
+#include "sim_hal.h"
+#include "sim_run.h"
+
+int main(int argc, char **argv)
+{
+    Sim_Config config;
+    Sim_Result result;
+    uint32 i;
+
+    sim_params = sim_default_params;
+    sim_config_default(&config);
+
+    // 1. 命令行
+    for (i = 1; i < (uint32)argc; i++)
+    {
+        const char *arg = argv[i];
+        const char *val = (i + 1 < (uint32)argc) ? argv[i + 1] : NULL;
+
+        if (strcmp(arg, "--list") == 0)
+        {
+            for (i = 0; i < sim_param_num; i++)
+                printf("%s\n", sim_param_table[i].name);
+            return 0;
+        }
+        if (val == NULL)
+        {
+            fprintf(stderr, "missing value for %s\n", arg);
+            return 2;
+        }
+        if (strcmp(arg, "--scenario") == 0)
+        {
+            config.scenario = sim_scenario_from_name(val);
+            if (config.scenario == SIM_SCENARIO_NUM)
+            {
+                fprintf(stderr, "unknown scenario: %s\n", val);
+                return 2;
+            }
+        }
+        else if (strcmp(arg, "--time") == 0)
+            config.run_s = strtof(val, NULL);
+        else if (strcmp(arg, "--hold") == 0)
+            config.hold_s = strtof(val, NULL);
+        else if (strcmp(arg, "--lean") == 0)
+            config.lean_deg = strtof(val, NULL);
+        else if (strcmp(arg, "--kick") == 0)
+            config.kick_dps = strtof(val, NULL);
+        else if (strcmp(arg, "--turn-error") == 0)
+            config.turn_error = strtof(val, NULL);
+        else if (strcmp(arg, "--seed") == 0)
+            config.seed = (uint32)strtoul(val, NULL, 0);
+        else if (strcmp(arg, "--csv") == 0)
+            config.csv_path = val;
+        else if (strcmp(arg, "--csv-every") == 0)
+            config.csv_every = (uint32)strtoul(val, NULL, 0);
+        else if (strcmp(arg, "--set") == 0)
+        {
+            if (!sim_set_param(val))
+            {
+                fprintf(stderr, "unknown parameter: %s (see --list)\n", val);
+                return 2;
+            }
+        }
+        else if (strcmp(arg, "--params") == 0)
+        {
+            if (!sim_load_params(val))
+            {
+                fprintf(stderr, "cannot load parameters from %s\n", val);
+                return 2;
+            }
+        }
+        else
+        {
+            fprintf(stderr, "unknown option: %s\n", arg);
+            return 2;
+        }
+        i++;
+    }
+
+    // 2. 仿真
+    sim_run(&config, &result);
+
+    // 3. 结果
+    printf("scenario      %s\n", sim_scenario_name(config.scenario));
+    printf("result        %s\n", result.fell ? "FELL" : "OK");
+    printf("sim_time_s    %.3f\n", result.sim_time_s);
+    printf("lean_max_deg  %.3f\n", result.lean_max);
+    printf("lean_rms_deg  %.3f\n", result.lean_rms);
+    printf("settle_s      %.3f\n", result.settle_time_s);
+    printf("overshoot_deg %.3f\n", result.overshoot_deg);
+    printf("speed_err_rms %.2f\n", result.speed_err_rms);
+    printf("path_err_rms  %.4f m\n", result.path_err_rms);
+    printf("speed_mean    %.3f m/s\n", result.speed_mean);
+    printf("heading_deg   %.1f\n", result.heading_deg);
+    printf("wheel_rpm     %.0f\n", result.wheel_rpm);
+    printf("wall_time_s   %.3f (%.0fx real time)\n", result.wall_s,
+           result.wall_s > 0 ? (config.hold_s + result.sim_time_s) / result.wall_s : 0.0);
+
+    return result.fell ? 1 : 0;
+}
+
+#endif
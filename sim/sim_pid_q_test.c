@@ -0,0 +1,348 @@
+/*********************************************************************
+ * 文件: sim_pid_q_test.c
+ * 浮点PID与Q16.16定点PID的对比测试
+ * 说明：1. 开环：四个控制环各用一组参数，把相同的输入序列（阶跃+噪声，覆盖各环的实际输入范围，
+ *          角速度环的陀螺仪取满量程±28600）分别送入浮点和定点模式的pid_calculate()，统计输出最大偏差；
+ *          另一个控制器每隔一段时间切换一次计算模式，检查切换时积分和上次误差的同步（输出不跳变）
+ *       2. 耗时：浮点、定点（浮点输入）、定点（整数输入，pid_calculate_int）每次调用的平均耗时（主机上，多轮取最小值）
+ *       3. 闭环：在子进程中分别以全浮点、全定点运行balance/drive场景，比较逐毫秒的倾角和动量轮占空比
+ *       开环偏差超出输出限幅的1e-4、切换时输出跳变或定点闭环倒车时返回1
+ *
+ * 构建与运行（在仓库根目录执行，SIM_SRC见sim_main.c）：
+ *   gcc -O2 -std=gnu99 -DCAR_SIM -Isim -Icode -o pid_q_test sim/sim_pid_q_test.c $SIM_SRC -lm
+ *   ./pid_q_test
+ ********************************************************************/
+
+#if defined(CAR_SIM) // 仅在主机仿真构建中编译
+
+#include "zf_common_headfile.h"
+#include "sim_hal.h"
+#include "sim_run.h"
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+//============================================================
+// 宏定义
+//============================================================
+
+#define TEST_SAMPLES 200000         // 开环序列长度
+#define TEST_TOGGLE_PERIOD 997      // 切换计算模式的间隔（取质数，避免与阶跃周期对齐）
+#define TEST_TIMING_CALLS 1000000   // 耗时测量每轮的调用次数
+#define TEST_TIMING_REPEAT 7        // 耗时测量轮数（取最小值，减小主机调度的影响）
+#define TEST_MAX_ERR_RATIO 1e-4f    // 允许的开环输出偏差（相对输出限幅）
+#define TEST_CSV_MAX_ROWS 20000     // 闭环曲线最大行数
+
+//============================================================
+// 开环测试用例
+//============================================================
+
+typedef struct
+{
+    const char *name;
+    float kp, ki, kd, max_integral, max_output;
+    float target_amp;  // 目标值阶跃幅度
+    float current_amp; // 反馈值幅度
+    float noise_amp;   // 反馈噪声幅度
+    uint8 integer;     // 1=输入为整数（角速度环、编码器）
+} Test_Case;
+
+// 参数取pid.c默认值和sim/example.params
+static const Test_Case test_cases[] = {
+    {"gyro", -7.0f, -15.4f, 0.0f, 100.0f, 8000.0f, 3000.0f, 28600.0f, 200.0f, 1},
+    {"angle", -0.4f, 0.0f, -0.0f, 20.0f, 3000.0f, 10.0f, 30.0f, 0.5f, 0},
+    {"speed", -0.3f, 0.0f, -0.5f, 100.0f, 1000.0f, 50.0f, 200.0f, 5.0f, 1},
+    {"drive", -50.0f, -20.0f, 0.0f, 100.0f, 10000.0f, 100.0f, 300.0f, 5.0f, 1},
+};
+
+static uint32 rng_state = 12345;
+
+static float rand_unit(void) // [-1, 1)
+{
+    rng_state = rng_state * 1664525u + 1013904223u;
+    return (float)(rng_state >> 8) * (2.0f / 16777216.0f) - 1.0f;
+}
+
+static void pid_setup(PID_Controller *pid, const Test_Case *tc, uint32 fixed_point)
+{
+    memset(pid, 0, sizeof(*pid));
+    pid->kp = tc->kp;
+    pid->ki = tc->ki;
+    pid->kd = tc->kd;
+    pid->max_integral = tc->max_integral;
+    pid->max_output = tc->max_output;
+    pid->fixed_point = fixed_point;
+    pid->fixed_point_active = fixed_point;
+}
+
+// 生成第n个输入：目标值每500个采样阶跃一次，反馈值为慢变正弦加噪声
+static void test_input(const Test_Case *tc, uint32 n, float *target, float *current)
+{
+    if (n % 500 == 0)
+        *target = tc->target_amp * rand_unit();
+    *current = tc->current_amp * sinf((float)n * 0.0021f) + tc->noise_amp * rand_unit();
+    if (tc->integer)
+    {
+        *target = (float)(int32)*target;
+        *current = (float)(int32)*current;
+    }
+}
+
+static float pid_call(PID_Controller *pid, const Test_Case *tc, float target, float current)
+{
+    if (tc->integer)
+        return pid_calculate_int(pid, (int32)target, (int32)current);
+    return pid_calculate(pid, target, current);
+}
+
+static uint32 open_loop_test(void)
+{
+    uint32 c, n, failures = 0;
+
+    printf("open loop (%u samples per loop):\n", TEST_SAMPLES);
+    printf("  %-6s %10s %12s %12s %12s\n", "loop", "max |out|", "fixed diff", "toggle diff", "limit");
+    for (c = 0; c < sizeof(test_cases) / sizeof(test_cases[0]); c++)
+    {
+        const Test_Case *tc = &test_cases[c];
+        PID_Controller ref, fixed, toggle;
+        float target = 0.0f, current = 0.0f;
+        float max_out = 0.0f, max_diff = 0.0f, max_toggle_diff = 0.0f;
+        float limit = TEST_MAX_ERR_RATIO * tc->max_output;
+
+        pid_setup(&ref, tc, 0);
+        pid_setup(&fixed, tc, 1);
+        pid_setup(&toggle, tc, 0);
+        rng_state = 12345 + c;
+
+        for (n = 0; n < TEST_SAMPLES; n++)
+        {
+            float out_ref, out_fixed, out_toggle;
+
+            test_input(tc, n, &target, &current);
+            if (n % TEST_TOGGLE_PERIOD == TEST_TOGGLE_PERIOD - 1)
+                toggle.fixed_point = !toggle.fixed_point;
+
+            out_ref = pid_calculate(&ref, target, current);
+            out_fixed = pid_call(&fixed, tc, target, current);
+            out_toggle = pid_call(&toggle, tc, target, current);
+
+            if (fabsf(out_ref) > max_out)
+                max_out = fabsf(out_ref);
+            if (fabsf(out_fixed - out_ref) > max_diff)
+                max_diff = fabsf(out_fixed - out_ref);
+            if (fabsf(out_toggle - out_ref) > max_toggle_diff)
+                max_toggle_diff = fabsf(out_toggle - out_ref);
+        }
+
+        printf("  %-6s %10.1f %12.6f %12.6f %12.6f\n", tc->name, max_out, max_diff, max_toggle_diff, limit);
+        if (max_diff > limit || max_toggle_diff > limit)
+        {
+            printf("FAIL %s: fixed-point output diverges from float\n", tc->name);
+            failures++;
+        }
+    }
+    return failures;
+}
+
+//============================================================
+// 耗时
+//============================================================
+
+static double now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+static void timing_test(void)
+{
+    static int32 inputs[1024];
+    const Test_Case *tc = &test_cases[0];
+    PID_Controller pid;
+    volatile float sink = 0.0f;
+    double t0, t, ns[3];
+    uint32 mode, n, r;
+
+    rng_state = 777;
+    for (n = 0; n < 1024; n++)
+        inputs[n] = (int32)(tc->current_amp * rand_unit());
+
+    for (mode = 0; mode < 3; mode++)
+        ns[mode] = 1e9;
+    for (r = 0; r < TEST_TIMING_REPEAT; r++)
+    {
+        for (mode = 0; mode < 3; mode++)
+        {
+            pid_setup(&pid, tc, mode != 0);
+            t0 = now_ns();
+            for (n = 0; n < TEST_TIMING_CALLS; n++)
+            {
+                int32 target = inputs[n & 1023] >> 3;
+                int32 current = inputs[(n + 511) & 1023];
+
+                if (mode == 2)
+                    sink += pid_calculate_int(&pid, target, current);
+                else
+                    sink += pid_calculate(&pid, (float)target, (float)current);
+            }
+            t = (now_ns() - t0) / TEST_TIMING_CALLS;
+            if (t < ns[mode])
+                ns[mode] = t;
+        }
+    }
+    (void)sink;
+
+    printf("cost per call on this host (gyro loop gains):\n");
+    printf("  float pid_calculate          %6.2f ns\n", ns[0]);
+    printf("  fixed pid_calculate (float)  %6.2f ns\n", ns[1]);
+    printf("  fixed pid_calculate_int      %6.2f ns\n", ns[2]);
+}
+
+//============================================================
+// 闭环
+//============================================================
+
+typedef struct
+{
+    float lean;
+    float duty;
+} Csv_Row;
+
+// 在子进程中运行一次仿真，曲线写入csv_path，返回是否倒车（-1=子进程失败）
+static int run_child(Sim_Scenario scenario, uint32 fixed_point, const char *csv_path)
+{
+    pid_t pid;
+    int status;
+
+    fflush(stdout);
+    pid = fork();
+    if (pid < 0)
+        return -1;
+    if (pid == 0)
+    {
+        Sim_Config config;
+        Sim_Result result;
+
+        sim_config_default(&config);
+        config.scenario = scenario;
+        config.csv_path = csv_path;
+        config.csv_every = 1;
+        gyro_pid.fixed_point = fixed_point;
+        angle_pid.fixed_point = fixed_point;
+        speed_pid.fixed_point = fixed_point;
+        drive_speed_pid.fixed_point = fixed_point;
+        sim_run(&config, &result);
+        _exit(result.fell ? 2 : 0);
+    }
+    if (waitpid(pid, &status, 0) != pid || !WIFEXITED(status))
+        return -1;
+    if (WEXITSTATUS(status) == 1)
+        return -1;
+    return WEXITSTATUS(status) == 2;
+}
+
+static uint32 read_csv(const char *path, Csv_Row *rows)
+{
+    FILE *fp = fopen(path, "r");
+    char line[512];
+    uint32 n = 0;
+
+    if (fp == NULL)
+        return 0;
+    if (fgets(line, sizeof(line), fp) == NULL) // 表头
+    {
+        fclose(fp);
+        return 0;
+    }
+    while (n < TEST_CSV_MAX_ROWS && fgets(line, sizeof(line), fp) != NULL)
+    {
+        unsigned long t;
+        float pitch;
+        int gyro;
+
+        if (sscanf(line, "%lu,%f,%f,%d,%f", &t, &rows[n].lean, &pitch, &gyro, &rows[n].duty) == 5)
+            n++;
+    }
+    fclose(fp);
+    return n;
+}
+
+static uint32 closed_loop_test(void)
+{
+    static const Sim_Scenario scenarios[] = {SIM_BALANCE, SIM_DRIVE};
+    static Csv_Row rows_float[TEST_CSV_MAX_ROWS], rows_fixed[TEST_CSV_MAX_ROWS];
+    char path_float[] = "/tmp/pid_q_float_XXXXXX";
+    char path_fixed[] = "/tmp/pid_q_fixed_XXXXXX";
+    uint32 s, n, failures = 0;
+    int fd;
+
+    if ((fd = mkstemp(path_float)) < 0)
+        return 1;
+    close(fd);
+    if ((fd = mkstemp(path_fixed)) < 0)
+        return 1;
+    close(fd);
+
+    printf("closed loop (all four loops float vs fixed, sim/example.params):\n");
+    printf("  %-8s %6s %6s %14s %16s\n", "scenario", "float", "fixed", "max lean diff", "max duty diff");
+    for (s = 0; s < sizeof(scenarios) / sizeof(scenarios[0]); s++)
+    {
+        int fell_float = run_child(scenarios[s], 0, path_float);
+        int fell_fixed = run_child(scenarios[s], 1, path_fixed);
+        uint32 rows = 0, rows_b;
+        float max_lean = 0.0f, max_duty = 0.0f;
+
+        if (fell_float < 0 || fell_fixed < 0)
+        {
+            printf("FAIL %s: simulation did not run\n", sim_scenario_name(scenarios[s]));
+            failures++;
+            continue;
+        }
+        rows = read_csv(path_float, rows_float);
+        rows_b = read_csv(path_fixed, rows_fixed);
+        if (rows_b < rows)
+            rows = rows_b;
+        for (n = 0; n < rows; n++)
+        {
+            if (fabsf(rows_fixed[n].lean - rows_float[n].lean) > max_lean)
+                max_lean = fabsf(rows_fixed[n].lean - rows_float[n].lean);
+            if (fabsf(rows_fixed[n].duty - rows_float[n].duty) > max_duty)
+                max_duty = fabsf(rows_fixed[n].duty - rows_float[n].duty);
+        }
+
+        printf("  %-8s %6s %6s %11.4f deg %16.4f\n", sim_scenario_name(scenarios[s]),
+               fell_float ? "fell" : "ok", fell_fixed ? "fell" : "ok", max_lean, max_duty);
+        if (fell_fixed && !fell_float)
+        {
+            printf("FAIL %s: falls only in fixed-point mode\n", sim_scenario_name(scenarios[s]));
+            failures++;
+        }
+    }
+
+    remove(path_float);
+    remove(path_fixed);
+    return failures;
+}
+
+int main(void)
+{
+    uint32 failures = 0;
+
+    sim_params = sim_default_params;
+    if (!sim_load_params("sim/example.params"))
+    {
+        printf("cannot load sim/example.params (run from the repository root)\n");
+        return 1;
+    }
+
+    failures += open_loop_test();
+    timing_test();
+    failures += closed_loop_test();
+
+    printf("%s\n", failures ? "FAILED" : "PASSED");
+    return failures ? 1 : 0;
+}
+
+#endif
@@ -0,0 +1,118 @@
+/*********************************************************************
+ * 文件: sim_plant.c
+ * 动量轮自行车模型（主机仿真用被控对象）实现文件
+ * 说明：倾倒方程 I·φ'' = m·h·(g·sinφ + a_lat·cosφ) + τ_wheel，
+ *       a_lat为转弯产生的侧向加速度（自行车运动学：偏航角速度 = v·tanδ / L）
+ ********************************************************************/
+
+#if defined(CAR_SIM) // 仅在主机仿真构建中编译
+
+#include "sim_plant.h"
+
+//============================================================
+// 宏定义
+//============================================================
+
+#define SIM_G 9.81f
+#define SIM_PI 3.14159265f
+#define SIM_DEG_TO_RAD (SIM_PI / 180.0f)
+
+//============================================================
+// 全局变量定义
+//============================================================
+
+const Sim_Params sim_default_params = {
+    .mass = 1.0f,
+    .com_height = 0.08f,
+    .body_inertia = 0.0085f,
+
+    .wheel_inertia = 2.0e-4f,
+    .wheel_damping = 2.0e-6f,
+    .wheel_kt = 0.02f,
+    .wheel_resistance = 2.0f,
+    .wheel_cpr = 1024.0f,
+
+    .drive_kt = 0.01f,
+    .drive_resistance = 2.0f,
+    .drive_gear = 10.0f,
+    .drive_radius = 0.032f,
+    .drive_drag = 0.5f,
+    .drive_cpr = 1024.0f,
+
+    .wheelbase = 0.20f,
+    .steer_ratio = 0.5f,
+    .servo_tau = 0.04f,
+    .servo_center = 90.0f,
+
+    .battery_voltage = 12.0f,
+    .gyro_noise = 6.0f,
+    .acc_noise = 20.0f,
+    .gyro_bias = 0.0f,
+};
+
+//============================================================
+// 函数实现
+//============================================================
+
+/**
+ * @brief 初始化模型状态
+ */
+void sim_plant_init(Sim_State *state, const Sim_Params *params, float lean_deg)
+{
+    memset(state, 0, sizeof(*state));
+    state->lean = lean_deg * SIM_DEG_TO_RAD;
+    state->servo_deg = params->servo_center;
+}
+
+/**
+ * @brief 模型积分一步
+ */
+void sim_plant_step(Sim_State *state, const Sim_Params *params, const Sim_Input *input, float dt)
+{
+    float voltage, current, wheel_torque, drive_torque, force;
+    float steer, lean_acc;
+
+    // 1. 舵机（一阶惯性）与转向运动学
+    state->servo_deg += (input->servo_deg - state->servo_deg) * dt / params->servo_tau;
+    steer = (state->servo_deg - params->servo_center) * params->steer_ratio * SIM_DEG_TO_RAD;
+    state->yaw_rate = state->speed * tanf(steer) / params->wheelbase;
+    state->lateral_acc = -state->speed * state->yaw_rate;
+
+    // 2. 动量轮电机：车体受到与动量轮加速方向相反的反作用力矩
+    voltage = input->wheel_duty * params->battery_voltage;
+    current = (voltage - params->wheel_kt * state->wheel_speed) / params->wheel_resistance;
+    wheel_torque = params->wheel_kt * current;
+    state->wheel_speed += (wheel_torque - params->wheel_damping * state->wheel_speed) / params->wheel_inertia * dt;
+
+    // 3. 车体倾倒（车体力矩取动量轮电机力矩，符号见sim_plant.h）
+    lean_acc = (params->mass * params->com_height * (SIM_G * sinf(state->lean) + state->lateral_acc * cosf(state->lean)) +
+                wheel_torque) / params->body_inertia;
+    state->lean_rate += lean_acc * dt;
+    state->lean += state->lean_rate * dt;
+
+    // 倒地后停在±90度
+    if (state->lean > SIM_PI / 2 || state->lean < -SIM_PI / 2)
+    {
+        state->lean = state->lean > 0 ? SIM_PI / 2 : -SIM_PI / 2;
+        state->lean_rate = 0.0f;
+    }
+
+    // 4. 行进轮电机（占空比为负时前进）
+    voltage = -input->drive_duty * params->battery_voltage;
+    current = (voltage - params->drive_kt * params->drive_gear * state->speed / params->drive_radius) / params->drive_resistance;
+    drive_torque = params->drive_kt * current * params->drive_gear;
+    force = drive_torque / params->drive_radius - params->drive_drag * state->speed;
+    state->accel = force / params->mass;
+    state->speed += state->accel * dt;
+
+    // 5. 位置与航向
+    state->heading += state->yaw_rate * dt;
+    state->x += state->speed * cosf(state->heading) * dt;
+    state->y += state->speed * sinf(state->heading) * dt;
+
+    // 6. 编码器累计
+    state->wheel_count += state->wheel_speed * dt / (2.0f * SIM_PI) * params->wheel_cpr;
+    state->drive_count += state->speed / params->drive_radius * dt / (2.0f * SIM_PI) * params->drive_cpr;
+}
+
+#endif
@@ -0,0 +1,114 @@
+/*********************************************************************
+ * 文件: sim_plant.h
+ * 动量轮自行车模型（主机仿真用被控对象）头文件
+ * 说明：车体绕纵轴倾倒的倒立摆 + 动量轮反作用力矩 + 后轮驱动 + 前轮转向（自行车运动学），
+ *       两个电机为直流电机模型（电压 = 占空比 × 电池电压，反电动势与转速成正比），
+ *       编码器累计转角对应的计数；姿态角与固件一致：倾角为imu_data.pitch（度，不含机械中值）
+ *
+ *       符号约定（与固件中PID参数的符号一致）：
+ *       - 动量轮占空比为正时车体受正向力矩（倾角增大）
+ *       - 陀螺仪Y轴读数 = -倾角速度（imu_data.pitch = -EKF俯仰角）
+ *       - 行进轮占空比为负时前进，编码器前进为正
+ *       - 舵机角度大于中点时向正方向转弯，转弯时的平衡倾角为正，与转弯补偿的符号一致
+ *       - 陀螺仪Z轴读数 = 偏航角速度（IMU正面朝上，左转为正，与实车安装一致）；
+ *         steer_output = Kp*图像偏差 + Kd*gz，Kd为正时加强偏航，需要阻尼时Kd取负值
+ ********************************************************************/
+
+#ifndef _SIM_PLANT_H
+#define _SIM_PLANT_H
+
+#include "zf_common_typedef.h"
+
+//============================================================
+// 类型定义
+//============================================================
+
+// 模型参数（国际单位制）
+typedef struct
+{
+    // 车体
+    float mass;          // 整车质量（kg）
+    float com_height;    // 质心高度（m）
+    float body_inertia;  // 绕车轮接地线的转动惯量（kg·m²）
+
+    // 动量轮与电机
+    float wheel_inertia;   // 动量轮转动惯量（kg·m²）
+    float wheel_damping;   // 动量轮轴承阻尼（N·m·s/rad）
+    float wheel_kt;        // 动量轮电机力矩常数（N·m/A，同时为反电动势常数）
+    float wheel_resistance;// 动量轮电机电阻（Ω）
+    float wheel_cpr;       // 动量轮编码器每转计数
+
+    // 行进轮与电机
+    float drive_kt;          // 行进轮电机力矩常数（N·m/A）
+    float drive_resistance;  // 行进轮电机电阻（Ω）
+    float drive_gear;        // 减速比（电机转速/车轮转速）
+    float drive_radius;      // 车轮半径（m）
+    float drive_drag;        // 线性阻力系数（N·s/m）
+    float drive_cpr;         // 行进轮编码器每转计数（车轮一转）
+
+    // 转向
+    float wheelbase;   // 轴距（m）
+    float steer_ratio; // 前轮转角/舵机角度偏差
+    float servo_tau;   // 舵机一阶响应时间常数（s）
+    float servo_center;// 舵机中点角度（度）
+
+    // 电源与传感器
+    float battery_voltage; // 电池电压（V）
+    float gyro_noise;      // 陀螺仪噪声（原始值，均匀分布幅值）
+    float acc_noise;       // 加速度计噪声（原始值，均匀分布幅值）
+    float gyro_bias;       // 陀螺仪Y轴零偏（原始值）
+} Sim_Params;
+
+// 执行器输入
+typedef struct
+{
+    float wheel_duty; // 动量轮占空比（-1~1）
+    float drive_duty; // 行进轮占空比（-1~1）
+    float servo_deg;  // 舵机指令角度（度）
+} Sim_Input;
+
+// 模型状态
+typedef struct
+{
+    float lean;        // 倾角（rad）
+    float lean_rate;   // 倾角速度（rad/s）
+    float wheel_speed; // 动量轮相对车体转速（rad/s）
+    float speed;       // 前进速度（m/s）
+    float accel;       // 前进加速度（m/s²）
+    float servo_deg;   // 舵机实际角度（度）
+    float yaw_rate;    // 偏航角速度（rad/s）
+    float heading;     // 航向（rad）
+    float x, y;        // 位置（m）
+    float lateral_acc; // 侧向加速度（m/s²，与倾角同号时使车体回正）
+    double wheel_count; // 动量轮编码器累计计数
+    double drive_count; // 行进轮编码器累计计数
+} Sim_State;
+
+//============================================================
+// 全局变量声明
+//============================================================
+
+extern const Sim_Params sim_default_params; // 默认模型参数（约1kg的动量轮自行车）
+
+//============================================================
+// 函数声明
+//============================================================
+
+/**
+ * @brief 初始化模型状态
+ * @param state 状态
+ * @param params 参数
+ * @param lean_deg 初始倾角（度）
+ */
+void sim_plant_init(Sim_State *state, const Sim_Params *params, float lean_deg);
+
+/**
+ * @brief 模型积分一步（半隐式欧拉）
+ * @param state 状态
+ * @param params 参数
+ * @param input 执行器输入（步内保持不变）
+ * @param dt 步长（s），建议不大于0.1ms
+ */
+void sim_plant_step(Sim_State *state, const Sim_Params *params, const Sim_Input *input, float dt);
+
+#endif
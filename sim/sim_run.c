@@ -0,0 +1,451 @@
+/*********************************************************************
+ * 文件: sim_run.c
+ * 主机仿真单次运行实现文件
+ * 说明：每1ms调用一次control()（与CCU60_CH0中断相同），每SIM_CAMERA_PERIOD_MS调用一次
+ *       steer_pid_control()（与主循环收到视觉结果相同），模型以0.1ms步长积分；
+ *       track场景的赛道为 直线 → 左转圆弧 → 直线，图像偏差按车前方预瞄点相对赛道中线的横向偏差计算
+ ********************************************************************/
+
+#if defined(CAR_SIM) // 仅在主机仿真构建中编译
+
+#include "sim_run.h"
+#include "sim_hal.h"
+#include "zf_common_headfile.h"
+#include <time.h>
+
+//============================================================
+// 宏定义
+//============================================================
+
+#define SIM_SUBSTEPS 10          // 每个1ms控制周期内的模型积分步数
+#define SIM_TICKS_PER_MS 100000  // STM每毫秒计数
+#define SIM_CAMERA_PERIOD_MS 10  // 视觉结果周期（转向控制周期）
+#define SIM_FALL_DEG 45.0f       // 倾角超过此值视为倒车
+#define SIM_PI 3.14159265f
+#define SIM_RAD_TO_DEG 57.2957795f
+
+// turn场景
+#define SIM_TURN_START_S 2.0f  // 释放后开始转弯的时刻
+#define SIM_TURN_LENGTH_S 3.0f // 转弯持续时间
+
+// track场景
+#define SIM_TRACK_STRAIGHT_M 1.0f       // 起点直道长度（m）
+#define SIM_TRACK_RADIUS_M 1.0f         // 弯道半径（m）
+#define SIM_TRACK_ARC_RAD (SIM_PI / 2)  // 弯道转角（rad）
+#define SIM_CAMERA_PREVIEW_M 0.3f       // 摄像头预瞄距离（m）
+#define SIM_CAMERA_PX_PER_M 100.0f      // 预瞄处横向偏差与图像偏差的比例（像素/m）
+
+//============================================================
+// 参数表
+//============================================================
+
+#define SIM_PID_ENTRIES(prefix, page, pid)                                      \
+    {prefix ".kp", page ".Kp", &pid.kp, NULL},                                  \
+    {prefix ".ki", page ".Ki", &pid.ki, NULL},                                  \
+    {prefix ".kd", page ".Kd", &pid.kd, NULL},                                  \
+    {prefix ".max_integral", page ".Max Integral", &pid.max_integral, NULL},    \
+    {prefix ".max_output", page ".Max Output", &pid.max_output, NULL},          \
+    {prefix ".fixed_point", page ".Fixed Point", NULL, &pid.fixed_point}
+
+const Sim_Param_Entry sim_param_table[] = {
+    // 控制参数（菜单键与menu_config.c中的页面名、参数名一致）
+    SIM_PID_ENTRIES("gyro", "Gyro PID", gyro_pid),
+    SIM_PID_ENTRIES("angle", "Angle PID", angle_pid),
+    SIM_PID_ENTRIES("speed", "Speed PID", speed_pid),
+    SIM_PID_ENTRIES("drive", "Drive Speed PID", drive_speed_pid),
+    {"drive.enable", "Drive Speed PID.Enable(0/1)", NULL, &drive_speed_enable},
+    {"drive.open_loop", "Drive Speed PID.Open Loop Out", &drive_open_loop_output, NULL},
+    {"target_drive_speed", "Drive Speed PID.Target Speed", &target_drive_speed, NULL},
+    {"target_speed", NULL, &target_speed, NULL},
+    {"machine_angle", "Angle PID.Mech Zero", &machine_angle, NULL},
+    {"output_filter", "Output Smooth.Filter Coeff", &output_filter_coeff, NULL},
+    {"angle_protection", "Motor Protection.Angle Threshold", &angle_protection, NULL},
+    {"steer.enable", "Steer PID.Enable (0/1)", NULL, &steer_enable},
+    {"steer.kp", "Steer PID.Kp (Image)", &steer_kp, NULL},
+    {"steer.kd", "Steer PID.Kd (Gyro Gz)", &steer_kd, NULL},
+    {"steer.limit", "Steer PID.Output Limit", &steer_output_limit, NULL},
+    {"turn.k_servo", "Turn Compensation.Deadzone", &turn_comp_k_servo, NULL},
+    {"turn.k_speed", "Turn Compensation.Gain", &turn_comp_k_speed, NULL},
+    {"turn.k_error", "Turn Compensation.Error Coeff", &turn_comp_k_error, NULL},
+    {"turn.max", "Turn Compensation.Max Comp", &turn_comp_max, NULL},
+    {"turn.threshold", "Turn Compensation.Img Err Thres", &turn_comp_image_threshold, NULL},
+
+    // 模型参数
+    {"plant.mass", NULL, &sim_params.mass, NULL},
+    {"plant.com_height", NULL, &sim_params.com_height, NULL},
+    {"plant.body_inertia", NULL, &sim_params.body_inertia, NULL},
+    {"plant.wheel_inertia", NULL, &sim_params.wheel_inertia, NULL},
+    {"plant.wheel_kt", NULL, &sim_params.wheel_kt, NULL},
+    {"plant.wheel_resistance", NULL, &sim_params.wheel_resistance, NULL},
+    {"plant.drive_kt", NULL, &sim_params.drive_kt, NULL},
+    {"plant.drive_gear", NULL, &sim_params.drive_gear, NULL},
+    {"plant.drive_drag", NULL, &sim_params.drive_drag, NULL},
+    {"plant.wheelbase", NULL, &sim_params.wheelbase, NULL},
+    {"plant.steer_ratio", NULL, &sim_params.steer_ratio, NULL},
+    {"plant.servo_tau", NULL, &sim_params.servo_tau, NULL},
+    {"plant.battery_voltage", NULL, &sim_params.battery_voltage, NULL},
+    {"plant.gyro_noise", NULL, &sim_params.gyro_noise, NULL},
+    {"plant.acc_noise", NULL, &sim_params.acc_noise, NULL},
+    {"plant.gyro_bias", NULL, &sim_params.gyro_bias, NULL},
+};
+
+const uint32 sim_param_num = sizeof(sim_param_table) / sizeof(sim_param_table[0]);
+
+static const char *const sim_scenario_names[SIM_SCENARIO_NUM] = {"balance", "drive", "turn", "track"};
+
+//============================================================
+// 内部函数
+//============================================================
+
+/**
+ * @brief 角度归一化到(-π, π]
+ */
+static float sim_wrap_angle(float angle)
+{
+    while (angle > SIM_PI)
+        angle -= 2.0f * SIM_PI;
+    while (angle <= -SIM_PI)
+        angle += 2.0f * SIM_PI;
+    return angle;
+}
+
+/**
+ * @brief 车相对赛道中线的偏差
+ * @param lateral 输出：最近点相对车的横向偏差（m，中线在车左侧为正）
+ * @param heading_err 输出：中线方向 - 车航向（rad）
+ */
+static void sim_track_error(float x, float y, float heading, float *lateral, float *heading_err)
+{
+    const float cx = SIM_TRACK_STRAIGHT_M, cy = SIM_TRACK_RADIUS_M; // 弯道圆心
+    const float ex = cx + SIM_TRACK_RADIUS_M * sinf(SIM_TRACK_ARC_RAD);
+    const float ey = cy - SIM_TRACK_RADIUS_M * cosf(SIM_TRACK_ARC_RAD);
+    float px, py, path_heading, dist, best = 1e30f;
+    float theta, s, dx, dy;
+
+    px = py = path_heading = 0.0f;
+
+    // 1. 起点直道（起点之前按直道延长）
+    if (x <= SIM_TRACK_STRAIGHT_M)
+    {
+        best = fabsf(y);
+        px = x;
+        py = 0.0f;
+        path_heading = 0.0f;
+    }
+
+    // 2. 弯道：点 = 圆心 + R·(sinθ, -cosθ)，切线方向为θ
+    dx = x - cx;
+    dy = y - cy;
+    theta = atan2f(dx, -dy);
+    if (theta >= 0.0f && theta <= SIM_TRACK_ARC_RAD)
+    {
+        dist = fabsf(sqrtf(dx * dx + dy * dy) - SIM_TRACK_RADIUS_M);
+        if (dist < best)
+        {
+            best = dist;
+            px = cx + SIM_TRACK_RADIUS_M * sinf(theta);
+            py = cy - SIM_TRACK_RADIUS_M * cosf(theta);
+            path_heading = theta;
+        }
+    }
+
+    // 3. 出弯直道
+    s = (x - ex) * cosf(SIM_TRACK_ARC_RAD) + (y - ey) * sinf(SIM_TRACK_ARC_RAD);
+    if (s >= 0.0f)
+    {
+        float qx = ex + s * cosf(SIM_TRACK_ARC_RAD), qy = ey + s * sinf(SIM_TRACK_ARC_RAD);
+        dist = sqrtf((x - qx) * (x - qx) + (y - qy) * (y - qy));
+        if (dist < best)
+        {
+            best = dist;
+            px = qx;
+            py = qy;
+            path_heading = SIM_TRACK_ARC_RAD;
+        }
+    }
+
+    // 投影到中线的左法向
+    *lateral = (px - x) * -sinf(path_heading) + (py - y) * cosf(path_heading);
+    *heading_err = sim_wrap_angle(path_heading - heading);
+}
+
+/**
+ * @brief 当前时刻的图像偏差（代替视觉结果）
+ */
+static float sim_image_error(const Sim_Config *config, float t_release, float *path_err)
+{
+    float lateral, heading_err;
+
+    *path_err = 0.0f;
+    switch (config->scenario)
+    {
+    case SIM_TURN:
+        if (t_release >= SIM_TURN_START_S && t_release < SIM_TURN_START_S + SIM_TURN_LENGTH_S)
+            return config->turn_error;
+        return 0.0f;
+
+    case SIM_TRACK:
+        sim_track_error(sim_state.x, sim_state.y, sim_state.heading, &lateral, &heading_err);
+        *path_err = lateral;
+        return SIM_CAMERA_PX_PER_M * (lateral + SIM_CAMERA_PREVIEW_M * sinf(heading_err));
+
+    default:
+        return 0.0f;
+    }
+}
+
+//============================================================
+// 函数实现
+//============================================================
+
+/**
+ * @brief 默认仿真配置
+ */
+void sim_config_default(Sim_Config *config)
+{
+    config->scenario = SIM_TURN;
+    config->run_s = 8.0f;
+    config->hold_s = 2.0f;
+    config->lean_deg = 0.0f;
+    config->kick_dps = 5.0f;
+    config->turn_error = 20.0f;
+    config->seed = 1;
+    config->csv_path = NULL;
+    config->csv_every = 1;
+}
+
+/**
+ * @brief 场景名称转枚举
+ */
+Sim_Scenario sim_scenario_from_name(const char *name)
+{
+    uint32 i;
+
+    for (i = 0; i < SIM_SCENARIO_NUM; i++)
+    {
+        if (strcmp(name, sim_scenario_names[i]) == 0)
+            return (Sim_Scenario)i;
+    }
+    return SIM_SCENARIO_NUM;
+}
+
+/**
+ * @brief 场景枚举转名称
+ */
+const char *sim_scenario_name(Sim_Scenario scenario)
+{
+    return scenario < SIM_SCENARIO_NUM ? sim_scenario_names[scenario] : "unknown";
+}
+
+/**
+ * @brief 按名称查找参数
+ */
+const Sim_Param_Entry *sim_find_param(const char *name, size_t len)
+{
+    uint32 i;
+
+    for (i = 0; i < sim_param_num; i++)
+    {
+        if (strlen(sim_param_table[i].name) == len && strncmp(sim_param_table[i].name, name, len) == 0)
+            return &sim_param_table[i];
+    }
+    return NULL;
+}
+
+/**
+ * @brief 读取参数值
+ */
+float sim_get_param(const Sim_Param_Entry *entry)
+{
+    return entry->f != NULL ? *entry->f : (float)*entry->u;
+}
+
+/**
+ * @brief 写入参数值
+ */
+void sim_put_param(const Sim_Param_Entry *entry, float value)
+{
+    if (entry->f != NULL)
+        *entry->f = value;
+    else
+        *entry->u = value > 0.0f ? (uint32)(value + 0.5f) : 0;
+}
+
+/**
+ * @brief 按 名称=值 修改一个参数
+ */
+uint8 sim_set_param(const char *assignment)
+{
+    const char *eq = strchr(assignment, '=');
+    const Sim_Param_Entry *entry;
+
+    if (eq == NULL)
+        return 0;
+    entry = sim_find_param(assignment, (size_t)(eq - assignment));
+    if (entry == NULL)
+        return 0;
+    if (entry->f != NULL)
+        *entry->f = strtof(eq + 1, NULL);
+    else
+        *entry->u = (uint32)strtoul(eq + 1, NULL, 0);
+    return 1;
+}
+
+/**
+ * @brief 从文件读取参数
+ */
+uint8 sim_load_params(const char *path)
+{
+    char line[128];
+    uint8 ok = 1;
+    FILE *fp = fopen(path, "r");
+
+    if (fp == NULL)
+        return 0;
+    while (fgets(line, sizeof(line), fp) != NULL)
+    {
+        line[strcspn(line, "\r\n")] = '\0';
+        if (line[0] == '\0' || line[0] == '#')
+            continue;
+        if (!sim_set_param(line))
+        {
+            fprintf(stderr, "invalid parameter line: %s\n", line);
+            ok = 0;
+        }
+    }
+    fclose(fp);
+    return ok;
+}
+
+/**
+ * @brief 运行一次闭环仿真
+ */
+void sim_run(const Sim_Config *config, Sim_Result *result)
+{
+    FILE *csv = NULL;
+    Sim_Input input;
+    uint32 hold_ms, total_ms, ms, i;
+    uint32 csv_every = config->csv_every ? config->csv_every : 1;
+    float lean, image_error = 0.0f, path_err = 0.0f, t, speed_err, kick_sign;
+    double lean_sq = 0.0, speed_sum = 0.0, speed_err_sq = 0.0, path_err_sq = 0.0;
+    uint32 samples = 0;
+    float heading0 = 0.0f;
+    clock_t wall_start;
+
+    memset(result, 0, sizeof(*result));
+    kick_sign = config->kick_dps != 0.0f ? config->kick_dps : config->lean_deg;
+    kick_sign = kick_sign > 0.0f ? 1.0f : (kick_sign < 0.0f ? -1.0f : 0.0f);
+
+    if (config->csv_path != NULL)
+    {
+        csv = fopen(config->csv_path, "w");
+        if (csv == NULL)
+            fprintf(stderr, "cannot open %s\n", config->csv_path);
+        else
+            fprintf(csv, "t_ms,lean_deg,pitch,gyro_y,wheel_duty,wheel_rpm,speed_mps,enc0,enc1,servo_deg,image_error,turn_comp,x,y,enable\n");
+    }
+
+    // 1. 与all_init()相同顺序初始化参与仿真的模块
+    if (config->scenario == SIM_BALANCE)
+        target_drive_speed = 0.0f;
+    sim_hal_reset(config->seed);
+    sim_plant_init(&sim_state, &sim_params, config->lean_deg);
+    imu_init();
+    motor_init();
+    servo_init();
+    buzzer_init();
+    pid_init();
+    turn_compensation_init();
+
+    hold_ms = (uint32)(config->hold_s * 1000.0f);
+    total_ms = hold_ms + (uint32)(config->run_s * 1000.0f);
+    wall_start = clock();
+
+    // 2. 仿真循环：扶住阶段只运行传感器任务，释放时与Cargo模式相同地使能控制
+    for (ms = 0; ms < total_ms; ms++)
+    {
+        if (ms == hold_ms)
+        {
+            motor_reset_protection();
+            enable = true;
+            delayed_stop_start_with_param();
+            heading0 = sim_state.heading;
+            sim_state.lean_rate = config->kick_dps / SIM_RAD_TO_DEG;
+        }
+
+        control();
+        if (ms % 20 == 0)
+            buzzer_update();
+
+        if (ms >= hold_ms && enable && (ms - hold_ms) % SIM_CAMERA_PERIOD_MS == 0)
+        {
+            image_error = sim_image_error(config, (float)(ms - hold_ms) / 1000.0f, &path_err);
+            steer_pid_control(image_error);
+        }
+
+        sim_hal_get_input(&input);
+        for (i = 0; i < SIM_SUBSTEPS; i++)
+        {
+            if (ms >= hold_ms)
+                sim_plant_step(&sim_state, &sim_params, &input, 0.001f / SIM_SUBSTEPS);
+            sim_time_ticks += SIM_TICKS_PER_MS / SIM_SUBSTEPS;
+        }
+
+        // 3. 统计
+        lean = sim_state.lean * SIM_RAD_TO_DEG;
+        if (ms >= hold_ms)
+        {
+            t = (float)(ms - hold_ms + 1) / 1000.0f;
+            if (!result->fell && (!enable || fabsf(lean) >= SIM_FALL_DEG))
+            {
+                result->fell = 1;
+                result->fall_time_s = t;
+            }
+            if (fabsf(lean) > result->lean_max)
+                result->lean_max = fabsf(lean);
+            if (fabsf(lean) > SIM_SETTLE_BAND_DEG)
+                result->settle_time_s = t;
+            if (-kick_sign * lean > result->overshoot_deg)
+                result->overshoot_deg = -kick_sign * lean;
+
+            speed_err = (float)encoder[1] - target_drive_speed;
+            lean_sq += (double)lean * lean;
+            speed_err_sq += (double)speed_err * speed_err;
+            path_err_sq += (double)path_err * path_err;
+            speed_sum += sim_state.speed;
+            samples++;
+        }
+        if (csv != NULL && ms % csv_every == 0)
+        {
+            fprintf(csv, "%lu,%.3f,%.3f,%d,%.4f,%.1f,%.4f,%d,%d,%.2f,%.1f,%.3f,%.3f,%.3f,%d\n",
+                    (unsigned long)ms, lean, imu_data.pitch, imu_data.gyro_y, input.wheel_duty,
+                    sim_state.wheel_speed * 60.0f / (2.0f * SIM_PI), sim_state.speed, encoder[0], encoder[1],
+                    sim_state.servo_deg, image_error, turn_compensation_get_current(),
+                    sim_state.x, sim_state.y, enable ? 1 : 0);
+        }
+        if (result->fell && csv == NULL)
+            break;
+    }
+
+    // 4. 结果
+    result->wall_s = (double)(clock() - wall_start) / CLOCKS_PER_SEC;
+    result->sim_time_s = samples / 1000.0f;
+    if (!result->fell)
+        result->fall_time_s = config->run_s;
+    else
+        result->settle_time_s = config->run_s;
+    if (samples > 0)
+    {
+        result->lean_rms = (float)sqrt(lean_sq / samples);
+        result->speed_err_rms = (float)sqrt(speed_err_sq / samples);
+        result->path_err_rms = (float)sqrt(path_err_sq / samples);
+        result->speed_mean = (float)(speed_sum / samples);
+    }
+    result->heading_deg = (sim_state.heading - heading0) * SIM_RAD_TO_DEG;
+    result->wheel_rpm = sim_state.wheel_speed * 60.0f / (2.0f * SIM_PI);
+
+    if (csv != NULL)
+        fclose(csv);
+}
+
+#endif
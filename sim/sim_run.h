@@ -0,0 +1,128 @@
+/*********************************************************************
+ * 文件: sim_run.h
+ * 主机仿真单次运行头文件
+ * 说明：场景脚本、参数表和评价指标，供car_sim（单次仿真）和car_tune（参数搜索）共用；
+ *       控制代码中有函数内静态变量（如角度保护的触发标志），初始化函数不会清零，
+ *       因此一个进程只应调用一次sim_run()，多次仿真请分别在子进程中运行
+ ********************************************************************/
+
+#ifndef _SIM_RUN_H
+#define _SIM_RUN_H
+
+#include "zf_common_typedef.h"
+
+//============================================================
+// 宏定义
+//============================================================
+
+#define SIM_SETTLE_BAND_DEG 0.5f // 调节时间的倾角误差带（度）
+
+//============================================================
+// 类型定义
+//============================================================
+
+typedef enum
+{
+    SIM_BALANCE = 0, // 原地平衡
+    SIM_DRIVE,       // 直行
+    SIM_TURN,        // 直行后转弯（开环图像偏差）
+    SIM_TRACK,       // 沿赛道行驶（图像偏差由车与赛道中线的偏差计算，转向闭环）
+    SIM_SCENARIO_NUM,
+} Sim_Scenario;
+
+// 单次仿真配置
+typedef struct
+{
+    Sim_Scenario scenario;
+    float run_s;         // 释放后的仿真时长（s）
+    float hold_s;        // 释放前扶住车体的时长（s）
+    float lean_deg;      // 扶住时的倾角（度）
+    float kick_dps;      // 释放时的初始倾角速度（度/秒）
+    float turn_error;    // turn场景的图像偏差
+    uint32 seed;         // 传感器噪声种子
+    const char *csv_path;// 逐毫秒曲线输出文件（NULL=不输出）
+    uint32 csv_every;    // 曲线输出间隔（ms）
+} Sim_Config;
+
+// 单次仿真结果（时间均从释放时刻起算）
+typedef struct
+{
+    uint8 fell;          // 1=倒车或触发保护
+    float sim_time_s;    // 实际仿真时长（倒车后提前结束）
+    float fall_time_s;   // 倒车时刻（未倒车时等于run_s）
+    float lean_max;      // 最大倾角（度）
+    float lean_rms;      // 倾角均方根（度）
+    float settle_time_s; // 调节时间：倾角最后一次超出误差带的时刻
+    float overshoot_deg; // 超调：与释放扰动方向相反的最大倾角（度）
+    float speed_err_rms; // 行进轮速度误差均方根（编码器计数，balance场景以0为目标）
+    float path_err_rms;  // 赛道横向偏差均方根（m，仅track场景）
+    float speed_mean;    // 平均前进速度（m/s）
+    float heading_deg;   // 航向变化（度）
+    float wheel_rpm;     // 结束时动量轮转速（rpm）
+    double wall_s;       // 运行耗时（s）
+} Sim_Result;
+
+// 可修改参数表项
+typedef struct
+{
+    const char *name; // 仿真中的参数名
+    const char *menu; // 菜单中的"页面名.参数名"，即参数保存的哈希键（NULL=不在菜单中）
+    float *f;         // 浮点参数
+    uint32 *u;        // 整数参数
+} Sim_Param_Entry;
+
+//============================================================
+// 全局变量声明
+//============================================================
+
+extern const Sim_Param_Entry sim_param_table[]; // 可修改参数表
+extern const uint32 sim_param_num;              // 参数表项数
+
+//============================================================
+// 函数声明
+//============================================================
+
+/**
+ * @brief 默认仿真配置
+ */
+void sim_config_default(Sim_Config *config);
+
+/**
+ * @brief 场景名称与枚举互转
+ * @return sim_scenario_from_name：找不到时返回SIM_SCENARIO_NUM
+ */
+Sim_Scenario sim_scenario_from_name(const char *name);
+const char *sim_scenario_name(Sim_Scenario scenario);
+
+/**
+ * @brief 按名称查找参数
+ * @return 参数表项，找不到时返回NULL
+ */
+const Sim_Param_Entry *sim_find_param(const char *name, size_t len);
+
+/**
+ * @brief 读取/写入参数值（整数参数按浮点数读写）
+ */
+float sim_get_param(const Sim_Param_Entry *entry);
+void sim_put_param(const Sim_Param_Entry *entry, float value);
+
+/**
+ * @brief 按 名称=值 修改一个参数
+ * @return 1=成功，0=名称不存在或格式错误
+ */
+uint8 sim_set_param(const char *assignment);
+
+/**
+ * @brief 从文件读取参数，每行一个 名称=值，#开头为注释
+ * @return 1=成功，0=文件无法打开或有无效行
+ */
+uint8 sim_load_params(const char *path);
+
+/**
+ * @brief 初始化控制代码和模型，运行一次闭环仿真
+ * @param config 配置
+ * @param result 输出：评价指标
+ */
+void sim_run(const Sim_Config *config, Sim_Result *result);
+
+#endif
@@ -0,0 +1,191 @@
+/*********************************************************************
+ * 文件: sim_sched_test.c
+ * 1ms控制任务表的主机测试
+ * 说明：用pid.c中的control_tasks[]（周期、相位、预算、运行条件原样复制，任务函数换成记录函数）
+ *       驱动scheduler.c的sched_tick()，检查：
+ *       1. 每个任务恰好在 t%周期==相位 的节拍运行，未使能时控制环不运行且相位不变
+ *       2. 同一节拍内传感器采集先于使用它的控制环，串级控制环由外到内（速度环 -> 角度环 -> 角速度环）
+ *       3. 单节拍最多运行的任务数和声明预算之和（最坏节拍负载）
+ *       任一检查失败时返回1
+ *
+ * 构建与运行（在仓库根目录执行，SIM_SRC见sim_main.c）：
+ *   gcc -O2 -std=gnu99 -DCAR_SIM -Isim -Icode -o sched_test sim/sim_sched_test.c $SIM_SRC -lm
+ *   ./sched_test
+ ********************************************************************/
+
+#if defined(CAR_SIM) // 仅在主机仿真构建中编译
+
+#include "zf_common_headfile.h"
+
+//============================================================
+// 宏定义
+//============================================================
+
+#define TEST_MAX_TASKS 16      // 任务表最大项数
+#define TEST_HYPER_PERIOD 20   // 各周期（2、5、20ms）的最小公倍数
+#define TEST_TICKS (TEST_HYPER_PERIOD * 10)
+#define TEST_MAX_TASKS_PER_TICK 4 // 单节拍最多运行的任务数（pid.c中任务表注释的设计值）
+
+//============================================================
+// 节拍内执行顺序约束：同一节拍内两者都运行时，first必须先于second
+//============================================================
+
+typedef struct
+{
+    const char *first;
+    const char *second;
+} Order_Rule;
+
+static const Order_Rule order_rules[] = {
+    {"IMU", "Angle"},      // 姿态解算 -> 角度环
+    {"IMU", "Gyro"},       // 陀螺仪数据 -> 角速度环
+    {"DriveEnc", "Angle"}, // 行进轮速度 -> 转弯补偿（角度环内部）
+    {"MomEnc", "Speed"},   // 动量轮编码器 -> 速度环
+    {"Speed", "Angle"},    // 速度环输出desired_angle -> 角度环
+    {"Angle", "Gyro"},     // 角度环输出angle_gyro_target -> 角速度环
+};
+
+//============================================================
+// 记录函数：每个任务一个，记录本节拍内的执行顺序
+//============================================================
+
+static Sched_Task tasks[TEST_MAX_TASKS];
+static uint8 task_num = 0;
+static int8 tick_order[TEST_MAX_TASKS]; // 本节拍内各任务的执行序号（-1=未运行）
+static int8 tick_runs = 0;              // 本节拍已运行的任务数
+
+static void record(uint8 index)
+{
+    tick_order[index] = tick_runs++;
+}
+
+#define RECORD_FN(n) static void record_##n(void) { record(n); }
+RECORD_FN(0) RECORD_FN(1) RECORD_FN(2) RECORD_FN(3) RECORD_FN(4) RECORD_FN(5) RECORD_FN(6) RECORD_FN(7)
+RECORD_FN(8) RECORD_FN(9) RECORD_FN(10) RECORD_FN(11) RECORD_FN(12) RECORD_FN(13) RECORD_FN(14) RECORD_FN(15)
+
+static void (*const record_fn[TEST_MAX_TASKS])(void) = {
+    record_0, record_1, record_2, record_3, record_4, record_5, record_6, record_7,
+    record_8, record_9, record_10, record_11, record_12, record_13, record_14, record_15,
+};
+
+static int find_task(const char *name)
+{
+    uint8 i;
+
+    for (i = 0; i < task_num; i++)
+    {
+        if (strcmp(tasks[i].name, name) == 0)
+            return i;
+    }
+    return -1;
+}
+
+int main(void)
+{
+    uint32 t, i, r;
+    uint32 failures = 0;
+    uint32 max_tasks = 0, max_budget = 0, max_tasks_tick = 0, max_budget_tick = 0;
+    uint8 enabled;
+
+    // 1. 复制任务表，任务函数换成记录函数
+    if (control_task_num > TEST_MAX_TASKS)
+    {
+        printf("FAIL control_tasks has %u entries, test supports %u\n", control_task_num, TEST_MAX_TASKS);
+        return 1;
+    }
+    task_num = control_task_num;
+    for (i = 0; i < task_num; i++)
+    {
+        tasks[i] = control_tasks[i];
+        tasks[i].run = record_fn[i];
+    }
+    for (r = 0; r < sizeof(order_rules) / sizeof(order_rules[0]); r++)
+    {
+        if (find_task(order_rules[r].first) < 0 || find_task(order_rules[r].second) < 0)
+        {
+            printf("FAIL order rule %s -> %s names a task that is not in control_tasks\n", order_rules[r].first, order_rules[r].second);
+            failures++;
+        }
+    }
+    sched_init(tasks, task_num);
+
+    // 2. 逐节拍运行：前半段使能，中间一个超周期不使能，之后再使能
+    for (t = 0; t < TEST_TICKS; t++)
+    {
+        uint32 tick_budget = 0;
+
+        enabled = !(t >= TEST_TICKS / 2 && t < TEST_TICKS / 2 + TEST_HYPER_PERIOD);
+        memset(tick_order, -1, sizeof(tick_order));
+        tick_runs = 0;
+        sched_tick(tasks, task_num, enabled);
+
+        for (i = 0; i < task_num; i++)
+        {
+            uint8 due = (t % tasks[i].period_ms) == tasks[i].phase_ms;
+            uint8 expect = due && (enabled || !(tasks[i].flags & SCHED_NEED_ENABLE));
+
+            if (expect != (tick_order[i] >= 0))
+            {
+                printf("FAIL t=%u %s %s\n", t, tasks[i].name, expect ? "did not run" : "ran off its phase");
+                failures++;
+            }
+            if (tick_order[i] >= 0)
+                tick_budget += tasks[i].budget_us;
+        }
+
+        for (r = 0; r < sizeof(order_rules) / sizeof(order_rules[0]); r++)
+        {
+            int a = find_task(order_rules[r].first), b = find_task(order_rules[r].second);
+            if (a >= 0 && b >= 0 && tick_order[a] >= 0 && tick_order[b] >= 0 && tick_order[a] > tick_order[b])
+            {
+                printf("FAIL t=%u %s ran after %s\n", t, order_rules[r].first, order_rules[r].second);
+                failures++;
+            }
+        }
+
+        if ((uint32)tick_runs > max_tasks)
+        {
+            max_tasks = tick_runs;
+            max_tasks_tick = t;
+        }
+        if (tick_budget > max_budget)
+        {
+            max_budget = tick_budget;
+            max_budget_tick = t;
+        }
+    }
+
+    // 3. 最坏节拍负载
+    printf("ticks simulated        %u (%u with control disabled)\n", TEST_TICKS, TEST_HYPER_PERIOD);
+    printf("max tasks per tick     %u (t%%%u == %u)\n", max_tasks, TEST_HYPER_PERIOD, max_tasks_tick % TEST_HYPER_PERIOD);
+    printf("max budget per tick    %u us (t%%%u == %u)\n", max_budget, TEST_HYPER_PERIOD, max_budget_tick % TEST_HYPER_PERIOD);
+    if (max_tasks > TEST_MAX_TASKS_PER_TICK)
+    {
+        printf("FAIL %u tasks share one tick, design limit is %u\n", max_tasks, TEST_MAX_TASKS_PER_TICK);
+        failures++;
+    }
+
+    printf("per-tick pattern over one hyper-period (run order):\n");
+    sched_init(tasks, task_num);
+    for (t = 0; t < TEST_HYPER_PERIOD; t++)
+    {
+        memset(tick_order, -1, sizeof(tick_order));
+        tick_runs = 0;
+        sched_tick(tasks, task_num, 1);
+        printf("  t%%%u=%2u:", TEST_HYPER_PERIOD, t);
+        for (r = 0; r < (uint32)tick_runs; r++)
+        {
+            for (i = 0; i < task_num; i++)
+            {
+                if (tick_order[i] == (int8)r)
+                    printf(" %s", tasks[i].name);
+            }
+        }
+        printf("\n");
+    }
+
+    printf("%s\n", failures ? "FAILED" : "PASSED");
+    return failures ? 1 : 0;
+}
+
+#endif
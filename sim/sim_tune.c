@@ -0,0 +1,759 @@
+/*********************************************************************
+ * 文件: sim_tune.c
+ * 主机仿真参数搜索（自动调参）主程序
+ * 说明：按网格或随机方式生成参数组合，每个组合在每个场景、每个噪声种子下运行一次闭环仿真，
+ *       仿真在fork出的子进程中并行执行（子进程继承基础参数，只修改本组合的参数，
+ *       控制代码中的静态状态不会在两次仿真之间残留），结果经管道返回；
+ *       多轮搜索时，每轮结束后以最优组合为中心把各参数的搜索范围缩小一半；
+ *       最优参数输出为文本（car_sim --params可直接读取）和与Param_Save_All()相同格式的Flash数据镜像
+ *
+ * 构建（SIM_SRC见sim_main.c）：
+ *   gcc -O2 -std=gnu99 -DCAR_SIM -Isim -Icode -o car_tune sim/sim_tune.c $SIM_SRC -lm
+ *
+ * 用法：
+ *   ./car_tune --params sim/example.params --vary gyro.kp=-12:-4:5 --vary steer.kp=0.3,0.5,0.8 [选项]
+ *     --vary 名称=最小:最大[:点数]   搜索范围（网格点数默认5），或 名称=值1,值2,... 列举取值（可重复）
+ *     --space 文件                   从文件读取搜索范围，每行一个，格式同--vary，#开头为注释
+ *     --strategy grid|random         网格搜索 / 均匀随机搜索（默认grid）
+ *     --samples 数量                 random每轮的组合数（默认200）
+ *     --rounds 轮数                  搜索轮数（默认1）
+ *     --scenarios 场景,...           参与评价的场景（默认balance,track）
+ *     --seeds 数量                   每个场景使用的噪声种子数（默认1）
+ *     --jobs 数量                    并行进程数（默认为CPU核数）
+ *     --w-settle/--w-overshoot/--w-lean/--w-track/--w-speed 权重  评分权重（见tune_score()）
+ *     --top 数量                     打印的最优组合数（默认10）
+ *     --out 文件                     最优参数文本（默认tune_best.params）
+ *     --flash 文件                   最优参数的Flash数据镜像（默认tune_best.bin）
+ *     --csv 文件                     输出全部组合的评价结果
+ *     --params/--set/--time/--hold/--lean/--kick/--turn-error/--seed  同car_sim
+ ********************************************************************/
+
+#if defined(CAR_SIM) // 仅在主机仿真构建中编译
+
+#include "zf_common_headfile.h"
+#include "sim_hal.h"
+#include "sim_run.h"
+#include <time.h>
+#include <unistd.h>
+#include <sys/wait.h>
+
+//============================================================
+// 宏定义
+//============================================================
+
+#define TUNE_MAX_DIMS 16          // 最多同时搜索的参数个数
+#define TUNE_MAX_VALUES 16        // 列举取值的最大个数
+#define TUNE_MAX_SCENARIOS 4      // 最多参与评价的场景数
+#define TUNE_MAX_CANDIDATES 100000// 每轮最多组合数
+#define TUNE_FALL_PENALTY 1000.0f // 倒车的固定罚分
+#define TUNE_FALL_RATE 100.0f     // 倒车越早罚分越高（每秒）
+
+// 与param_save.h一致
+#define TUNE_PARAM_MAGIC 0x12345678u
+#define TUNE_PARAM_MAX 100
+
+//============================================================
+// 类型定义
+//============================================================
+
+// 一个搜索维度
+typedef struct
+{
+    const Sim_Param_Entry *entry;
+    float min, max;                // 搜索范围（列举取值时不用）
+    uint32 points;                 // 网格点数
+    float values[TUNE_MAX_VALUES]; // 列举的取值
+    uint32 value_num;              // 列举取值个数（0=按范围搜索）
+} Tune_Dim;
+
+// 一个组合的评价结果（调节时间和超调为balance/drive场景的平均值，赛道偏差为track场景的平均值，其余为全部仿真的平均值）
+typedef struct
+{
+    float score;
+    uint32 falls;
+    float settle;
+    float overshoot;
+    float lean_rms;
+    float path_err;
+    float speed_err;
+} Tune_Score;
+
+// 一次仿真任务
+typedef struct
+{
+    uint32 candidate;
+    uint32 scenario; // scenarios[]下标
+    uint32 seed;
+    pid_t pid;
+    int fd; // 结果管道读端
+} Tune_Job;
+
+//============================================================
+// 全局变量
+//============================================================
+
+static Tune_Dim dims[TUNE_MAX_DIMS];
+static uint32 dim_num = 0;
+static Sim_Scenario scenarios[TUNE_MAX_SCENARIOS] = {SIM_BALANCE, SIM_TRACK};
+static uint32 scenario_num = 2;
+static uint32 seed_num = 1;
+
+static float w_settle = 1.0f;    // 调节时间（s）
+static float w_overshoot = 1.0f; // 超调（度）
+static float w_lean = 1.0f;      // 倾角均方根（度）
+static float w_track = 10.0f;    // 赛道横向偏差均方根（m）
+static float w_speed = 0.1f;     // 行进轮速度误差均方根（编码器计数）
+
+static uint32 rng_state = 1; // 随机搜索用的随机数状态
+static const Tune_Score *sort_scores; // 排序时比较的评分数组
+
+//============================================================
+// 内部函数
+//============================================================
+
+/**
+ * @brief 0~1均匀随机数
+ */
+static float tune_random(void)
+{
+    rng_state = rng_state * 1664525u + 1013904223u;
+    return (float)(rng_state >> 8) / (float)(1u << 24);
+}
+
+/**
+ * @brief 解析 名称=最小:最大[:点数] 或 名称=值1,值2,...
+ * @return 1=成功，0=格式错误
+ */
+static uint8 tune_parse_dim(const char *spec)
+{
+    const char *eq = strchr(spec, '=');
+    Tune_Dim *dim;
+    char *end;
+
+    if (eq == NULL || dim_num >= TUNE_MAX_DIMS)
+        return 0;
+    dim = &dims[dim_num];
+    memset(dim, 0, sizeof(*dim));
+    dim->entry = sim_find_param(spec, (size_t)(eq - spec));
+    if (dim->entry == NULL)
+        return 0;
+
+    if (strchr(eq + 1, ':') != NULL)
+    {
+        dim->min = strtof(eq + 1, &end);
+        if (*end != ':')
+            return 0;
+        dim->max = strtof(end + 1, &end);
+        dim->points = 5;
+        if (*end == ':')
+            dim->points = (uint32)strtoul(end + 1, &end, 0);
+        if (dim->points == 0 || dim->min > dim->max)
+            return 0;
+    }
+    else
+    {
+        end = (char *)eq;
+        do
+        {
+            if (dim->value_num >= TUNE_MAX_VALUES)
+                return 0;
+            dim->values[dim->value_num++] = strtof(end + 1, &end);
+        } while (*end == ',');
+    }
+    if (*end != '\0')
+        return 0;
+
+    dim_num++;
+    return 1;
+}
+
+/**
+ * @brief 从文件读取搜索范围
+ */
+static uint8 tune_load_space(const char *path)
+{
+    char line[160];
+    uint8 ok = 1;
+    FILE *fp = fopen(path, "r");
+
+    if (fp == NULL)
+        return 0;
+    while (fgets(line, sizeof(line), fp) != NULL)
+    {
+        line[strcspn(line, "\r\n")] = '\0';
+        if (line[0] == '\0' || line[0] == '#')
+            continue;
+        if (!tune_parse_dim(line))
+        {
+            fprintf(stderr, "invalid search range: %s\n", line);
+            ok = 0;
+        }
+    }
+    fclose(fp);
+    return ok;
+}
+
+/**
+ * @brief 解析场景列表（逗号分隔）
+ */
+static uint8 tune_parse_scenarios(const char *list)
+{
+    char name[16];
+    size_t len;
+
+    scenario_num = 0;
+    while (*list != '\0')
+    {
+        len = strcspn(list, ",");
+        if (len == 0 || len >= sizeof(name) || scenario_num >= TUNE_MAX_SCENARIOS)
+            return 0;
+        memcpy(name, list, len);
+        name[len] = '\0';
+        scenarios[scenario_num] = sim_scenario_from_name(name);
+        if (scenarios[scenario_num] == SIM_SCENARIO_NUM)
+            return 0;
+        scenario_num++;
+        list += len;
+        if (*list == ',')
+            list++;
+    }
+    return scenario_num > 0;
+}
+
+/**
+ * @brief 网格点取值
+ */
+static float tune_grid_value(const Tune_Dim *dim, uint32 index)
+{
+    if (dim->value_num > 0)
+        return dim->values[index];
+    if (dim->points == 1)
+        return 0.5f * (dim->min + dim->max);
+    return dim->min + (dim->max - dim->min) * (float)index / (float)(dim->points - 1);
+}
+
+/**
+ * @brief 生成一轮的候选组合
+ * @return 组合数
+ */
+static uint32 tune_generate(float *values, uint8 grid, uint32 samples)
+{
+    uint32 count = 1, c, d, index;
+
+    if (grid)
+    {
+        for (d = 0; d < dim_num; d++)
+        {
+            count *= dims[d].value_num > 0 ? dims[d].value_num : dims[d].points;
+            if (count > TUNE_MAX_CANDIDATES)
+                return 0;
+        }
+        for (c = 0; c < count; c++)
+        {
+            index = c;
+            for (d = 0; d < dim_num; d++)
+            {
+                uint32 n = dims[d].value_num > 0 ? dims[d].value_num : dims[d].points;
+                values[c * dim_num + d] = tune_grid_value(&dims[d], index % n);
+                index /= n;
+            }
+        }
+        return count;
+    }
+
+    count = samples < TUNE_MAX_CANDIDATES ? samples : TUNE_MAX_CANDIDATES;
+    for (c = 0; c < count; c++)
+    {
+        for (d = 0; d < dim_num; d++)
+        {
+            if (dims[d].value_num > 0)
+                values[c * dim_num + d] = dims[d].values[(uint32)(tune_random() * dims[d].value_num) % dims[d].value_num];
+            else
+                values[c * dim_num + d] = dims[d].min + (dims[d].max - dims[d].min) * tune_random();
+        }
+    }
+    return count;
+}
+
+/**
+ * @brief 单次仿真的评分（越小越好）
+ * @note  倒车：固定罚分 + 越早倒车罚分越高；
+ *        未倒车：倾角均方根、行进轮速度误差和赛道偏差按权重求和，
+ *        调节时间和超调只在balance/drive场景中计入（turn/track场景中转弯需要的倾角不应算作误差）
+ */
+static float tune_score(const Sim_Config *config, Sim_Scenario scenario, const Sim_Result *result)
+{
+    float score;
+
+    if (result->fell)
+        return TUNE_FALL_PENALTY + TUNE_FALL_RATE * (config->run_s - result->fall_time_s);
+
+    score = w_lean * result->lean_rms + w_speed * result->speed_err_rms + w_track * result->path_err_rms;
+    if (scenario == SIM_BALANCE || scenario == SIM_DRIVE)
+        score += w_settle * result->settle_time_s + w_overshoot * result->overshoot_deg;
+    return score;
+}
+
+/**
+ * @brief 并行运行全部组合
+ * @param scores 输出：各组合的评价结果
+ * @return 1=成功，0=无法创建子进程
+ */
+static uint8 tune_evaluate(const Sim_Config *base, const float *values, uint32 count, uint32 jobs, Tune_Score *scores)
+{
+    uint32 total = count * scenario_num * seed_num;
+    uint32 next = 0, running = 0, done = 0, i, j;
+    Tune_Job *slots = calloc(jobs, sizeof(Tune_Job));
+    uint32 *runs = calloc(count * 3, sizeof(uint32)); // 每个组合：全部/balance与drive/track仿真次数
+
+    if (slots == NULL || runs == NULL)
+        return 0;
+    memset(scores, 0, count * sizeof(Tune_Score));
+
+    while (done < total)
+    {
+        // 1. 填满空闲的进程槽
+        while (running < jobs && next < total)
+        {
+            Tune_Job *job = NULL;
+            int fds[2];
+
+            for (i = 0; i < jobs; i++)
+            {
+                if (slots[i].pid == 0)
+                {
+                    job = &slots[i];
+                    break;
+                }
+            }
+            job->candidate = next / (scenario_num * seed_num);
+            job->scenario = (next / seed_num) % scenario_num;
+            job->seed = next % seed_num;
+
+            if (pipe(fds) != 0)
+                return 0;
+            job->pid = fork();
+            if (job->pid < 0)
+                return 0;
+            if (job->pid == 0)
+            {
+                // 子进程：修改本组合的参数，仿真一次，把结果写回管道
+                Sim_Config config = *base;
+                Sim_Result result;
+
+                close(fds[0]);
+                for (j = 0; j < dim_num; j++)
+                    sim_put_param(dims[j].entry, values[job->candidate * dim_num + j]);
+                config.scenario = scenarios[job->scenario];
+                config.seed = base->seed + job->seed;
+                config.csv_path = NULL;
+                sim_run(&config, &result);
+                if (write(fds[1], &result, sizeof(result)) != (ssize_t)sizeof(result))
+                    _exit(1);
+                _exit(0);
+            }
+            close(fds[1]);
+            job->fd = fds[0];
+            running++;
+            next++;
+        }
+
+        // 2. 回收一个结束的子进程
+        {
+            int status;
+            pid_t pid = wait(&status);
+            Sim_Result result;
+            Sim_Config config = *base;
+            Tune_Score *score;
+
+            if (pid < 0)
+                return 0;
+            for (i = 0; i < jobs; i++)
+            {
+                if (slots[i].pid == pid)
+                    break;
+            }
+            if (i == jobs)
+                continue;
+
+            // 子进程异常退出时按释放即倒车处理
+            if (read(slots[i].fd, &result, sizeof(result)) != (ssize_t)sizeof(result))
+            {
+                memset(&result, 0, sizeof(result));
+                result.fell = 1;
+            }
+            close(slots[i].fd);
+
+            score = &scores[slots[i].candidate];
+            config.scenario = scenarios[slots[i].scenario];
+            score->score += tune_score(&config, config.scenario, &result);
+            score->falls += result.fell;
+            score->lean_rms += result.lean_rms;
+            score->speed_err += result.speed_err_rms;
+            runs[slots[i].candidate * 3]++;
+            if (config.scenario == SIM_BALANCE || config.scenario == SIM_DRIVE)
+            {
+                score->settle += result.settle_time_s;
+                score->overshoot += result.overshoot_deg;
+                runs[slots[i].candidate * 3 + 1]++;
+            }
+            if (config.scenario == SIM_TRACK)
+            {
+                score->path_err += result.path_err_rms;
+                runs[slots[i].candidate * 3 + 2]++;
+            }
+
+            slots[i].pid = 0;
+            running--;
+            done++;
+        }
+    }
+
+    for (i = 0; i < count; i++)
+    {
+        float n = (float)runs[i * 3];
+        scores[i].score /= n;
+        scores[i].lean_rms /= n;
+        scores[i].speed_err /= n;
+        if (runs[i * 3 + 1] > 0)
+        {
+            scores[i].settle /= (float)runs[i * 3 + 1];
+            scores[i].overshoot /= (float)runs[i * 3 + 1];
+        }
+        if (runs[i * 3 + 2] > 0)
+            scores[i].path_err /= (float)runs[i * 3 + 2];
+    }
+
+    free(slots);
+    free(runs);
+    return 1;
+}
+
+/**
+ * @brief 按评分升序比较组合下标（qsort回调）
+ */
+static int tune_compare(const void *a, const void *b)
+{
+    float sa = sort_scores[*(const uint32 *)a].score, sb = sort_scores[*(const uint32 *)b].score;
+    return sa < sb ? -1 : (sa > sb ? 1 : 0);
+}
+
+/**
+ * @brief 与param_save.c中的string_hash()相同
+ */
+static uint32 tune_string_hash(const char *str)
+{
+    uint32 hash = 5381;
+    while (*str)
+    {
+        hash = ((hash << 5) + hash) + (*str++); // hash * 33 + c
+    }
+    return hash;
+}
+
+/**
+ * @brief 按小端写一个32位字
+ */
+static void tune_put_word(FILE *fp, uint32 word)
+{
+    fputc((int)(word & 0xFF), fp);
+    fputc((int)((word >> 8) & 0xFF), fp);
+    fputc((int)((word >> 16) & 0xFF), fp);
+    fputc((int)((word >> 24) & 0xFF), fp);
+}
+
+/**
+ * @brief 输出当前参数（调用前已写入最优组合）
+ * @note  文本包含全部控制参数；Flash镜像与Param_Save_All()写入的数据相同布局：
+ *        魔术字、参数个数、TUNE_PARAM_MAX个{名称哈希, 值}，再加一个补齐字，
+ *        只包含参数表中有菜单键的参数，Param_Load_All()加载时其他菜单参数保持固件默认值
+ */
+static uint8 tune_write_best(const char *text_path, const char *flash_path, const Tune_Score *best)
+{
+    FILE *fp;
+    uint32 i, count = 0;
+
+    fp = fopen(text_path, "w");
+    if (fp == NULL)
+        return 0;
+    fprintf(fp, "# car_tune最优参数：score %.4f，倒车%lu次\n", best->score, (unsigned long)best->falls);
+    for (i = 0; i < sim_param_num; i++)
+    {
+        if (sim_param_table[i].menu != NULL)
+            fprintf(fp, "%s=%.6g\n", sim_param_table[i].name, sim_get_param(&sim_param_table[i]));
+    }
+    fclose(fp);
+
+    fp = fopen(flash_path, "wb");
+    if (fp == NULL)
+        return 0;
+    for (i = 0; i < sim_param_num; i++)
+    {
+        if (sim_param_table[i].menu != NULL)
+            count++;
+    }
+    tune_put_word(fp, TUNE_PARAM_MAGIC);
+    tune_put_word(fp, count);
+    for (i = 0; i < sim_param_num; i++)
+    {
+        const Sim_Param_Entry *entry = &sim_param_table[i];
+        uint32 value;
+
+        if (entry->menu == NULL)
+            continue;
+        if (entry->f != NULL)
+            memcpy(&value, entry->f, sizeof(value)); // 与Collect_All_Params()相同，float按位存储
+        else
+            value = *entry->u;
+        tune_put_word(fp, tune_string_hash(entry->menu));
+        tune_put_word(fp, value);
+    }
+    for (i = count; i < TUNE_PARAM_MAX; i++)
+    {
+        tune_put_word(fp, 0);
+        tune_put_word(fp, 0);
+    }
+    tune_put_word(fp, 0);
+    fclose(fp);
+    return 1;
+}
+
+/**
+ * @brief 以最优组合为中心把搜索范围缩小一半（不超出原范围）
+ */
+static void tune_shrink(const float *best, const float *orig_min, const float *orig_max)
+{
+    uint32 d;
+
+    for (d = 0; d < dim_num; d++)
+    {
+        float half;
+
+        if (dims[d].value_num > 0)
+            continue;
+        half = (dims[d].max - dims[d].min) / 4.0f;
+        dims[d].min = best[d] - half < orig_min[d] ? orig_min[d] : best[d] - half;
+        dims[d].max = best[d] + half > orig_max[d] ? orig_max[d] : best[d] + half;
+    }
+}
+
+//============================================================
+// 主程序
+//============================================================
+
+int main(int argc, char **argv)
+{
+    Sim_Config config;
+    uint8 grid = 1;
+    uint32 samples = 200, rounds = 1, jobs, top = 10, round, c, d, i;
+    const char *out_path = "tune_best.params", *flash_path = "tune_best.bin", *csv_path = NULL;
+    float *values = NULL, best_values[TUNE_MAX_DIMS];
+    float orig_min[TUNE_MAX_DIMS], orig_max[TUNE_MAX_DIMS];
+    Tune_Score *scores = NULL, best_score;
+    uint32 *order = NULL;
+    FILE *csv = NULL;
+    time_t start = time(NULL);
+    long cores = sysconf(_SC_NPROCESSORS_ONLN);
+
+    sim_params = sim_default_params;
+    sim_config_default(&config);
+    jobs = cores > 0 ? (uint32)cores : 1;
+    memset(&best_score, 0, sizeof(best_score));
+    best_score.score = 1e30f;
+
+    // 1. 命令行
+    for (i = 1; i < (uint32)argc; i += 2)
+    {
+        const char *arg = argv[i];
+        const char *val = (i + 1 < (uint32)argc) ? argv[i + 1] : NULL;
+        uint8 ok = 1;
+
+        if (val == NULL)
+        {
+            fprintf(stderr, "missing value for %s\n", arg);
+            return 2;
+        }
+        if (strcmp(arg, "--vary") == 0)
+            ok = tune_parse_dim(val);
+        else if (strcmp(arg, "--space") == 0)
+            ok = tune_load_space(val);
+        else if (strcmp(arg, "--strategy") == 0)
+        {
+            grid = strcmp(val, "grid") == 0;
+            ok = grid || strcmp(val, "random") == 0;
+        }
+        else if (strcmp(arg, "--samples") == 0)
+            samples = (uint32)strtoul(val, NULL, 0);
+        else if (strcmp(arg, "--rounds") == 0)
+            rounds = (uint32)strtoul(val, NULL, 0);
+        else if (strcmp(arg, "--scenarios") == 0)
+            ok = tune_parse_scenarios(val);
+        else if (strcmp(arg, "--seeds") == 0)
+            seed_num = (uint32)strtoul(val, NULL, 0);
+        else if (strcmp(arg, "--jobs") == 0)
+            jobs = (uint32)strtoul(val, NULL, 0);
+        else if (strcmp(arg, "--w-settle") == 0)
+            w_settle = strtof(val, NULL);
+        else if (strcmp(arg, "--w-overshoot") == 0)
+            w_overshoot = strtof(val, NULL);
+        else if (strcmp(arg, "--w-lean") == 0)
+            w_lean = strtof(val, NULL);
+        else if (strcmp(arg, "--w-track") == 0)
+            w_track = strtof(val, NULL);
+        else if (strcmp(arg, "--w-speed") == 0)
+            w_speed = strtof(val, NULL);
+        else if (strcmp(arg, "--top") == 0)
+            top = (uint32)strtoul(val, NULL, 0);
+        else if (strcmp(arg, "--out") == 0)
+            out_path = val;
+        else if (strcmp(arg, "--flash") == 0)
+            flash_path = val;
+        else if (strcmp(arg, "--csv") == 0)
+            csv_path = val;
+        else if (strcmp(arg, "--params") == 0)
+            ok = sim_load_params(val);
+        else if (strcmp(arg, "--set") == 0)
+            ok = sim_set_param(val);
+        else if (strcmp(arg, "--time") == 0)
+            config.run_s = strtof(val, NULL);
+        else if (strcmp(arg, "--hold") == 0)
+            config.hold_s = strtof(val, NULL);
+        else if (strcmp(arg, "--lean") == 0)
+            config.lean_deg = strtof(val, NULL);
+        else if (strcmp(arg, "--kick") == 0)
+            config.kick_dps = strtof(val, NULL);
+        else if (strcmp(arg, "--turn-error") == 0)
+            config.turn_error = strtof(val, NULL);
+        else if (strcmp(arg, "--seed") == 0)
+            config.seed = (uint32)strtoul(val, NULL, 0);
+        else
+        {
+            fprintf(stderr, "unknown option: %s\n", arg);
+            return 2;
+        }
+        if (!ok)
+        {
+            fprintf(stderr, "invalid value for %s: %s\n", arg, val);
+            return 2;
+        }
+    }
+    if (dim_num == 0)
+    {
+        fprintf(stderr, "nothing to search, add --vary or --space\n");
+        return 2;
+    }
+    if (jobs == 0)
+        jobs = 1;
+    if (seed_num == 0)
+        seed_num = 1;
+    if (rounds == 0)
+        rounds = 1;
+    rng_state = config.seed;
+    for (d = 0; d < dim_num; d++)
+    {
+        orig_min[d] = dims[d].min;
+        orig_max[d] = dims[d].max;
+    }
+
+    values = malloc(sizeof(float) * TUNE_MAX_CANDIDATES * dim_num);
+    scores = malloc(sizeof(Tune_Score) * TUNE_MAX_CANDIDATES);
+    order = malloc(sizeof(uint32) * TUNE_MAX_CANDIDATES);
+    if (values == NULL || scores == NULL || order == NULL)
+        return 2;
+    if (csv_path != NULL)
+    {
+        csv = fopen(csv_path, "w");
+        if (csv == NULL)
+        {
+            fprintf(stderr, "cannot open %s\n", csv_path);
+            return 2;
+        }
+        fprintf(csv, "round");
+        for (d = 0; d < dim_num; d++)
+            fprintf(csv, ",%s", dims[d].entry->name);
+        fprintf(csv, ",score,falls,settle_s,overshoot_deg,lean_rms_deg,path_err_m,speed_err\n");
+    }
+
+    // 2. 逐轮搜索
+    for (round = 0; round < rounds; round++)
+    {
+        uint32 count = tune_generate(values, grid, samples);
+
+        if (count == 0)
+        {
+            fprintf(stderr, "grid too large (limit %d candidates)\n", TUNE_MAX_CANDIDATES);
+            return 2;
+        }
+        printf("round %lu: %lu candidates x %lu runs on %lu jobs\n", (unsigned long)(round + 1),
+               (unsigned long)count, (unsigned long)(scenario_num * seed_num), (unsigned long)jobs);
+        fflush(stdout); // fork前清空缓冲区，避免子进程重复输出
+
+        if (!tune_evaluate(&config, values, count, jobs, scores))
+        {
+            fprintf(stderr, "cannot start simulation processes\n");
+            return 2;
+        }
+
+        // 按评分排序
+        for (c = 0; c < count; c++)
+            order[c] = c;
+        sort_scores = scores;
+        qsort(order, count, sizeof(uint32), tune_compare);
+
+        if (scores[order[0]].score < best_score.score)
+        {
+            best_score = scores[order[0]];
+            memcpy(best_values, &values[order[0] * dim_num], sizeof(float) * dim_num);
+        }
+
+        if (csv != NULL)
+        {
+            for (c = 0; c < count; c++)
+            {
+                fprintf(csv, "%lu", (unsigned long)(round + 1));
+                for (d = 0; d < dim_num; d++)
+                    fprintf(csv, ",%.6g", values[c * dim_num + d]);
+                fprintf(csv, ",%.4f,%lu,%.3f,%.3f,%.3f,%.4f,%.2f\n", scores[c].score, (unsigned long)scores[c].falls,
+                        scores[c].settle, scores[c].overshoot, scores[c].lean_rms, scores[c].path_err, scores[c].speed_err);
+            }
+        }
+
+        printf("  %-10s %5s %8s %8s %8s %8s %8s ", "score", "falls", "settle", "overshoot", "lean_rms", "path_err", "speed_err");
+        for (d = 0; d < dim_num; d++)
+            printf(" %s", dims[d].entry->name);
+        printf("\n");
+        for (c = 0; c < count && c < top; c++)
+        {
+            const Tune_Score *s = &scores[order[c]];
+            printf("  %-10.4f %5lu %8.3f %8.3f %8.3f %8.4f %8.2f ", s->score, (unsigned long)s->falls,
+                   s->settle, s->overshoot, s->lean_rms, s->path_err, s->speed_err);
+            for (d = 0; d < dim_num; d++)
+                printf(" %.6g", values[order[c] * dim_num + d]);
+            printf("\n");
+        }
+
+        tune_shrink(best_values, orig_min, orig_max);
+    }
+
+    // 3. 输出最优参数
+    for (d = 0; d < dim_num; d++)
+        sim_put_param(dims[d].entry, best_values[d]);
+    if (!tune_write_best(out_path, flash_path, &best_score))
+    {
+        fprintf(stderr, "cannot write %s / %s\n", out_path, flash_path);
+        return 2;
+    }
+    printf("best score %.4f (%lu falls):", best_score.score, (unsigned long)best_score.falls);
+    for (d = 0; d < dim_num; d++)
+        printf(" --set %s=%.6g", dims[d].entry->name, best_values[d]);
+    printf("\nwritten %s and %s in %.0f s\n", out_path, flash_path, difftime(time(NULL), start));
+
+    if (csv != NULL)
+        fclose(csv);
+    free(values);
+    free(scores);
+    free(order);
+    return best_score.falls > 0 ? 1 : 0;
+}
+
+#endif
@@ -0,0 +1,85 @@
+/*********************************************************************
+ * 文件: zf_common_headfile.h（主机仿真）
+ * 主机仿真用的公共头文件，替代逐飞库的同名文件
+ * 说明：只声明控制代码（pid/motor/imu/转弯补偿等）用到的外设接口，实现在sim_hal.c中，
+ *       引脚与定时器枚举只作为区分通道的编号；用户头文件只包含参与仿真的模块
+ ********************************************************************/
+
+#ifndef _zf_common_headfile_h_
+#define _zf_common_headfile_h_
+
+#include "zf_common_typedef.h"
+
+//============================================================
+// 外设编号（仿真中只用于区分通道）
+//============================================================
+
+typedef enum
+{
+    // PWM通道
+    ATOM0_CH5_P02_5, // 动量轮电机
+    ATOM0_CH7_P02_7, // 行进轮电机
+    ATOM1_CH1_P33_9, // 舵机
+    SIM_PWM_NUM,
+
+    // GPIO
+    P02_4,  // 动量轮方向
+    P02_6,  // 行进轮方向
+    P33_10, // 蜂鸣器
+
+    // 编码器
+    TIM2_ENCODER, // 动量轮编码器
+    TIM5_ENCODER, // 行进轮编码器
+    TIM2_ENCODER_CH1_P33_7,
+    TIM2_ENCODER_CH2_P33_6,
+    TIM5_ENCODER_CH1_P10_3,
+    TIM5_ENCODER_CH2_P10_1,
+} sim_pin_enum;
+
+typedef enum
+{
+    GPI,
+    GPO,
+} gpio_dir_enum;
+
+typedef enum
+{
+    GPO_PUSH_PULL,
+    GPO_OPEN_DTAIN,
+} gpio_mode_enum;
+
+#define GPIO_LOW (0)
+#define GPIO_HIGH (1)
+
+#define PWM_DUTY_MAX 10000 // 与zf_driver_pwm.h一致
+
+//============================================================
+// 外设接口（实现见sim_hal.c）
+//============================================================
+
+void pwm_init(uint32 pin, uint32 freq, uint32 duty);
+void pwm_set_duty(uint32 pin, uint32 duty);
+void gpio_init(uint32 pin, gpio_dir_enum dir, uint8 dat, gpio_mode_enum mode);
+void gpio_set_level(uint32 pin, uint8 dat);
+void gpio_toggle_level(uint32 pin);
+void encoder_dir_init(uint32 encoder_n, uint32 count_pin, uint32 dir_pin);
+int16 encoder_get_count(uint32 encoder_n);
+void encoder_clear_count(uint32 encoder_n);
+void system_delay_ms(uint32 time);
+
+//============================================================
+// 参与仿真的用户模块
+//============================================================
+
+#include "buzzer.h"
+#include "delayed_stop.h"
+#include "imu.h"
+#include "motor.h"
+#include "pid.h"
+#include "pid_q.h"
+#include "profiler.h"
+#include "scheduler.h"
+#include "servo.h"
+#include "turn_compensation.h"
+
+#endif
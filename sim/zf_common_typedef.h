@@ -0,0 +1,44 @@
+/*********************************************************************
+ * 文件: zf_common_typedef.h（主机仿真）
+ * 主机仿真用的类型定义，替代逐飞库中依赖英飞凌平台头文件的同名文件
+ * 说明：只在仿真构建的包含路径中出现（-Isim 且不加 -Ilibraries/zf_common），固件工程不使用
+ ********************************************************************/
+
+#ifndef _zf_common_typedef_h_
+#define _zf_common_typedef_h_
+
+#include <math.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <stdarg.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdbool.h>
+
+typedef uint8_t uint8;
+typedef uint16_t uint16;
+typedef uint32_t uint32;
+typedef uint64_t uint64;
+typedef int8_t int8;
+typedef int16_t int16;
+typedef int32_t int32;
+typedef int64_t int64;
+typedef int32_t sint32;
+typedef float float32;
+
+typedef volatile uint8 vuint8;
+typedef volatile uint16 vuint16;
+typedef volatile uint32 vuint32;
+typedef volatile uint64 vuint64;
+typedef volatile int8 vint8;
+typedef volatile int16 vint16;
+typedef volatile int32 vint32;
+typedef volatile int64 vint64;
+
+#define ZF_ENABLE (1)
+#define ZF_DISABLE (0)
+#define ZF_TRUE (1)
+#define ZF_FALSE (0)
+#define ZF_WEAK __attribute__((weak))
+
+#endif
@@ -0,0 +1,22 @@
+/*********************************************************************
+ * 文件: zf_device_imu660rb.h（主机仿真）
+ * IMU660RB驱动的仿真替代：接口与逐飞驱动一致，数据由仿真对象模型生成（见sim_hal.c）
+ ********************************************************************/
+
+#ifndef _zf_device_imu660rb_h_
+#define _zf_device_imu660rb_h_
+
+#include "zf_common_typedef.h"
+
+extern int16 imu660rb_acc_x, imu660rb_acc_y, imu660rb_acc_z;
+extern int16 imu660rb_gyro_x, imu660rb_gyro_y, imu660rb_gyro_z;
+extern float imu660rb_transition_factor[2]; // 与驱动默认量程一致：±8g为4098，±2000dps为14.3
+
+void imu660rb_get_acc(void);
+void imu660rb_get_gyro(void);
+uint8 imu660rb_init(void);
+
+#define imu660rb_acc_transition(acc_value) ((float)(acc_value) / imu660rb_transition_factor[0])
+#define imu660rb_gyro_transition(gyro_value) ((float)(gyro_value) / imu660rb_transition_factor[1])
+
+#endif
@@ -51,6 +51,8 @@ void all_init(void)
     // 初始化各个模块
     ips114_init();              // 初始化IPS114液晶屏
     mt9v03x_init();             // 初始化MT9V03X摄像头
+    ipm_init();                 // 生成逆透视查找表
+    centerline_init();          // 初始化中线拟合（依赖逆透视查找表）
     imu_init();                 // 初始化IMU陀螺仪
     servo_init();               // 初始化舵机
     motor_init();               // 初始化电机和编码器
@@ -66,37 +68,53 @@ int core0_main(void)
 
     cpu_wait_event_ready(); // 等待所有核心初始化完毕
 
+    uint32 menu_refresh_time = system_getval(); // 上一次菜单刷新时刻（10ns）
+
+    // 主循环：不再固定延时，持续轮询视觉邮箱（忙等，没有等待或休眠），新视觉结果到达后立即做转向控制，
+    // 菜单在按键事件或刷新周期到期时更新
     while (1)
     {
         if (enable)
         {
-            if (mt9v03x_finish_flag)
+#if !VISION_ON_CPU1
+            // 图像处理在CPU0主循环中执行（避免占用中断时间）
+            vision_task();
+#endif
+            // Cargo 模式运行中，停止菜单刷新
+            // 从视觉邮箱读取最新结果，每个新结果只做一次转向控制
+            Vision_Result vision_result;
+            if (vision_result_poll(&vision_result))
             {
-                // Cargo 模式运行中，停止菜单刷新
-                // 图像处理（在主循环中执行，避免占用中断时间）
-                image_process();
-
                 // 转向PID控制（基于图像偏差和陀螺仪gz）
-                steer_pid_control();
+                uint32 prof_start = prof_begin();
+                steer_pid_control(vision_result.steer_error);
+                prof_end(PROF_STEER, prof_start);
+
+                // 延迟统计：舵机输出时刻相对处理完成和场同步的时间
+                uint32 servo_stamp = latency_now();
+                latency_record(LATENCY_HANDOFF, vision_result.timestamp, servo_stamp);
+                latency_record(LATENCY_END_TO_END, vision_result.vsync_stamp, servo_stamp);
 
                 // 例如：实时显示调试信息
                 // printf("%f,%d,%f\r\n", imu_data.pitch, imu_data.gyro_y, filtered_motor_output);
                 // printf("%f,%d\r\n", drive_pwm_output, encoder[1]);
                 // 检测退出（BACK键由20ms中断处理，这里只需要检查enable状态）
-
-                // 清除图像采集完成标志，允许处理下一帧
-                mt9v03x_finish_flag = 0;
             }
         }
         else
         {
-            // 正常菜单模式
-            menu_update();
-            // printf("%f,%d\r\n", imu_data.pitch, imu_data.gyro_y);
-        }
+            // 调试串口命令（停车时处理，输出统计表不会阻塞转向控制）
+            prof_poll_command();
 
-        // 减少CPU占用
-        system_delay_ms(20);
+            if (menu_key_event || (uint32)(system_getval() - menu_refresh_time) >= MENU_REFRESH_PERIOD_MS * STM_TICKS_PER_US * 1000)
+            {
+                // 正常菜单模式
+                menu_key_event = 0;
+                menu_refresh_time = system_getval();
+                menu_update();
+                // printf("%f,%d\r\n", imu_data.pitch, imu_data.gyro_y);
+            }
+        }
     }
 }
 
@@ -63,7 +63,9 @@ void core1_main(void)
     while (TRUE)
     {
         // ˴дҪѭִеĴ
-
+#if VISION_ON_CPU1
+        vision_task();                      // Ӿˮߣ֡ʱд
+#endif
 
 
 